@@ -32,6 +32,10 @@ extern "C"
 /**
  * @file sound_manager.h
  * @brief This file contains the Sound Manager API
+ * @remarks Every function is exported by every build of the library. A library built with the no-session
+ * profile returns #SOUND_MANAGER_ERROR_INVALID_OPERATION from the session, call session, ducking, transaction
+ * and focus functions, and one built with the volume-only profile also from the route and device functions,
+ * where sound_manager_is_route_available() returns false.
  */
 
 /**
@@ -75,6 +79,9 @@ typedef enum{
     SOUND_MANAGER_ERROR_INVALID_PARAMETER = TIZEN_ERROR_INVALID_PARAMETER,       /**< Invalid parameter */
     SOUND_MANAGER_ERROR_INVALID_OPERATION = TIZEN_ERROR_INVALID_OPERATION,       /**< Invalid operation */
     SOUND_MANAGER_ERROR_NO_PLAYING_SOUND  = SOUND_MANAGER_ERROR_CLASS | 01,    /**< No playing sound */
+    SOUND_MANAGER_ERROR_POLICY            = SOUND_MANAGER_ERROR_CLASS | 02,    /**< Blocked by sound focus policy */
+    SOUND_MANAGER_ERROR_STALE_VALUE       = SOUND_MANAGER_ERROR_CLASS | 03,    /**< The sound server missed the deadline, the last known value is returned */
+    SOUND_MANAGER_ERROR_TIMED_OUT         = TIZEN_ERROR_TIMED_OUT,             /**< The sound server missed the deadline and no value is known yet */
 } sound_manager_error_e;
 
 /**
@@ -226,6 +233,8 @@ int sound_manager_set_volume(sound_type_e type, int volume);
  * @return 0 on success, otherwise a negative error value.
  * @retval #SOUND_MANAGER_ERROR_NONE Success
  * @retval #SOUND_MANAGER_ERROR_INVALID_PARAMETER Invalid parameter
+ * @retval #SOUND_MANAGER_ERROR_STALE_VALUE The last known value, the sound server missed the deadline
+ * @retval #SOUND_MANAGER_ERROR_TIMED_OUT The sound server missed the deadline
  * @see sound_manager_get_max_volume()
  * @see sound_manager_set_volume()
  */
@@ -238,12 +247,67 @@ int sound_manager_get_volume(sound_type_e type, int *volume);
  * @retval #SOUND_MANAGER_ERROR_NONE Success
  * @retval #SOUND_MANAGER_ERROR_INVALID_PARAMETER Invalid parameter
  * @retval #SOUND_MANAGER_ERROR_NO_PLAYING_SOUND No playing sound
+ * @retval #SOUND_MANAGER_ERROR_STALE_VALUE The last known value, the sound server missed the deadline
+ * @retval #SOUND_MANAGER_ERROR_TIMED_OUT The sound server missed the deadline
  * @see player_set_sound_type()
  * @see audio_out_create()
  * @see wav_player_start()
  */
 int sound_manager_get_current_sound_type(sound_type_e *type);
 
+/**
+ * @brief Called when the current playing sound type is changed.
+ * @param[in]   type	The current sound type, valid only if @a playing is @c true
+ * @param[in]   playing	@c true if a sound is playing, @c false if no sound is playing
+ * @param[in]   user_data	The user data passed from the callback registration function
+ * @see sound_manager_set_current_sound_type_changed_cb()
+ */
+typedef void (*sound_current_sound_type_changed_cb)(sound_type_e type, bool playing, void *user_data);
+
+/**
+ * @brief Registers a callback function to be invoked when the current playing sound type is changed.
+ * @details While the callback or the event fd is registered, the playing type is sampled once per process inside the library
+ * and sound_manager_get_current_sound_type() returns the last sample without querying the sound server.
+ * Sampling starts every 100 ms and slows down to once a second while the type stays the same, so a change which follows
+ * a long quiet period may be reported up to a second late.
+ * @remarks The callback is invoked from an internal thread.
+ * It is also invoked once with the current state when the library starts sampling.
+ * @param[in]	callback	The callback function
+ * @param[in]	user_data	The user data to be passed to the callback function
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #SOUND_MANAGER_ERROR_NONE Success
+ * @retval #SOUND_MANAGER_ERROR_INVALID_PARAMETER Invalid parameter
+ * @retval #SOUND_MANAGER_ERROR_INVALID_OPERATION Invalid operation
+ * @see sound_manager_unset_current_sound_type_changed_cb()
+ * @see sound_manager_get_current_sound_type_event_fd()
+ */
+int sound_manager_set_current_sound_type_changed_cb(sound_current_sound_type_changed_cb callback, void *user_data);
+
+/**
+ * @brief Unregisters the current sound type changed callback.
+ * @see sound_manager_set_current_sound_type_changed_cb()
+ */
+void sound_manager_unset_current_sound_type_changed_cb(void);
+
+/**
+ * @brief Gets a file descriptor which becomes readable when the current playing sound type is changed.
+ * @details The descriptor is an eventfd, read 8 bytes from it to clear the event and call sound_manager_get_current_sound_type() for the new type.
+ * @remarks Do not close @a fd, release it with sound_manager_release_current_sound_type_event_fd().
+ * @param[out]	fd	The pollable file descriptor
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #SOUND_MANAGER_ERROR_NONE Success
+ * @retval #SOUND_MANAGER_ERROR_INVALID_PARAMETER Invalid parameter
+ * @retval #SOUND_MANAGER_ERROR_INVALID_OPERATION Invalid operation
+ * @see sound_manager_release_current_sound_type_event_fd()
+ */
+int sound_manager_get_current_sound_type_event_fd(int *fd);
+
+/**
+ * @brief Closes the current sound type event file descriptor.
+ * @see sound_manager_get_current_sound_type_event_fd()
+ */
+void sound_manager_release_current_sound_type_event_fd(void);
+
 /**
  * @brief Registers a callback function to be invoked when the volume level is changed.
  * @param[in]	callback	Callback function to indicate change in volume
@@ -334,6 +398,45 @@ void sound_manager_unset_interrupted_cb(void);
  */
 int sound_manager_set_volume_key_type(volume_key_type_e type);
 
+/**
+ * @brief Gets the volume key type
+ * @details The type is kept by the library, so no request is sent to the sound server.
+ * @param[out] type The volume key type, #VOLUME_KEY_TYPE_NONE if none was set
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #SOUND_MANAGER_ERROR_NONE Success
+ * @retval #SOUND_MANAGER_ERROR_INVALID_PARAMETER Invalid parameter
+ * @see sound_manager_set_volume_key_type()
+ */
+int sound_manager_get_volume_key_type(volume_key_type_e *type);
+
+/**
+ * @brief Called when the volume key type is changed.
+ * @param[in]   type	The new volume key type
+ * @param[in]   user_data	The user data passed from the callback registration function
+ * @see sound_manager_set_volume_key_type_changed_cb()
+ */
+typedef void (*sound_volume_key_type_changed_cb)(volume_key_type_e type, void *user_data);
+
+/**
+ * @brief Registers a callback function to be invoked when the volume key type is changed.
+ * @remarks The callback is invoked in a thread which called sound_manager_set_volume_key_type(). Setting the type it already has does not invoke the callback.
+ * When several threads change the type at once, one of them invokes the callback for the changes in order and the last type is always delivered,
+ * intermediate types may be skipped. sound_manager_snapshot_restore() does not invoke the callback.
+ * @param[in]	callback	The callback function
+ * @param[in]	user_data	The user data to be passed to the callback function
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #SOUND_MANAGER_ERROR_NONE Success
+ * @retval #SOUND_MANAGER_ERROR_INVALID_PARAMETER Invalid parameter
+ * @see sound_manager_unset_volume_key_type_changed_cb()
+ */
+int sound_manager_set_volume_key_type_changed_cb(sound_volume_key_type_changed_cb callback, void *user_data);
+
+/**
+ * @brief Unregisters the volume key type changed callback.
+ * @see sound_manager_set_volume_key_type_changed_cb()
+ */
+void sound_manager_unset_volume_key_type_changed_cb(void);
+
 /**
  * @brief Gets called iteratively to notify you of available route.
  * @param[in]   route The available route
@@ -370,11 +473,27 @@ typedef void(* sound_active_device_changed_cb)(sound_device_in_e in, sound_devic
  * @return 0 on success, otherwise a negative error value.
  * @retval #SOUND_MANAGER_ERROR_NONE Success
  * @retval #SOUND_MANAGER_ERROR_INVALID_PARAMETER Invalid parameter
+ * @remarks While sound_manager_set_available_route_changed_cb() is registered the callback walks the routes kept by the library.
  * @post  sound_available_route_cb() will be invoked
  * @see sound_available_route_cb()
+ * @see sound_manager_get_available_routes()
  */
 int sound_manager_foreach_available_route (sound_available_route_cb callback, void *user_data);
 
+/**
+ * @brief Gets the available audio routes.
+ * @details While sound_manager_set_available_route_changed_cb() is registered the routes are kept by the library,
+ * so no request is sent to the sound server.
+ * @param[out]	routes	The array to fill, may be NULL if @a capacity is 0
+ * @param[in]	capacity	The number of elements in @a routes
+ * @param[out]	count	The number of available routes, only the first @a capacity of them are written if it is larger
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #SOUND_MANAGER_ERROR_NONE Success
+ * @retval #SOUND_MANAGER_ERROR_INVALID_PARAMETER Invalid parameter
+ * @see sound_manager_foreach_available_route()
+ */
+int sound_manager_get_available_routes(sound_route_e *routes, int capacity, int *count);
+
 /**
  * @brief Changes the audio routes.
  * @param[in] route The route to set
@@ -392,6 +511,8 @@ int sound_manager_set_active_route (sound_route_e route);
  * @return 0 on success, otherwise a negative error value.
  * @retval #SOUND_MANAGER_ERROR_NONE Success
  * @retval #SOUND_MANAGER_ERROR_INVALID_PARAMETER Invalid parameter
+ * @retval #SOUND_MANAGER_ERROR_STALE_VALUE The last known value, the sound server missed the deadline
+ * @retval #SOUND_MANAGER_ERROR_TIMED_OUT The sound server missed the deadline
  * @see sound_manager_set_active_route()
  */
 int sound_manager_get_active_device (sound_device_in_e *in, sound_device_out_e *out);
@@ -402,6 +523,9 @@ int sound_manager_get_active_device (sound_device_in_e *in, sound_device_out_e *
  * @return 0 on success, otherwise a negative error value.
  * @return @c true if the specified route is supported, \n else @c false
  * @retval #SOUND_MANAGER_ERROR_INVALID_PARAMETER Invalid parameter
+ * @remarks While sound_manager_set_available_route_changed_cb() is registered the routes kept by the library are checked.
+ * A value which is not a #sound_route_e is reported as not available without asking the sound server.
+ * The answer comes from the sound server, not from the library route policy.
  */
 bool sound_manager_is_route_available (sound_route_e route);
 
@@ -446,16 +570,19 @@ void sound_manager_unset_active_device_changed_cb (void);
 /**
  * @brief Creates a call session handle.
  * @remarks @a session must be released sound_manager_call_session_destroy() by you.
+ * Handles come from a fixed pool of 16 without allocating memory; once destroyed, a handle is rejected
+ * with #SOUND_MANAGER_ERROR_INVALID_PARAMETER by every call session function.
  * @param[out]  session  A new handle to call session
  * @retval #SOUND_MANAGER_ERROR_NONE Successful
  * @retval #SOUND_MANAGER_ERROR_INVALID_PARAMETER Invalid parameter
- * @retval #SOUND_MANAGER_OUT_OF_MEMORY Out of memory
+ * @retval #SOUND_MANAGER_ERROR_INVALID_OPERATION All call session handles are in use
  * @see sound_manager_call_session_destroy()
  */
 int sound_manager_call_session_create(sound_call_session_type_e type, sound_call_session_h *session);
 
 /**
  * @brief Sets the call session mode.
+ * @remarks Setting the mode that is already active returns immediately.
  *
  * @param[in]   session The handle to call session
  * @param[in]   mode  The call session mode
@@ -468,6 +595,7 @@ int sound_manager_call_session_set_mode(sound_call_session_h session, sound_call
 
 /**
  * @brief Gets the call session mode.
+ * @remarks The mode set through this handle is kept in the handle, so only the first call may query the sound server.
  *
  * @param[in]   session The handle to call session
  * @param[out]   mode  The call session mode
@@ -478,17 +606,1012 @@ int sound_manager_call_session_set_mode(sound_call_session_h session, sound_call
  */
 int  sound_manager_call_session_get_mode(sound_call_session_h session, sound_call_session_mode_e *mode);
 
+/**
+ * @brief Gets the call session type.
+ *
+ * @param[in]   session The handle to call session
+ * @param[out]   type  The call session type given to sound_manager_call_session_create()
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #SOUND_MANAGER_ERROR_NONE Successful
+ * @retval #SOUND_MANAGER_ERROR_INVALID_PARAMETER Invalid parameter
+ * @see sound_manager_call_session_create()
+ */
+int sound_manager_call_session_get_type(sound_call_session_h session, sound_call_session_type_e *type);
+
 /**
  * @brief Destroys the call session handle.
  *
  * @param[in]		session The handle to call session to be destroyed
  * @return 0 on success, otherwise a negative error value.
  * @retval #SOUND_MANAGER_ERROR_NONE Successful
- * @retval #SOUND_MANAGER_ERROR_INVALID_PARAMETER Invalid parameter
+ * @retval #SOUND_MANAGER_ERROR_INVALID_PARAMETER Invalid parameter, or @a session was already destroyed
  * @see sound_manager_call_session_create()
  */
 int sound_manager_call_session_destroy(sound_call_session_h session);
 
+/**
+ * @brief Stream volume handle type.
+ */
+typedef struct sound_stream_volume_s *sound_stream_volume_h;
+
+/**
+ * @brief Called when the effective gain of a stream is changed.
+ * @param[in]   stream	The handle to stream volume
+ * @param[in]   gain	The new effective gain, the sound type level multiplied by the stream gain (0.0 ~ 1.0)
+ * @param[in]   user_data	The user data passed from the callback registration function
+ * @see sound_manager_stream_volume_set_changed_cb()
+ */
+typedef void (*sound_stream_volume_changed_cb)(sound_stream_volume_h stream, double gain, void *user_data);
+
+/**
+ * @brief Creates a stream volume handle under a sound type.
+ * @details Each stream has its own gain. The effective gain is the level of @a type multiplied by the stream gain,
+ * so several players of one sound type can have independent levels without touching the system volume.
+ * @remarks @a stream must be released with sound_manager_stream_volume_destroy() by you.
+ * @param[in]   type	The sound type the stream belongs to
+ * @param[out]  stream	A new handle to stream volume, its gain is 1.0
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #SOUND_MANAGER_ERROR_NONE Successful
+ * @retval #SOUND_MANAGER_ERROR_INVALID_PARAMETER Invalid parameter
+ * @retval #SOUND_MANAGER_ERROR_OUT_OF_MEMORY Out of memory
+ * @see sound_manager_stream_volume_destroy()
+ */
+int sound_manager_stream_volume_create(sound_type_e type, sound_stream_volume_h *stream);
+
+/**
+ * @brief Sets the gain of a stream.
+ * @remarks This is computed in the process, the system volume is not changed and other streams are not notified.
+ * @param[in]   stream	The handle to stream volume
+ * @param[in]   gain	The stream gain (0.0 ~ 1.0)
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #SOUND_MANAGER_ERROR_NONE Successful
+ * @retval #SOUND_MANAGER_ERROR_INVALID_PARAMETER Invalid parameter
+ * @post sound_stream_volume_changed_cb() of this stream will be invoked if the effective gain is changed
+ */
+int sound_manager_stream_volume_set_gain(sound_stream_volume_h stream, double gain);
+
+/**
+ * @brief Gets the gain of a stream.
+ * @param[in]   stream	The handle to stream volume
+ * @param[out]  gain	The stream gain (0.0 ~ 1.0)
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #SOUND_MANAGER_ERROR_NONE Successful
+ * @retval #SOUND_MANAGER_ERROR_INVALID_PARAMETER Invalid parameter
+ */
+int sound_manager_stream_volume_get_gain(sound_stream_volume_h stream, double *gain);
+
+/**
+ * @brief Gets the effective gain of a stream, the sound type level multiplied by the stream gain.
+ * @param[in]   stream	The handle to stream volume
+ * @param[out]  gain	The effective gain (0.0 ~ 1.0)
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #SOUND_MANAGER_ERROR_NONE Successful
+ * @retval #SOUND_MANAGER_ERROR_INVALID_PARAMETER Invalid parameter
+ */
+int sound_manager_stream_volume_get_effective_gain(sound_stream_volume_h stream, double *gain);
+
+/**
+ * @brief Registers a callback function to be invoked when the effective gain of the stream is changed.
+ * @param[in]   stream	The handle to stream volume
+ * @param[in]   callback	The callback function
+ * @param[in]   user_data	The user data to be passed to the callback function
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #SOUND_MANAGER_ERROR_NONE Successful
+ * @retval #SOUND_MANAGER_ERROR_INVALID_PARAMETER Invalid parameter
+ * @see sound_manager_stream_volume_unset_changed_cb()
+ */
+int sound_manager_stream_volume_set_changed_cb(sound_stream_volume_h stream, sound_stream_volume_changed_cb callback, void *user_data);
+
+/**
+ * @brief Unregisters the stream gain changed callback.
+ * @param[in]   stream	The handle to stream volume
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #SOUND_MANAGER_ERROR_NONE Successful
+ * @retval #SOUND_MANAGER_ERROR_INVALID_PARAMETER Invalid parameter
+ * @see sound_manager_stream_volume_set_changed_cb()
+ */
+int sound_manager_stream_volume_unset_changed_cb(sound_stream_volume_h stream);
+
+/**
+ * @brief Destroys the stream volume handle.
+ * @param[in]   stream	The handle to stream volume to be destroyed
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #SOUND_MANAGER_ERROR_NONE Successful
+ * @retval #SOUND_MANAGER_ERROR_INVALID_PARAMETER Invalid parameter
+ * @see sound_manager_stream_volume_create()
+ */
+int sound_manager_stream_volume_destroy(sound_stream_volume_h stream);
+
+/**
+ * @brief Enables automatic ducking of media streams on session interrupts.
+ * @details When another application or an alarm interrupts the session, the gain of every #SOUND_TYPE_MEDIA stream volume handle
+ * is lowered to @a ducked_gain over @a attack_ms, and brought back over @a release_ms when the interrupt ends.
+ * Only the local stream gain is changed, the system volume is not written.
+ * @remarks While enabled, those interrupts are not delivered to sound_interrupted_cb(), playback is expected to continue at the ducked level.
+ * Interrupts by calls, earjack unplug and resource conflicts are delivered as before.
+ * @param[in]   ducked_gain	The gain applied while ducked (0.0 ~ 1.0)
+ * @param[in]   attack_ms	The ramp time to the ducked gain in milliseconds
+ * @param[in]   release_ms	The ramp time back to the full gain in milliseconds
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #SOUND_MANAGER_ERROR_NONE Successful
+ * @retval #SOUND_MANAGER_ERROR_INVALID_PARAMETER Invalid parameter
+ * @see sound_manager_disable_auto_ducking()
+ * @see sound_manager_stream_volume_create()
+ */
+int sound_manager_enable_auto_ducking(double ducked_gain, unsigned int attack_ms, unsigned int release_ms);
+
+/**
+ * @brief Disables automatic ducking and restores the full gain right away.
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #SOUND_MANAGER_ERROR_NONE Successful
+ * @see sound_manager_enable_auto_ducking()
+ */
+int sound_manager_disable_auto_ducking(void);
+
+/**
+ * @brief Gets the current ducking gain applied to media streams.
+ * @param[out]  gain	The current ducking gain, 1.0 when not ducked
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #SOUND_MANAGER_ERROR_NONE Successful
+ * @retval #SOUND_MANAGER_ERROR_INVALID_PARAMETER Invalid parameter
+ */
+int sound_manager_get_auto_ducking_gain(double *gain);
+
+/**
+ * @brief Audio transaction handle type.
+ */
+typedef struct sound_transaction_s *sound_transaction_h;
+
+/**
+ * @brief Creates an audio transaction handle.
+ * @details A transaction stages a call session, an active route and volume levels, and applies them together in sound_manager_transaction_commit().
+ * @remarks @a transaction must be released with sound_manager_transaction_destroy() by you.
+ * @param[out]  transaction  A new handle to audio transaction
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #SOUND_MANAGER_ERROR_NONE Successful
+ * @retval #SOUND_MANAGER_ERROR_INVALID_PARAMETER Invalid parameter
+ * @retval #SOUND_MANAGER_ERROR_OUT_OF_MEMORY Out of memory
+ * @see sound_manager_transaction_destroy()
+ */
+int sound_manager_transaction_create(sound_transaction_h *transaction);
+
+/**
+ * @brief Stages the creation of a call session in the given mode.
+ * @param[in]   transaction The handle to audio transaction
+ * @param[in]   type  The call session type
+ * @param[in]   mode  The call session mode
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #SOUND_MANAGER_ERROR_NONE Successful
+ * @retval #SOUND_MANAGER_ERROR_INVALID_PARAMETER Invalid parameter
+ * @see sound_manager_call_session_create()
+ * @see sound_manager_call_session_set_mode()
+ */
+int sound_manager_transaction_set_call_session(sound_transaction_h transaction, sound_call_session_type_e type, sound_call_session_mode_e mode);
+
+/**
+ * @brief Stages an active route change.
+ * @param[in]   transaction The handle to audio transaction
+ * @param[in]   route  The route to set
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #SOUND_MANAGER_ERROR_NONE Successful
+ * @retval #SOUND_MANAGER_ERROR_INVALID_PARAMETER Invalid parameter, @a route is not a #sound_route_e value
+ * @see sound_manager_set_active_route()
+ */
+int sound_manager_transaction_set_active_route(sound_transaction_h transaction, sound_route_e route);
+
+/**
+ * @brief Stages a volume level for a sound type.
+ * @remarks Staging the same type twice keeps the last level only.
+ * @param[in]   transaction The handle to audio transaction
+ * @param[in]   type  The sound type
+ * @param[in]   volume  The volume level to be set
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #SOUND_MANAGER_ERROR_NONE Successful
+ * @retval #SOUND_MANAGER_ERROR_INVALID_PARAMETER Invalid parameter
+ * @see sound_manager_set_volume()
+ */
+int sound_manager_transaction_set_volume(sound_transaction_h transaction, sound_type_e type, int volume);
+
+/**
+ * @brief Applies every staged change.
+ * @details Volumes are applied first so the new path opens at the right level, then the call session is created,
+ * the route is set before the call mode so the mode switch opens the path on the requested device directly.
+ * Volumes are sent at once even while sound_manager_set_volume_coalescing() is enabled, replacing a level it holds back.
+ * @remarks If a step fails, the call session created by this commit is destroyed. Volume and route steps already applied are not reverted.
+ * The transaction can be committed only once.
+ * @param[in]   transaction The handle to audio transaction
+ * @param[out]  session  A new handle to call session if one was staged, otherwise it can be NULL. It must be released with sound_manager_call_session_destroy() by you.
+ * It is set to NULL when no call session was staged or the commit failed.
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #SOUND_MANAGER_ERROR_NONE Successful
+ * @retval #SOUND_MANAGER_ERROR_INVALID_PARAMETER Invalid parameter
+ * @retval #SOUND_MANAGER_ERROR_INVALID_OPERATION Invalid operation
+ */
+int sound_manager_transaction_commit(sound_transaction_h transaction, sound_call_session_h *session);
+
+/**
+ * @brief Destroys the audio transaction handle.
+ * @param[in]   transaction The handle to audio transaction to be destroyed
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #SOUND_MANAGER_ERROR_NONE Successful
+ * @retval #SOUND_MANAGER_ERROR_INVALID_PARAMETER Invalid parameter
+ * @see sound_manager_transaction_create()
+ */
+int sound_manager_transaction_destroy(sound_transaction_h transaction);
+
+/**
+ * @brief Enumerations of sound focus priority class
+ * @details A request can take permanent focus only from a holder of the same or a lower class.
+ */
+typedef enum{
+	SOUND_FOCUS_PRIORITY_NOTIFICATION = 0,	/**< Notification and feedback sounds */
+	SOUND_FOCUS_PRIORITY_MEDIA,				/**< Music and video playback */
+	SOUND_FOCUS_PRIORITY_VOICE,				/**< Text-to-speech, navigation guidance and voice recognition */
+	SOUND_FOCUS_PRIORITY_CALL,				/**< Call and alarm */
+} sound_focus_priority_e;
+
+/**
+ * @brief Enumerations of sound focus request type
+ */
+typedef enum{
+	SOUND_FOCUS_REQUEST_GAIN = 0,			/**< Permanent focus, the previous holder loses focus */
+	SOUND_FOCUS_REQUEST_GAIN_TRANSIENT,		/**< Short focus, the previous holder pauses and gets focus back */
+	SOUND_FOCUS_REQUEST_GAIN_TRANSIENT_MAY_DUCK,	/**< Short focus, the previous holder may keep playing at a lower level */
+	SOUND_FOCUS_REQUEST_GAIN_EXCLUSIVE,		/**< Permanent focus, lower classes can not interrupt and the session becomes exclusive */
+} sound_focus_request_e;
+
+/**
+ * @brief Enumerations of sound focus state
+ */
+typedef enum{
+	SOUND_FOCUS_STATE_NONE = 0,			/**< Focus is not requested */
+	SOUND_FOCUS_STATE_GAINED,			/**< Focus is held */
+	SOUND_FOCUS_STATE_LOST,				/**< Focus is lost permanently, request it again to play */
+	SOUND_FOCUS_STATE_LOST_TRANSIENT,	/**< Focus is lost for a while, it will be gained again */
+	SOUND_FOCUS_STATE_DUCKED,			/**< Focus is shared, playback should continue at a lower level */
+} sound_focus_state_e;
+
+/**
+ * @brief Sound focus handle type.
+ */
+typedef struct sound_focus_s *sound_focus_h;
+
+/**
+ * @brief Called when the focus state is changed by another focus request, abandon or session interrupt.
+ * @param[in]   focus	The handle to sound focus
+ * @param[in]   state	The new focus state
+ * @param[in]   user_data	The user data passed from sound_manager_focus_create()
+ * @see sound_manager_focus_create()
+ */
+typedef void (*sound_focus_state_changed_cb)(sound_focus_h focus, sound_focus_state_e state, void *user_data);
+
+/**
+ * @brief Creates a sound focus handle.
+ * @remarks @a focus must be released with sound_manager_focus_destroy() by you.
+ * @param[in]   priority	The priority class of the focus
+ * @param[in]   callback	The focus state changed callback function
+ * @param[in]   user_data	The user data to be passed to the callback function
+ * @param[out]  focus	A new handle to sound focus
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #SOUND_MANAGER_ERROR_NONE Successful
+ * @retval #SOUND_MANAGER_ERROR_INVALID_PARAMETER Invalid parameter
+ * @retval #SOUND_MANAGER_ERROR_OUT_OF_MEMORY Out of memory
+ * @see sound_manager_focus_destroy()
+ */
+int sound_manager_focus_create(sound_focus_priority_e priority, sound_focus_state_changed_cb callback, void *user_data, sound_focus_h *focus);
+
+/**
+ * @brief Requests the sound focus.
+ * @details The decision is made inside the process against every current holder. A permanent request
+ * is granted only when no holder has a higher class, and then takes the focus from all of them. A transient
+ * request of a lower class is granted unless a holder asked for #SOUND_FOCUS_REQUEST_GAIN_EXCLUSIVE.
+ * The process session is changed only when the focus stack needs a different session type, and goes back to
+ * the type set with sound_manager_set_session_type() when the exclusive holder is gone.
+ * @param[in]   focus	The handle to sound focus
+ * @param[in]   request	The focus request type
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #SOUND_MANAGER_ERROR_NONE Successful, the focus is gained
+ * @retval #SOUND_MANAGER_ERROR_INVALID_PARAMETER Invalid parameter
+ * @retval #SOUND_MANAGER_ERROR_POLICY A current holder has priority over this request
+ * @post The sound_focus_state_changed_cb() of every holder that lost the focus will be invoked. While another
+ * thread is invoking focus callbacks, that thread invokes them too, and a holder which changed twice in the
+ * meantime is told once, with its latest state.
+ * @see sound_manager_focus_abandon()
+ */
+int sound_manager_focus_request(sound_focus_h focus, sound_focus_request_e request);
+
+/**
+ * @brief Abandons the sound focus.
+ * @param[in]   focus	The handle to sound focus
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #SOUND_MANAGER_ERROR_NONE Successful
+ * @retval #SOUND_MANAGER_ERROR_INVALID_PARAMETER Invalid parameter
+ * @post The next holder's sound_focus_state_changed_cb() will be invoked with #SOUND_FOCUS_STATE_GAINED
+ * @see sound_manager_focus_request()
+ */
+int sound_manager_focus_abandon(sound_focus_h focus);
+
+/**
+ * @brief Gets the sound focus state.
+ * @param[in]   focus	The handle to sound focus
+ * @param[out]  state	The focus state
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #SOUND_MANAGER_ERROR_NONE Successful
+ * @retval #SOUND_MANAGER_ERROR_INVALID_PARAMETER Invalid parameter
+ */
+int sound_manager_focus_get_state(sound_focus_h focus, sound_focus_state_e *state);
+
+/**
+ * @brief Destroys the sound focus handle, abandoning the focus if it is held.
+ * @param[in]   focus	The handle to sound focus to be destroyed
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #SOUND_MANAGER_ERROR_NONE Successful
+ * @retval #SOUND_MANAGER_ERROR_INVALID_PARAMETER Invalid parameter
+ * @see sound_manager_focus_create()
+ */
+int sound_manager_focus_destroy(sound_focus_h focus);
+
+/**
+ * @brief Latency of the sound server requests made by the getters.
+ * @details Percentiles are bucketed with about 25% resolution.
+ * @see sound_manager_get_backend_latency()
+ */
+typedef struct
+{
+	unsigned int count;		/**< Number of completed requests */
+	unsigned int deadline_missed;	/**< Number of calls which missed the deadline */
+	unsigned int p50_us;		/**< Median latency in microseconds */
+	unsigned int p99_us;		/**< 99th percentile latency in microseconds */
+	unsigned int p999_us;		/**< 99.9th percentile latency in microseconds */
+	unsigned int max_us;		/**< Maximum latency in microseconds */
+} sound_backend_latency_s;
+
+/**
+ * @brief Sets how long the getters wait for the sound server.
+ * @details With a deadline, sound_manager_get_volume(), sound_manager_get_current_sound_type() and sound_manager_get_active_device()
+ * return within @a deadline_ms. When the sound server is late they return the last known value with #SOUND_MANAGER_ERROR_STALE_VALUE
+ * and the request completes in the background to refresh it.
+ * @param[in]	deadline_ms	The deadline in milliseconds, 0 to wait as long as the sound server takes (default)
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #SOUND_MANAGER_ERROR_NONE Success
+ * @see sound_manager_get_backend_deadline()
+ */
+int sound_manager_set_backend_deadline(unsigned int deadline_ms);
+
+/**
+ * @brief Gets the deadline of the getters.
+ * @param[out]	deadline_ms	The deadline in milliseconds, 0 if the getters wait for the sound server
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #SOUND_MANAGER_ERROR_NONE Success
+ * @retval #SOUND_MANAGER_ERROR_INVALID_PARAMETER Invalid parameter
+ * @see sound_manager_set_backend_deadline()
+ */
+int sound_manager_get_backend_deadline(unsigned int *deadline_ms);
+
+/**
+ * @brief Gets the latency statistics of the sound server requests made by the getters.
+ * @param[out]	latency	The latency statistics since the process started or the last reset
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #SOUND_MANAGER_ERROR_NONE Success
+ * @retval #SOUND_MANAGER_ERROR_INVALID_PARAMETER Invalid parameter
+ * @see sound_manager_reset_backend_latency()
+ */
+int sound_manager_get_backend_latency(sound_backend_latency_s *latency);
+
+/**
+ * @brief Clears the latency statistics.
+ * @see sound_manager_get_backend_latency()
+ */
+void sound_manager_reset_backend_latency(void);
+
+/**
+ * @brief Active device change with the previous devices.
+ * @see sound_active_device_diff_cb()
+ */
+typedef struct
+{
+	unsigned int sequence;		/**< Incremented by one for each delivered change, starting at 1 */
+	sound_device_in_e previous_in;	/**< The input device before the change, equal to @a in if it was not known */
+	sound_device_out_e previous_out;	/**< The output device before the change, equal to @a out if it was not known */
+	sound_device_in_e in;		/**< The current input device */
+	sound_device_out_e out;		/**< The current output device */
+} sound_active_device_change_s;
+
+/**
+ * @brief Available route change with the previous availability.
+ * @see sound_available_route_diff_cb()
+ */
+typedef struct
+{
+	unsigned int sequence;		/**< Incremented by one for each delivered change, starting at 1 */
+	sound_route_e route;		/**< The audio route */
+	bool previous_available;	/**< The status before the change, the opposite of @a available if it was not known */
+	bool available;			/**< The current status */
+} sound_available_route_change_s;
+
+/**
+ * @brief Called when the active device has actually changed.
+ * @param[in]   change	The change, valid only during the callback
+ * @param[in]   user_data	The user data passed from the callback registration function
+ * @see sound_manager_set_active_device_diff_cb()
+ */
+typedef void (*sound_active_device_diff_cb)(const sound_active_device_change_s *change, void *user_data);
+
+/**
+ * @brief Called when the availability of a route has actually changed.
+ * @param[in]   change	The change, valid only during the callback
+ * @param[in]   user_data	The user data passed from the callback registration function
+ * @see sound_manager_set_available_route_diff_cb()
+ */
+typedef void (*sound_available_route_diff_cb)(const sound_available_route_change_s *change, void *user_data);
+
+/**
+ * @brief Registers a callback function to be invoked when the active device changes, without repeated notifications.
+ * @details The library keeps the last devices and drops notifications of the sound server which report the same pair,
+ * e.g. while a Bluetooth device reconnects. sound_active_device_changed_cb() still receives every notification.
+ * @param[in]	callback	The callback function
+ * @param[in]	user_data	The user data to be passed to the callback function
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #SOUND_MANAGER_ERROR_NONE Success
+ * @retval #SOUND_MANAGER_ERROR_INVALID_PARAMETER Invalid parameter
+ * @post  sound_active_device_diff_cb() will be invoked
+ * @see sound_manager_unset_active_device_diff_cb()
+ */
+int sound_manager_set_active_device_diff_cb(sound_active_device_diff_cb callback, void *user_data);
+
+/**
+ * @brief Unregisters the callback function.
+ * @see sound_manager_set_active_device_diff_cb()
+ */
+void sound_manager_unset_active_device_diff_cb(void);
+
+/**
+ * @brief Registers a callback function to be invoked when the availability of a route changes, without repeated notifications.
+ * @details The library keeps the available routes and drops notifications of the sound server which do not change them.
+ * sound_available_route_changed_cb() still receives every notification.
+ * @param[in]	callback	The callback function
+ * @param[in]	user_data	The user data to be passed to the callback function
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #SOUND_MANAGER_ERROR_NONE Success
+ * @retval #SOUND_MANAGER_ERROR_INVALID_PARAMETER Invalid parameter
+ * @post  sound_available_route_diff_cb() will be invoked
+ * @see sound_manager_unset_available_route_diff_cb()
+ */
+int sound_manager_set_available_route_diff_cb(sound_available_route_diff_cb callback, void *user_data);
+
+/**
+ * @brief Unregisters the callback function.
+ * @see sound_manager_set_available_route_diff_cb()
+ */
+void sound_manager_unset_available_route_diff_cb(void);
+
+/**
+ * @brief Counters of the volume write coalescer.
+ * @see sound_manager_get_volume_coalescing_stats()
+ */
+typedef struct
+{
+	unsigned int requested;		/**< Number of sound_manager_set_volume() calls while coalescing */
+	unsigned int issued;		/**< Number of levels sent to the sound server */
+	unsigned int coalesced;		/**< Number of levels replaced by a later one before being sent */
+} sound_volume_coalescing_stats_s;
+
+/**
+ * @brief Limits how often sound_manager_set_volume() writes to the sound server.
+ * @details While enabled, at most @a max_rate levels per second are sent for each sound type. A level set sooner
+ * replaces the one waiting for that type and is sent when the interval ends, so only the latest level reaches the
+ * sound server. A level more than @a tolerance steps away from the last sent one is sent right away.
+ * sound_manager_get_volume() returns a waiting level.
+ * @param[in]	max_rate	The maximum number of writes per second and sound type, 0 to send every level (default)
+ * @param[in]	tolerance	The number of steps a level may differ from the last sent one and still wait
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #SOUND_MANAGER_ERROR_NONE Success
+ * @retval #SOUND_MANAGER_ERROR_INVALID_PARAMETER Invalid parameter
+ * @remarks A waiting level is checked against sound_manager_get_max_volume() when it is set, other errors of
+ * the deferred write are only logged. Disabling sends the waiting levels.
+ * @see sound_manager_get_volume_coalescing_stats()
+ */
+int sound_manager_set_volume_coalescing(unsigned int max_rate, int tolerance);
+
+/**
+ * @brief Gets the counters of the volume write coalescer.
+ * @param[out]	stats	The counters since the process started or the last reset
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #SOUND_MANAGER_ERROR_NONE Success
+ * @retval #SOUND_MANAGER_ERROR_INVALID_PARAMETER Invalid parameter
+ * @see sound_manager_reset_volume_coalescing_stats()
+ */
+int sound_manager_get_volume_coalescing_stats(sound_volume_coalescing_stats_s *stats);
+
+/**
+ * @brief Clears the counters of the volume write coalescer.
+ * @see sound_manager_get_volume_coalescing_stats()
+ */
+void sound_manager_reset_volume_coalescing_stats(void);
+
+/**
+ * @brief Gets the routes the library policy allows for a set of connected devices.
+ * @details The answer comes from a table computed once, the sound server is not involved,
+ * so routing policy can be checked for devices which are not connected.
+ * A route is allowed when every device it uses is in @a devices.
+ * @remarks The route policy is advisory only: sound_manager_is_route_available() and sound_manager_set_active_route()
+ * follow the sound server, which may allow or choose other routes.
+ * @param[in]	devices	The connected devices, a bitwise OR of #sound_device_in_e and #sound_device_out_e values
+ * @param[out]	routes	The array to fill in policy order, may be NULL if @a capacity is 0
+ * @param[in]	capacity	The number of elements in @a routes
+ * @param[out]	count	The number of allowed routes, only the first @a capacity of them are written if it is larger
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #SOUND_MANAGER_ERROR_NONE Success
+ * @retval #SOUND_MANAGER_ERROR_INVALID_PARAMETER Invalid parameter
+ * @see sound_manager_route_policy_get_default_route()
+ */
+int sound_manager_route_policy_get_available_routes(unsigned int devices, sound_route_e *routes, int capacity, int *count);
+
+/**
+ * @brief Gets the route the library policy chooses for a set of connected devices.
+ * @details External devices come first: Bluetooth, then wired accessories, then the builtin speaker and receiver.
+ * @param[in]	devices	The connected devices, a bitwise OR of #sound_device_in_e and #sound_device_out_e values
+ * @param[out]	route	The default route
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #SOUND_MANAGER_ERROR_NONE Success
+ * @retval #SOUND_MANAGER_ERROR_INVALID_PARAMETER Invalid parameter
+ * @retval #SOUND_MANAGER_ERROR_INVALID_OPERATION No route is possible with @a devices
+ * @see sound_manager_route_policy_get_available_routes()
+ */
+int sound_manager_route_policy_get_default_route(unsigned int devices, sound_route_e *route);
+
+/**
+ * @brief Checks if the library policy allows a route for a set of connected devices.
+ * @param[in]	devices	The connected devices, a bitwise OR of #sound_device_in_e and #sound_device_out_e values
+ * @param[in]	route	The route to check
+ * @param[out]	available	@c true if @a route is allowed, otherwise @c false
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #SOUND_MANAGER_ERROR_NONE Success
+ * @retval #SOUND_MANAGER_ERROR_INVALID_PARAMETER Invalid parameter
+ * @see sound_manager_route_policy_get_available_routes()
+ */
+int sound_manager_route_policy_is_route_available(unsigned int devices, sound_route_e route, bool *available);
+
+/**
+ * @brief Sound manager state snapshot handle type.
+ */
+typedef struct sound_manager_snapshot_s *sound_manager_snapshot_h;
+
+/**
+ * @brief Captures the sound manager state of the process, e.g. before the application is suspended.
+ * @details The snapshot holds the session type, the registered callbacks with their user data,
+ * the mode of the call session, the volume key type and the volume and device values known to the library.
+ * Nothing is requested from the sound server.
+ * @param[out]	snapshot	The snapshot handle
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #SOUND_MANAGER_ERROR_NONE Success
+ * @retval #SOUND_MANAGER_ERROR_INVALID_PARAMETER Invalid parameter
+ * @retval #SOUND_MANAGER_ERROR_OUT_OF_MEMORY Out of memory
+ * @see sound_manager_snapshot_restore()
+ * @see sound_manager_snapshot_destroy()
+ */
+int sound_manager_snapshot_create(sound_manager_snapshot_h *snapshot);
+
+/**
+ * @brief Brings the sound manager state back to a snapshot, e.g. when the application is resumed.
+ * @details Only what differs from the live state is applied, so the sound server is called for the session type,
+ * the call session mode, the volume key type or a callback registration only when they changed.
+ * Volume levels and devices are system wide and are not written back, they are kept as the last known values
+ * returned with #SOUND_MANAGER_ERROR_STALE_VALUE while the sound server misses the deadline.
+ * @param[in]	snapshot	The snapshot handle
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #SOUND_MANAGER_ERROR_NONE Success
+ * @retval #SOUND_MANAGER_ERROR_INVALID_PARAMETER Invalid parameter
+ * @retval #SOUND_MANAGER_ERROR_INVALID_OPERATION Invalid operation
+ * @remarks The user data of the callbacks must still be valid. The rest of the snapshot is applied when one part fails.
+ * @see sound_manager_snapshot_create()
+ */
+int sound_manager_snapshot_restore(sound_manager_snapshot_h snapshot);
+
+/**
+ * @brief Destroys the snapshot handle.
+ * @param[in]	snapshot	The snapshot handle
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #SOUND_MANAGER_ERROR_NONE Success
+ * @retval #SOUND_MANAGER_ERROR_INVALID_PARAMETER Invalid parameter
+ * @see sound_manager_snapshot_create()
+ */
+int sound_manager_snapshot_destroy(sound_manager_snapshot_h snapshot);
+
+/**
+ * @brief Creates a call session handle without switching the session yet, e.g. while the ringtone plays.
+ * @details The handle is built right away, the call volume is read and kept current on an internal thread,
+ * so the call starts with sound_manager_call_session_activate() doing only the session switch.
+ * A mode set before the activation is applied by it.
+ * @param[in]   type	The call session type
+ * @param[out]  session	A new handle to call session
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #SOUND_MANAGER_ERROR_NONE Successful
+ * @retval #SOUND_MANAGER_ERROR_INVALID_PARAMETER Invalid parameter
+ * @retval #SOUND_MANAGER_ERROR_INVALID_OPERATION All call session handles are in use
+ * @remarks @a session must be released with sound_manager_call_session_destroy(), which does not touch the
+ * session if it was never activated.
+ * @see sound_manager_call_session_activate()
+ */
+int sound_manager_call_session_prepare(sound_call_session_type_e type, sound_call_session_h *session);
+
+/**
+ * @brief Switches the process to a prepared call session.
+ * @param[in]   session	The handle to call session from sound_manager_call_session_prepare()
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #SOUND_MANAGER_ERROR_NONE Successful, also if the session is already active
+ * @retval #SOUND_MANAGER_ERROR_INVALID_PARAMETER Invalid parameter
+ * @see sound_manager_call_session_prepare()
+ */
+int sound_manager_call_session_activate(sound_call_session_h session);
+
+/**
+ * @brief Retry policy for sound server requests which fail while the sound server restarts or is overloaded.
+ * @details A failed request is retried up to @a max_retries times. The n-th retry waits between half and all of
+ * min(@a base_delay_ms * 2^n, @a max_delay_ms), so the clients of a busy sound server do not retry in step.
+ * After @a failure_threshold requests in a row failed every attempt the circuit opens for @a cool_down_ms.
+ * @see sound_manager_set_backend_retry_policy()
+ */
+typedef struct
+{
+	unsigned int max_retries;	/**< Retries of a failed request, 0 for none */
+	unsigned int base_delay_ms;	/**< Delay before the first retry in milliseconds */
+	unsigned int max_delay_ms;	/**< Upper bound of the delay in milliseconds */
+	unsigned int failure_threshold;	/**< Failed requests in a row which open the circuit, 0 to never open it */
+	unsigned int cool_down_ms;	/**< How long the circuit stays open in milliseconds */
+} sound_backend_retry_policy_s;
+
+/**
+ * @brief Enumerations of the circuit breaker states.
+ */
+typedef enum
+{
+	SOUND_BACKEND_CIRCUIT_CLOSED,		/**< Requests go to the sound server */
+	SOUND_BACKEND_CIRCUIT_OPEN,		/**< Requests fail at once, the getters return the last known value */
+	SOUND_BACKEND_CIRCUIT_HALF_OPEN,	/**< The cool-down is over, the next request probes the sound server */
+} sound_backend_circuit_state_e;
+
+/**
+ * @brief Retry and circuit breaker counters.
+ * @see sound_manager_get_backend_retry_stats()
+ */
+typedef struct
+{
+	sound_backend_circuit_state_e state;	/**< Current state of the circuit */
+	unsigned int requests;		/**< Requests made under the policy */
+	unsigned int retries;		/**< Retries of failed requests */
+	unsigned int failures;		/**< Requests which failed every attempt */
+	unsigned int rejected;		/**< Requests failed at once while the circuit was open */
+	unsigned int cached;		/**< Getter calls answered with the last known value while the circuit was open */
+	unsigned int opened;		/**< Number of times the circuit opened */
+} sound_backend_retry_stats_s;
+
+/**
+ * @brief Sets the retry policy and circuit breaker shared by all sound server requests of the process.
+ * @details Applies to the volume, current sound type and active device getters, sound_manager_get_max_volume(),
+ * sound_manager_set_volume(), sound_manager_set_volume_key_type() and sound_manager_set_active_route().
+ * While the circuit is open these fail with #SOUND_MANAGER_ERROR_INVALID_OPERATION without asking the sound server,
+ * except the getters with a last known value, which return it with #SOUND_MANAGER_ERROR_STALE_VALUE.
+ * @param[in]	policy	The retry policy, NULL to disable retries and the circuit breaker (default)
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #SOUND_MANAGER_ERROR_NONE Success
+ * @retval #SOUND_MANAGER_ERROR_INVALID_PARAMETER Invalid parameter
+ * @remarks Setting a policy closes the circuit.
+ * @see sound_manager_get_backend_retry_policy()
+ * @see sound_manager_get_backend_retry_stats()
+ */
+int sound_manager_set_backend_retry_policy(const sound_backend_retry_policy_s *policy);
+
+/**
+ * @brief Gets the retry policy, all zero when disabled.
+ * @param[out]	policy	The retry policy
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #SOUND_MANAGER_ERROR_NONE Success
+ * @retval #SOUND_MANAGER_ERROR_INVALID_PARAMETER Invalid parameter
+ * @see sound_manager_set_backend_retry_policy()
+ */
+int sound_manager_get_backend_retry_policy(sound_backend_retry_policy_s *policy);
+
+/**
+ * @brief Gets the circuit state and the retry counters.
+ * @param[out]	stats	The counters since the process started or the last reset
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #SOUND_MANAGER_ERROR_NONE Success
+ * @retval #SOUND_MANAGER_ERROR_INVALID_PARAMETER Invalid parameter
+ * @see sound_manager_reset_backend_retry_stats()
+ */
+int sound_manager_get_backend_retry_stats(sound_backend_retry_stats_s *stats);
+
+/**
+ * @brief Clears the retry counters.
+ * @see sound_manager_get_backend_retry_stats()
+ */
+void sound_manager_reset_backend_retry_stats(void);
+
+/**
+ * @brief The largest batch sound_manager_set_event_batch_cb() accepts.
+ */
+#define SOUND_EVENT_BATCH_MAX 256
+
+/**
+ * @brief Enumerations of the events delivered in batches.
+ */
+typedef enum
+{
+	SOUND_EVENT_VOLUME_CHANGED,		/**< A volume changed, see sound_manager_volume_changed_cb() */
+	SOUND_EVENT_SESSION_NOTIFY,		/**< The session was interrupted or resumed, see sound_session_notify_cb() */
+	SOUND_EVENT_AVAILABLE_ROUTE_CHANGED,	/**< A route became available or unavailable, see sound_available_route_changed_cb() */
+	SOUND_EVENT_ACTIVE_DEVICE_CHANGED,	/**< The active devices changed, see sound_active_device_changed_cb() */
+	SOUND_EVENT_MUTE_CHANGED,		/**< A sound type was muted or unmuted, see sound_mute_changed_cb() */
+} sound_event_type_e;
+
+/**
+ * @brief An event record, 16 bytes so that four share a cache line.
+ * @details The member of @a data matching @a type holds the arguments the per-event callback receives.
+ * @see sound_event_batch_cb()
+ */
+typedef struct
+{
+	unsigned int sequence;		/**< Counts every event since the subscription, a gap means records were dropped */
+	sound_event_type_e type;	/**< The kind of event */
+	union
+	{
+		struct
+		{
+			sound_type_e type;	/**< The sound type */
+			int volume;		/**< The new volume */
+		} volume;			/**< #SOUND_EVENT_VOLUME_CHANGED */
+		struct
+		{
+			sound_session_notify_e notify;	/**< Stop or resume */
+			sound_interrupted_code_e code;	/**< The interruption cause, as passed to sound_interrupted_cb() */
+		} session;			/**< #SOUND_EVENT_SESSION_NOTIFY */
+		struct
+		{
+			sound_route_e route;	/**< The route */
+			int available;		/**< Non-zero if the route is available */
+		} route;			/**< #SOUND_EVENT_AVAILABLE_ROUTE_CHANGED */
+		struct
+		{
+			sound_device_in_e in;	/**< The active input device */
+			sound_device_out_e out;	/**< The active output device */
+		} device;			/**< #SOUND_EVENT_ACTIVE_DEVICE_CHANGED */
+		struct
+		{
+			sound_type_e type;	/**< The sound type */
+			int muted;		/**< Non-zero if the type is now muted */
+		} mute;				/**< #SOUND_EVENT_MUTE_CHANGED */
+	} data;
+} sound_event_s;
+
+/**
+ * @brief Called with the events gathered since the last batch, oldest first.
+ * @param[in]   events	The event records, only valid during the call
+ * @param[in]   count	The number of records, at least 1
+ * @param[in]   user_data	The user data passed from the callback registration function
+ * @pre sound_manager_set_event_batch_cb() will invoke this callback on a delivery thread of its own.
+ * A slow callback delays the following batches, and events beyond #SOUND_EVENT_BATCH_MAX are dropped meanwhile.
+ * @see sound_manager_set_event_batch_cb()
+ */
+typedef void (*sound_event_batch_cb)(const sound_event_s *events, unsigned int count, void *user_data);
+
+/**
+ * @brief Registers a callback which receives the volume, session, route, device and mute events in batches.
+ * @details Events are gathered for @a window_ms after the first one of a batch, or until @a max_batch records are waiting,
+ * and then delivered in one call. The per-event callbacks keep working alongside.
+ * When the callback falls #SOUND_EVENT_BATCH_MAX records behind, further events are dropped until it catches up.
+ * @param[in]	window_ms	How long an event may wait for others, 0 to deliver whatever is waiting as soon as possible
+ * @param[in]	max_batch	The largest batch, 1 to #SOUND_EVENT_BATCH_MAX
+ * @param[in]	callback	The callback function to invoke
+ * @param[in]	user_data	The user data to be passed to the callback function
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #SOUND_MANAGER_ERROR_NONE Success
+ * @retval #SOUND_MANAGER_ERROR_INVALID_PARAMETER Invalid parameter
+ * @retval #SOUND_MANAGER_ERROR_INVALID_OPERATION Invalid operation
+ * @remarks Session events need a session, the default one is registered unless the application already has one.
+ * Registering again replaces the callback and its parameters.
+ * @post sound_event_batch_cb() will be invoked
+ * @see sound_manager_unset_event_batch_cb()
+ */
+int sound_manager_set_event_batch_cb(unsigned int window_ms, unsigned int max_batch, sound_event_batch_cb callback, void *user_data);
+
+/**
+ * @brief Unregisters the batched event callback, events still waiting are discarded.
+ * @details Waits for a running batch callback to return, unless called from it. The callback is not invoked again once
+ * this returns, not even for the rest of a batch it was handed out in parts.
+ * @see sound_manager_set_event_batch_cb()
+ */
+void sound_manager_unset_event_batch_cb(void);
+
+/**
+ * @brief Timing of a volume, session, route or device event, see sound_manager_get_event_info().
+ * @details Times are taken from the monotonic clock, in microseconds.
+ */
+typedef struct
+{
+	unsigned int sequence;			/**< Counts the events received by the process, starting at 1 */
+	sound_event_type_e type;		/**< The kind of event */
+	unsigned long long receive_time_us;	/**< When the sound server notification reached the library */
+	unsigned long long delivery_time_us;	/**< When the library started invoking the callbacks of the event */
+} sound_event_info_s;
+
+/**
+ * @brief Gets the timing of the event being delivered to the calling callback.
+ * @details Call it from sound_manager_volume_changed_cb(), sound_session_notify_cb(), sound_interrupted_cb(),
+ * sound_available_route_changed_cb(), sound_available_route_diff_cb(), sound_active_device_changed_cb()
+ * or sound_active_device_diff_cb(). All callbacks of one event see the same information.
+ * @param[out]	info	The event information
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #SOUND_MANAGER_ERROR_NONE Success
+ * @retval #SOUND_MANAGER_ERROR_INVALID_PARAMETER Invalid parameter
+ * @retval #SOUND_MANAGER_ERROR_INVALID_OPERATION Not called from one of the callbacks above
+ * @see sound_manager_get_event_latency()
+ */
+int sound_manager_get_event_info(sound_event_info_s *info);
+
+/**
+ * @brief Time from the sound server notification reaching the library to the first callback of the event.
+ * @details Only events delivered to at least one of the callbacks listed in sound_manager_get_event_info() are counted.
+ * Percentiles are bucketed with about 25% resolution.
+ * @see sound_manager_get_event_latency()
+ */
+typedef struct
+{
+	unsigned int count;		/**< Number of delivered events */
+	unsigned int p50_us;		/**< Median latency in microseconds */
+	unsigned int p99_us;		/**< 99th percentile latency in microseconds */
+	unsigned int p999_us;		/**< 99.9th percentile latency in microseconds */
+	unsigned int max_us;		/**< Maximum latency in microseconds */
+} sound_event_latency_s;
+
+/**
+ * @brief Gets the delivery latency statistics of the events.
+ * @param[out]	latency	The latency statistics since the process started or the last reset
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #SOUND_MANAGER_ERROR_NONE Success
+ * @retval #SOUND_MANAGER_ERROR_INVALID_PARAMETER Invalid parameter
+ * @see sound_manager_reset_event_latency()
+ */
+int sound_manager_get_event_latency(sound_event_latency_s *latency);
+
+/**
+ * @brief Clears the delivery latency statistics of the events.
+ * @see sound_manager_get_event_latency()
+ */
+void sound_manager_reset_event_latency(void);
+
+/**
+ * @brief Volume and route preferences read back from the persistence file.
+ * @see sound_manager_get_persisted_state()
+ */
+typedef struct
+{
+	unsigned int volume_mask;		/**< Bit (1 << type) is set for each #sound_type_e with a recorded volume */
+	int volume[SOUND_TYPE_CALL + 1];	/**< The recorded volumes, indexed by #sound_type_e */
+	bool key_type_known;			/**< Whether @a key_type was recorded */
+	volume_key_type_e key_type;		/**< The last volume key type set */
+	bool route_known;			/**< Whether @a route was recorded */
+	sound_route_e route;			/**< The last route set with sound_manager_set_active_route() */
+} sound_persisted_state_s;
+
+/**
+ * @brief Counters of the persistence file writer.
+ * @see sound_manager_get_persistence_stats()
+ */
+typedef struct
+{
+	unsigned int recorded;		/**< Number of changed values recorded */
+	unsigned int written;		/**< Number of successful file writes, each followed by fsync() of the file and its directory */
+	unsigned int failed;		/**< Number of file writes which failed, not counted in @a written */
+} sound_persistence_stats_s;
+
+/**
+ * @brief Keeps the volumes, the volume key type and the active route in a file.
+ * @details The file is read once with mmap() when persistence is set, so the preferences of the previous run are
+ * available from sound_manager_get_persisted_state() without asking the sound server; the volumes also become the
+ * last known values returned by the getters while the sound server misses its deadline.
+ * Afterwards, the volumes set by the application or reported by sound_manager_volume_changed_cb(), the volume key type
+ * and the route are recorded in memory. A background thread writes them to @a path, replacing the file atomically,
+ * at most once every @a min_interval_ms, so a burst of changes costs a single write and fsync().
+ * @param[in]	path	The file to keep the preferences in, a temporary file next to it is used while writing
+ * @param[in]	min_interval_ms	The shortest time between two writes
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #SOUND_MANAGER_ERROR_NONE Success
+ * @retval #SOUND_MANAGER_ERROR_INVALID_PARAMETER Invalid parameter
+ * @retval #SOUND_MANAGER_ERROR_OUT_OF_MEMORY Out of memory
+ * @retval #SOUND_MANAGER_ERROR_INVALID_OPERATION The writer thread could not be started
+ * @remarks A missing or damaged file starts empty. Setting persistence again first writes what is pending to the previous file.
+ * @remarks A write which fails is retried after @a min_interval_ms, and not sooner than a second, until one succeeds.
+ * sound_manager_unset_persistence() makes one last attempt.
+ * @see sound_manager_unset_persistence()
+ */
+int sound_manager_set_persistence(const char *path, unsigned int min_interval_ms);
+
+/**
+ * @brief Stops persistence after writing the changes still pending.
+ * @see sound_manager_set_persistence()
+ */
+void sound_manager_unset_persistence(void);
+
+/**
+ * @brief Gets the preferences recorded so far, starting with those read from the file.
+ * @param[out]	state	The recorded preferences
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #SOUND_MANAGER_ERROR_NONE Success
+ * @retval #SOUND_MANAGER_ERROR_INVALID_PARAMETER Invalid parameter
+ * @retval #SOUND_MANAGER_ERROR_INVALID_OPERATION Persistence is not set
+ * @see sound_manager_set_persistence()
+ */
+int sound_manager_get_persisted_state(sound_persisted_state_s *state);
+
+/**
+ * @brief Gets the counters of the persistence file writer.
+ * @param[out]	stats	The counters since persistence was set
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #SOUND_MANAGER_ERROR_NONE Success
+ * @retval #SOUND_MANAGER_ERROR_INVALID_PARAMETER Invalid parameter
+ * @see sound_manager_set_persistence()
+ */
+int sound_manager_get_persistence_stats(sound_persistence_stats_s *stats);
+
+/**
+ * @brief Called when a sound type is muted or unmuted with sound_manager_set_mute().
+ * @param[in]   type	The sound type
+ * @param[in]   muted	Whether the type is now muted
+ * @param[in]   user_data	The user data passed from the callback registration function
+ * @pre sound_manager_set_mute() will invoke this callback, once per actual change.
+ * @see sound_manager_set_mute_changed_cb()
+ */
+typedef void (*sound_mute_changed_cb)(sound_type_e type, bool muted, void *user_data);
+
+/**
+ * @brief Mutes or unmutes a sound type in this process.
+ * @details Like ducking, muting only changes the local gain: the effective gain of every stream volume handle of @a type
+ * drops to 0.0, and unmuting brings back the gain of the current level. The system volume is not written,
+ * so sound_manager_get_volume() keeps returning the level from before muting and no volume change is notified.
+ * A single sound_mute_changed_cb() and #SOUND_EVENT_MUTE_CHANGED event report the change.
+ * @param[in]	type	The sound type
+ * @param[in]	muted	@c true to mute, @c false to unmute
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #SOUND_MANAGER_ERROR_NONE Success
+ * @retval #SOUND_MANAGER_ERROR_INVALID_PARAMETER Invalid parameter
+ * @remarks Only streams created with sound_manager_stream_volume_create() are muted. Players and other
+ * playback of @a type which do not apply the gain of a stream volume handle keep playing at the system level.
+ * @remarks Muting a muted type or unmuting an unmuted one does nothing.
+ * @see sound_manager_get_mute()
+ * @see sound_manager_stream_volume_create()
+ */
+int sound_manager_set_mute(sound_type_e type, bool muted);
+
+/**
+ * @brief Gets whether a sound type is muted in this process.
+ * @param[in]	type	The sound type
+ * @param[out]	muted	Whether the type is muted
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #SOUND_MANAGER_ERROR_NONE Success
+ * @retval #SOUND_MANAGER_ERROR_INVALID_PARAMETER Invalid parameter
+ * @see sound_manager_set_mute()
+ */
+int sound_manager_get_mute(sound_type_e type, bool *muted);
+
+/**
+ * @brief Registers a callback function to be invoked when a sound type is muted or unmuted.
+ * @param[in]	callback	The callback function to invoke
+ * @param[in]	user_data	The user data to be passed to the callback function
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #SOUND_MANAGER_ERROR_NONE Success
+ * @retval #SOUND_MANAGER_ERROR_INVALID_PARAMETER Invalid parameter
+ * @post sound_mute_changed_cb() will be invoked
+ * @see sound_manager_unset_mute_changed_cb()
+ */
+int sound_manager_set_mute_changed_cb(sound_mute_changed_cb callback, void *user_data);
+
+/**
+ * @brief Unregisters the callback function which is called when a sound type is muted or unmuted.
+ * @see sound_manager_set_mute_changed_cb()
+ */
+void sound_manager_unset_mute_changed_cb(void);
+
 /**
  * @}
  */
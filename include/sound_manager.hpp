@@ -0,0 +1,417 @@
+/*
+* Copyright (c) 2011 Samsung Electronics Co., Ltd All Rights Reserved
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+
+
+
+#ifndef __TIZEN_MEDIA_SOUND_MANAGER_HPP__
+#define __TIZEN_MEDIA_SOUND_MANAGER_HPP__
+
+#include <sound_manager.h>
+#include <atomic>
+#include <cstddef>
+#include <utility>
+
+/**
+ * @file sound_manager.hpp
+ * @brief C++17 wrapper of the sound manager API, header only.
+ * @details Every call is an inline forward to the C function. Callbacks are adapted with a
+ * trampoline generated per callable type, the callable itself is passed as user data, so
+ * nothing is allocated or type erased. The callable must outlive its subscription.
+ */
+
+/**
+ * @addtogroup CAPI_MEDIA_SOUND_MANAGER_MODULE
+ * @{
+ */
+
+namespace tizen::sound {
+
+/**
+ * @brief Value or #sound_manager_error_e, shaped after std::expected.
+ * @details #SOUND_MANAGER_ERROR_STALE_VALUE carries a value, has_value() is @c true and error() reports the status.
+ */
+template <typename T>
+class result
+{
+public:
+	constexpr result(T value, int error = SOUND_MANAGER_ERROR_NONE) : _value(std::move(value)), _error(error) {}
+	static constexpr result failure(int error) { return result(T(), error); }
+
+	constexpr bool has_value() const { return _error == SOUND_MANAGER_ERROR_NONE || _error == SOUND_MANAGER_ERROR_STALE_VALUE; }
+	constexpr explicit operator bool() const { return has_value(); }
+	constexpr int error() const { return _error; }
+
+	constexpr T &value() & { return _value; }
+	constexpr const T &value() const & { return _value; }
+	constexpr T &&value() && { return std::move(_value); }
+	constexpr T &operator*() & { return _value; }
+	constexpr const T &operator*() const & { return _value; }
+	constexpr T &&operator*() && { return std::move(_value); }
+	constexpr T *operator->() { return &_value; }
+	constexpr const T *operator->() const { return &_value; }
+	template <typename U>
+	constexpr T value_or(U &&fallback) const & { return has_value() ? _value : static_cast<T>(std::forward<U>(fallback)); }
+
+private:
+	T _value;
+	int _error;
+};
+
+template <>
+class result<void>
+{
+public:
+	constexpr result(int error = SOUND_MANAGER_ERROR_NONE) : _error(error) {}
+
+	constexpr bool has_value() const { return _error == SOUND_MANAGER_ERROR_NONE; }
+	constexpr explicit operator bool() const { return has_value(); }
+	constexpr int error() const { return _error; }
+
+private:
+	int _error;
+};
+
+/**
+ * @brief Move-only registration of a process wide callback, unregistered on destruction.
+ * @remarks The sound manager keeps one callback of each kind, a newer registration of the same kind replaces the older one.
+ * Resetting a replaced subscription leaves the newer registration in place. Registrations made with the C API are not tracked.
+ */
+class subscription
+{
+public:
+	constexpr subscription() = default;
+	constexpr subscription(void (*unset)(unsigned long), unsigned long generation) : _unset(unset), _generation(generation) {}
+	subscription(subscription &&other) noexcept : _unset(std::exchange(other._unset, nullptr)), _generation(other._generation) {}
+	subscription &operator=(subscription &&other) noexcept
+	{
+		if(this != &other){
+			reset();
+			_unset = std::exchange(other._unset, nullptr);
+			_generation = other._generation;
+		}
+		return *this;
+	}
+	subscription(const subscription &) = delete;
+	subscription &operator=(const subscription &) = delete;
+	~subscription() { reset(); }
+
+	constexpr explicit operator bool() const { return _unset != nullptr; }
+	void reset()
+	{
+		if(_unset)
+			std::exchange(_unset, nullptr)(_generation);
+	}
+
+private:
+	void (*_unset)(unsigned long) = nullptr;
+	unsigned long _generation = 0;
+};
+
+/**
+ * @brief Move-only call session, destroyed with the object.
+ */
+class call_session
+{
+public:
+	static result<call_session> create(sound_call_session_type_e type)
+	{
+		sound_call_session_h handle = nullptr;
+		int ret = sound_manager_call_session_create(type, &handle);
+		return result<call_session>(call_session(handle), ret);
+	}
+
+	constexpr call_session() = default;
+	call_session(call_session &&other) noexcept : _handle(std::exchange(other._handle, nullptr)) {}
+	call_session &operator=(call_session &&other) noexcept
+	{
+		if(this != &other){
+			reset();
+			_handle = std::exchange(other._handle, nullptr);
+		}
+		return *this;
+	}
+	call_session(const call_session &) = delete;
+	call_session &operator=(const call_session &) = delete;
+	~call_session() { reset(); }
+
+	/** @brief Adopts a handle, e.g. the one returned by sound_manager_transaction_commit(). */
+	constexpr explicit call_session(sound_call_session_h handle) : _handle(handle) {}
+	constexpr sound_call_session_h get() const { return _handle; }
+	sound_call_session_h release() { return std::exchange(_handle, nullptr); }
+	constexpr explicit operator bool() const { return _handle != nullptr; }
+
+	void reset()
+	{
+		if(_handle)
+			sound_manager_call_session_destroy(std::exchange(_handle, nullptr));
+	}
+
+	result<void> set_mode(sound_call_session_mode_e mode) const
+	{
+		return sound_manager_call_session_set_mode(_handle, mode);
+	}
+
+	result<sound_call_session_mode_e> get_mode() const
+	{
+		sound_call_session_mode_e mode = SOUND_CALL_SESSION_MODE_VOICE;
+		int ret = sound_manager_call_session_get_mode(_handle, &mode);
+		return result<sound_call_session_mode_e>(mode, ret);
+	}
+
+	result<sound_call_session_type_e> get_type() const
+	{
+		sound_call_session_type_e type = SOUND_CALL_SESSION_TYPE_CALL;
+		int ret = sound_manager_call_session_get_type(_handle, &type);
+		return result<sound_call_session_type_e>(type, ret);
+	}
+
+private:
+	sound_call_session_h _handle = nullptr;
+};
+
+inline result<int> get_max_volume(sound_type_e type)
+{
+	int max = 0;
+	int ret = sound_manager_get_max_volume(type, &max);
+	return result<int>(max, ret);
+}
+
+inline result<void> set_volume(sound_type_e type, int volume)
+{
+	return sound_manager_set_volume(type, volume);
+}
+
+inline result<int> get_volume(sound_type_e type)
+{
+	int volume = 0;
+	int ret = sound_manager_get_volume(type, &volume);
+	return result<int>(volume, ret);
+}
+
+inline result<sound_type_e> get_current_sound_type()
+{
+	sound_type_e type = SOUND_TYPE_SYSTEM;
+	int ret = sound_manager_get_current_sound_type(&type);
+	return result<sound_type_e>(type, ret);
+}
+
+inline result<void> set_mute(sound_type_e type, bool muted)
+{
+	return sound_manager_set_mute(type, muted);
+}
+
+inline result<bool> get_mute(sound_type_e type)
+{
+	bool muted = false;
+	int ret = sound_manager_get_mute(type, &muted);
+	return result<bool>(muted, ret);
+}
+
+inline result<void> set_volume_key_type(volume_key_type_e type)
+{
+	return sound_manager_set_volume_key_type(type);
+}
+
+inline result<volume_key_type_e> get_volume_key_type()
+{
+	volume_key_type_e type = VOLUME_KEY_TYPE_NONE;
+	int ret = sound_manager_get_volume_key_type(&type);
+	return result<volume_key_type_e>(type, ret);
+}
+
+inline result<void> set_active_route(sound_route_e route)
+{
+	return sound_manager_set_active_route(route);
+}
+
+inline result<std::pair<sound_device_in_e, sound_device_out_e>> get_active_device()
+{
+	sound_device_in_e in = SOUND_DEVICE_IN_MIC;
+	sound_device_out_e out = SOUND_DEVICE_OUT_SPEAKER;
+	int ret = sound_manager_get_active_device(&in, &out);
+	return result<std::pair<sound_device_in_e, sound_device_out_e>>(std::make_pair(in, out), ret);
+}
+
+/** @brief Timing of the event being delivered, only from inside an event callback. */
+inline result<sound_event_info_s> get_event_info()
+{
+	sound_event_info_s info = {};
+	int ret = sound_manager_get_event_info(&info);
+	return result<sound_event_info_s>(info, ret);
+}
+
+/** @brief Fills @a routes, the value is the number of available routes which may exceed @a N. */
+template <std::size_t N>
+result<int> get_available_routes(sound_route_e (&routes)[N])
+{
+	int count = 0;
+	int ret = sound_manager_get_available_routes(routes, static_cast<int>(N), &count);
+	return result<int>(count, ret);
+}
+
+/** @brief Calls @a callback(route) for each available route, stops when it returns @c false. */
+template <typename F>
+result<void> foreach_available_route(F &callback)
+{
+	return sound_manager_foreach_available_route(
+		[](sound_route_e route, void *user_data) -> bool {
+			return (*static_cast<F *>(user_data))(route);
+		}, &callback);
+}
+
+namespace detail {
+
+/* the last registration of a callback kind, so a replaced subscription does not unset the newer one */
+template <void (*Unset)(void)>
+struct registration
+{
+	static inline std::atomic<unsigned long> generation{0};
+
+	static void unset(unsigned long current)
+	{
+		if(generation.compare_exchange_strong(current, current + 1))
+			Unset();
+	}
+};
+
+template <void (*Unset)(void)>
+result<subscription> subscribe(int ret)
+{
+	if(ret != SOUND_MANAGER_ERROR_NONE)
+		return result<subscription>::failure(ret);
+	return result<subscription>(subscription(registration<Unset>::unset, ++registration<Unset>::generation));
+}
+
+}
+
+/** @brief Invokes @a callback(type, volume) when a volume level changes. */
+template <typename F>
+result<subscription> on_volume_changed(F &callback)
+{
+	return detail::subscribe<sound_manager_unset_volume_changed_cb>(sound_manager_set_volume_changed_cb(
+		[](sound_type_e type, unsigned int volume, void *user_data) {
+			(*static_cast<F *>(user_data))(type, volume);
+		}, &callback));
+}
+
+/** @brief Invokes @a callback(type, muted) when a sound type is muted or unmuted. */
+template <typename F>
+result<subscription> on_mute_changed(F &callback)
+{
+	return detail::subscribe<sound_manager_unset_mute_changed_cb>(sound_manager_set_mute_changed_cb(
+		[](sound_type_e type, bool muted, void *user_data) {
+			(*static_cast<F *>(user_data))(type, muted);
+		}, &callback));
+}
+
+/** @brief Invokes @a callback(type, playing) when the current playing sound type changes. */
+template <typename F>
+result<subscription> on_current_sound_type_changed(F &callback)
+{
+	return detail::subscribe<sound_manager_unset_current_sound_type_changed_cb>(sound_manager_set_current_sound_type_changed_cb(
+		[](sound_type_e type, bool playing, void *user_data) {
+			(*static_cast<F *>(user_data))(type, playing);
+		}, &callback));
+}
+
+/** @brief Invokes @a callback(notify) on session notifications. */
+template <typename F>
+result<subscription> on_session_notify(F &callback)
+{
+	return detail::subscribe<sound_manager_unset_session_notify_cb>(sound_manager_set_session_notify_cb(
+		[](sound_session_notify_e notify, void *user_data) {
+			(*static_cast<F *>(user_data))(notify);
+		}, &callback));
+}
+
+/** @brief Invokes @a callback(code) when the playing sound is interrupted. */
+template <typename F>
+result<subscription> on_interrupted(F &callback)
+{
+	return detail::subscribe<sound_manager_unset_interrupted_cb>(sound_manager_set_interrupted_cb(
+		[](sound_interrupted_code_e code, void *user_data) {
+			(*static_cast<F *>(user_data))(code);
+		}, &callback));
+}
+
+/** @brief Invokes @a callback(type) when the volume key type changes. */
+template <typename F>
+result<subscription> on_volume_key_type_changed(F &callback)
+{
+	return detail::subscribe<sound_manager_unset_volume_key_type_changed_cb>(sound_manager_set_volume_key_type_changed_cb(
+		[](volume_key_type_e type, void *user_data) {
+			(*static_cast<F *>(user_data))(type);
+		}, &callback));
+}
+
+/** @brief Invokes @a callback(route, available) when a route becomes available or unavailable. */
+template <typename F>
+result<subscription> on_available_route_changed(F &callback)
+{
+	return detail::subscribe<sound_manager_unset_available_route_changed_cb>(sound_manager_set_available_route_changed_cb(
+		[](sound_route_e route, bool available, void *user_data) {
+			(*static_cast<F *>(user_data))(route, available);
+		}, &callback));
+}
+
+/** @brief Invokes @a callback(in, out) when the active device changes. */
+template <typename F>
+result<subscription> on_active_device_changed(F &callback)
+{
+	return detail::subscribe<sound_manager_unset_active_device_changed_cb>(sound_manager_set_active_device_changed_cb(
+		[](sound_device_in_e in, sound_device_out_e out, void *user_data) {
+			(*static_cast<F *>(user_data))(in, out);
+		}, &callback));
+}
+
+/** @brief Invokes @a callback(change) when the availability of a route actually changes. */
+template <typename F>
+result<subscription> on_available_route_diff(F &callback)
+{
+	return detail::subscribe<sound_manager_unset_available_route_diff_cb>(sound_manager_set_available_route_diff_cb(
+		[](const sound_available_route_change_s *change, void *user_data) {
+			(*static_cast<F *>(user_data))(*change);
+		}, &callback));
+}
+
+/** @brief Invokes @a callback(change) when the active device actually changes. */
+template <typename F>
+result<subscription> on_active_device_diff(F &callback)
+{
+	return detail::subscribe<sound_manager_unset_active_device_diff_cb>(sound_manager_set_active_device_diff_cb(
+		[](const sound_active_device_change_s *change, void *user_data) {
+			(*static_cast<F *>(user_data))(*change);
+		}, &callback));
+}
+
+/** @brief Invokes @a callback(events, count) with the events gathered over @a window_ms, at most @a max_batch at a time. */
+template <typename F>
+result<subscription> on_event_batch(unsigned int window_ms, unsigned int max_batch, F &callback)
+{
+	return detail::subscribe<sound_manager_unset_event_batch_cb>(sound_manager_set_event_batch_cb(window_ms, max_batch,
+		[](const sound_event_s *events, unsigned int count, void *user_data) {
+			(*static_cast<F *>(user_data))(events, count);
+		}, &callback));
+}
+
+}
+
+/**
+ * @}
+ */
+
+#endif /* __TIZEN_MEDIA_SOUND_MANAGER_HPP__ */
@@ -0,0 +1,226 @@
+/*
+* Copyright (c) 2011 Samsung Electronics Co., Ltd All Rights Reserved
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+
+
+
+#ifndef __TIZEN_MEDIA_SOUND_MANAGER_PRIVATE_H__
+#define __TIZEN_MEDIA_SOUND_MANAGER_PRIVATE_H__
+
+#include <sound_manager.h>
+#include <mm_error.h>
+#ifndef SOUND_MANAGER_DISABLE_SESSION
+#include <mm_session.h>
+#endif
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/*
+ * Internal helpers shared between the sound manager translation units.
+ * This header is not installed.
+ */
+
+#define MAX_VOLUME_TYPE 5
+/* number of sound_route_e values */
+#define MAX_ROUTE_NUM 10
+
+int __convert_sound_manager_error_code(const char *func, int code);
+
+/* Monotonic clock in microseconds */
+unsigned long long _sound_manager_get_time_us(void);
+
+/*
+ * Latency histogram updated with atomics, log2 buckets split in
+ * 2^SOUND_MANAGER_LATENCY_SUB_BUCKET_BITS linear steps (about 25% resolution).
+ */
+#define SOUND_MANAGER_LATENCY_SUB_BUCKET_BITS 2
+#define SOUND_MANAGER_LATENCY_BUCKET_NUM (32 << SOUND_MANAGER_LATENCY_SUB_BUCKET_BITS)
+typedef struct {
+	unsigned int bucket[SOUND_MANAGER_LATENCY_BUCKET_NUM];
+	unsigned int count;
+	unsigned int max_us;
+}_sound_manager_latency_s;
+
+void _sound_manager_latency_record(_sound_manager_latency_s *latency, unsigned long long elapsed_us);
+/* Nearest rank percentiles, reported as the upper bound of their bucket */
+void _sound_manager_latency_get(_sound_manager_latency_s *latency, unsigned int *count,
+	unsigned int *p50_us, unsigned int *p99_us, unsigned int *p999_us, unsigned int *max_us);
+void _sound_manager_latency_reset(_sound_manager_latency_s *latency);
+
+/*
+ * Library timers, run on an internal worker thread.
+ * Return non-zero from the callback to be called again after interval_ms.
+ * _sound_manager_timer_remove() waits for a running callback, so do not hold
+ * a lock the callback takes while removing a timer.
+ */
+typedef int (*_sound_manager_timer_cb)(void *user_data);
+unsigned int _sound_manager_timer_add(unsigned int interval_ms, _sound_manager_timer_cb callback, void *user_data);
+/* takes effect when the timer is scheduled again, a callback may change its own */
+void _sound_manager_timer_set_interval(unsigned int id, unsigned int interval_ms);
+void _sound_manager_timer_remove(unsigned int id);
+
+/*
+ * Backend getters bounded by the deadline set with sound_manager_set_backend_deadline().
+ * The volume getters use the sound type as slot. On a missed deadline the last known
+ * values are returned with @a stale set, or SOUND_MANAGER_ERROR_TIMED_OUT if there are none.
+ */
+#define SOUND_MANAGER_BACKEND_SLOT_ACTIVE_DEVICE (MAX_VOLUME_TYPE + 1)
+#define SOUND_MANAGER_BACKEND_SLOT_CURRENT_SOUND_TYPE (MAX_VOLUME_TYPE + 2)
+#define SOUND_MANAGER_BACKEND_SLOT_NUM (MAX_VOLUME_TYPE + 3)
+typedef int (*_sound_manager_backend_fn)(int arg, int *values);
+int _sound_manager_backend_call(int slot, _sound_manager_backend_fn func, int arg, int *values, int *stale);
+/*
+ * Runs one sound server request under the retry policy, see sound_manager_set_backend_retry_policy().
+ * Setters pass their input in @a values. Returns MM_ERROR_SOUND_INTERNAL at once while the circuit is open.
+ */
+int _sound_manager_backend_request(_sound_manager_backend_fn func, int arg, int *values);
+/* Records values known without asking the backend, e.g. after a successful set */
+void _sound_manager_backend_update(int slot, const int *values);
+/* Records values from an earlier run of the process, unless newer ones are known */
+void _sound_manager_backend_seed(int slot, const int *values);
+
+/* Sends the volume to the sound server and updates the caches, returns the mm error */
+int _sound_manager_volume_write(sound_type_e type, int volume);
+/* Records a level from a saved state as the last known one, the sound server is not written */
+void _sound_manager_volume_seed(sound_type_e type, int volume);
+
+/*
+ * Volume write coalescer, see sound_manager_set_volume_coalescing().
+ * Returns non-zero with the result in @a ret if it took the request.
+ */
+int _sound_manager_volume_coalesce(sound_type_e type, int volume, int *ret);
+/* Returns non-zero with the level waiting to be sent for @a type */
+int _sound_manager_volume_coalesce_get_pending(sound_type_e type, int *volume);
+/* Sends the level at once, after the write of its type in flight, in place of the one waiting. Returns the mm error */
+int _sound_manager_volume_coalesce_write_now(sound_type_e type, int volume);
+
+/*
+ * Keeps the backend volume change notification registered while referenced.
+ * The per-type volume cache is only trusted while a reference is held.
+ */
+void _sound_manager_volume_monitor_ref(void);
+void _sound_manager_volume_monitor_unref(void);
+
+/* Stream volume hook, called when the volume of a sound type has changed */
+void _sound_manager_stream_volume_type_changed(sound_type_e type, int volume, int max);
+
+/* Stream volume hook, called by the ducking ramp with the current duck gain (1.0 when not ducked) */
+void _sound_manager_stream_volume_set_duck_gain(sound_type_e type, double gain);
+
+/* Queues an event for the batched event callback, see sound_manager_set_event_batch_cb() */
+void _sound_manager_event_batch_push(sound_event_type_e type, int value1, int value2);
+
+/*
+ * A backend notification on its way to the application callbacks, see
+ * sound_manager_get_event_info(). Stamp it as soon as it reaches the library
+ * and bracket the callbacks with deliver_begin/end.
+ */
+typedef struct _sound_manager_event_s {
+	sound_event_info_s info;
+	int delivered;
+	struct _sound_manager_event_s *outer;	/* event delivered further up the same thread */
+}_sound_manager_event_s;
+
+void _sound_manager_event_receive(_sound_manager_event_s *event, sound_event_type_e type);
+void _sound_manager_event_deliver_begin(_sound_manager_event_s *event);
+void _sound_manager_event_deliver_end(_sound_manager_event_s *event);
+
+/* Persistence hooks, record a value the application chose, see sound_manager_set_persistence() */
+void _sound_manager_persist_volume(sound_type_e type, int volume);
+void _sound_manager_persist_key_type(volume_key_type_e type);
+void _sound_manager_persist_route(sound_route_e route);
+
+/* Current sound type monitor, returns non-zero with the last sample in @a type and @a ret while subscribed */
+int _sound_manager_current_sound_type_get_cached(sound_type_e *type, int *ret);
+
+/*
+ * State kept by sound_manager_snapshot_create(). Each part is captured and
+ * re-applied by the translation unit which owns it; restoring only calls the
+ * sound server for what differs from the live state.
+ */
+typedef struct {
+	sound_manager_volume_changed_cb volume_cb;
+	void *volume_user_data;
+	volume_key_type_e key_type;
+	sound_volume_key_type_changed_cb key_type_cb;
+	void *key_type_user_data;
+	unsigned int volume_mask;
+	int volume[MAX_VOLUME_TYPE + 1];
+}_sound_manager_volume_state_s;
+
+void _sound_manager_volume_get_state(_sound_manager_volume_state_s *state);
+int _sound_manager_volume_restore_state(const _sound_manager_volume_state_s *state);
+
+#ifndef SOUND_MANAGER_DISABLE_ROUTE
+typedef struct {
+	sound_available_route_changed_cb route_cb;
+	void *route_user_data;
+	sound_available_route_diff_cb route_diff_cb;
+	void *route_diff_user_data;
+	sound_active_device_changed_cb device_cb;
+	void *device_user_data;
+	sound_active_device_diff_cb device_diff_cb;
+	void *device_diff_user_data;
+	int device_known;
+	sound_device_in_e in;
+	sound_device_out_e out;
+}_sound_manager_route_state_s;
+
+void _sound_manager_route_get_state(_sound_manager_route_state_s *state);
+/* Keeps the route and device notifications registered for the batched event callback */
+int _sound_manager_route_set_batched(int batched);
+int _sound_manager_route_restore_state(const _sound_manager_route_state_s *state);
+/* Returns the position of @a route in the policy order, -1 if it is not a sound_route_e value */
+int _sound_manager_route_policy_find(sound_route_e route);
+#endif
+
+#ifndef SOUND_MANAGER_DISABLE_SESSION
+/* Process level mm-session, (re)initialized only when the type actually changes */
+int _sound_manager_session_init(int session_type);
+/* Registers the default session unless the application already chose one */
+int _sound_manager_session_init_default(void);
+/* The session type last set by the application, shared by default */
+int _sound_manager_session_get_app_type(void);
+
+/* Ducking hook, returns non-zero if the interrupt was absorbed by ducking */
+int _sound_manager_ducking_session_notify(session_msg_t msg, session_event_t event);
+
+/* Focus manager hooks, called from the mm-session notify path */
+void _sound_manager_focus_session_notify(session_msg_t msg, session_event_t event);
+
+typedef struct {
+	int registered;
+	int session_type;
+	sound_session_notify_cb notify_cb;
+	void *notify_user_data;
+	sound_interrupted_cb interrupted_cb;
+	void *interrupted_user_data;
+	int call_mode_known;
+	sound_call_session_mode_e call_mode;
+}_sound_manager_session_state_s;
+
+void _sound_manager_session_get_state(_sound_manager_session_state_s *state);
+int _sound_manager_session_restore_state(const _sound_manager_session_state_s *state);
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __TIZEN_MEDIA_SOUND_MANAGER_PRIVATE_H__ */
@@ -49,6 +49,7 @@ rm -rf %{buildroot}
 
 %files devel
 %{_includedir}/media/sound_manager.h
+%{_includedir}/media/sound_manager.hpp
 %{_libdir}/pkgconfig/*.pc
 %{_libdir}/libcapi-media-sound-manager.so
 
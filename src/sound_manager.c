@@ -18,6 +18,7 @@
 #define LOG_TAG "TIZEN_N_SOUND_MANGER"
 
 #include <sound_manager.h>
+#include <sound_manager_private.h>
 #include <mm_sound.h>
 #include <mm_sound_private.h>
 #include <stdio.h>
@@ -25,11 +26,9 @@
 #include <string.h>
 #include <malloc.h>
 #include <unistd.h>
+#include <time.h>
+#include <pthread.h>
 #include <dlog.h>
-#include <mm_session.h>
-#include <mm_session_private.h>
-
-#define MAX_VOLUME_TYPE 5
 
 typedef struct {
 	void *user_data;
@@ -37,71 +36,165 @@ typedef struct {
 }_changed_volume_info_s;
 
 typedef struct {
-	int is_registered;
+	volume_key_type_e type;
 	void *user_data;
-	sound_session_notify_cb user_cb;
-	void *interrupted_user_data;
-	sound_interrupted_cb interrupted_cb;
-}_session_notify_info_s;
+	sound_volume_key_type_changed_cb user_cb;
+	unsigned int sequence;	/* of the last change */
+	unsigned int notified;	/* last change handed to the callback */
+	int notifying;
+}_volume_key_type_info_s;
 
 typedef struct {
-	void *user_data;
-	sound_available_route_changed_cb user_cb;
-}_changed_available_route_info_s;
-
-typedef struct {
-	void *user_data;
-	sound_active_device_changed_cb user_cb;
-}_changed_active_device_info_s;
+	int monitor_ref;
+	int user_monitor;
+	unsigned int valid_mask;
+	unsigned int max_valid_mask;
+	int volume[MAX_VOLUME_TYPE + 1];
+	int max[MAX_VOLUME_TYPE + 1];
+}_volume_cache_s;
 
 static _changed_volume_info_s g_volume_changed_cb_table;
-static _session_notify_info_s g_session_notify_cb_table = {0, NULL, NULL, NULL, NULL};
+static _volume_cache_s g_volume_cache;
+/* the primary volume type is kept per client by the sound server, so a new process starts without one */
+static _volume_key_type_info_s g_volume_key_type_info = {VOLUME_KEY_TYPE_NONE, NULL, NULL, 0, 0, 0};
+
+/*
+ * The callback tables are written by the application threads and read by the
+ * backend notification threads. Callbacks are copied out under the lock and
+ * invoked without it, so a callback may call back into the API.
+ */
+static pthread_mutex_t g_volume_cb_mutex = PTHREAD_MUTEX_INITIALIZER;
+/* guards g_volume_cache, the monitor refcount is only changed with g_volume_cb_mutex held as well */
+static pthread_mutex_t g_volume_cache_mutex = PTHREAD_MUTEX_INITIALIZER;
+/* serializes the primary volume type writes and guards g_volume_key_type_info */
+static pthread_mutex_t g_volume_key_type_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+/* Reads the volume from the sound server and keeps it while the change notification is registered */
+static int __volume_fetch(sound_type_e type, int *volume)
+{
+	unsigned int uvolume;
+	int ret = mm_sound_volume_get_value(type, &uvolume);
+
+	if(ret == 0){
+		*volume = uvolume;
+		pthread_mutex_lock(&g_volume_cache_mutex);
+		if(g_volume_cache.monitor_ref){
+			g_volume_cache.volume[type] = uvolume;
+			g_volume_cache.valid_mask |= (1 << type);
+		}
+		pthread_mutex_unlock(&g_volume_cache_mutex);
+	}
+	return ret;
+}
+
+static int __backend_get_volume(int type, int *values)
+{
+	return __volume_fetch(type, &values[0]);
+}
+
+static int __backend_get_current_sound_type(int arg, int *values)
+{
+	volume_type_t type = VOLUME_TYPE_SYSTEM;
+	int ret = mm_sound_volume_get_current_playing_type(&type);
+
+	values[0] = type;
+	return ret;
+}
+
+static int __backend_get_step(int type, int *values)
+{
+	return mm_sound_volume_get_step(type, &values[0]);
+}
+
+static int __backend_set_volume(int type, int *values)
+{
+	return mm_sound_volume_set_value(type, values[0]);
+}
+
+static int __backend_set_primary_type(int type, int *values)
+{
+	if(type == VOLUME_KEY_TYPE_NONE)
+		return mm_sound_volume_primary_type_clear();
+	return mm_sound_volume_primary_type_set(type);
+}
 
 static void __volume_changed_cb(void *user_data)
 {
 	sound_type_e type = (sound_type_e)user_data;
+	_changed_volume_info_s cb_info;
+	_sound_manager_event_s event;
+	int max = 0;
+
+	_sound_manager_event_receive(&event, SOUND_EVENT_VOLUME_CHANGED);
+	pthread_mutex_lock(&g_volume_cb_mutex);
+	cb_info = g_volume_changed_cb_table;
+	pthread_mutex_unlock(&g_volume_cb_mutex);
+
+	int new_volume = 0;
+	if(__volume_fetch(type, &new_volume) == 0){
+		_sound_manager_persist_volume(type, new_volume);
+		if(sound_manager_get_max_volume(type, &max) == SOUND_MANAGER_ERROR_NONE)
+			_sound_manager_stream_volume_type_changed(type, new_volume, max);
+	}
+	_sound_manager_event_batch_push(SOUND_EVENT_VOLUME_CHANGED, type, new_volume);
+	if(cb_info.user_cb){
+		_sound_manager_event_deliver_begin(&event);
+		(cb_info.user_cb)(type, new_volume, cb_info.user_data);
+		_sound_manager_event_deliver_end(&event);
+	}
+}
 
-	int new_volume;
-	sound_manager_get_volume(type, &new_volume);
-	if(g_volume_changed_cb_table.user_cb)
-		(g_volume_changed_cb_table.user_cb)(type, new_volume, g_volume_changed_cb_table.user_data);
+static void __volume_monitor_ref_locked(void)
+{
+	int i;
+	int ref;
+
+	pthread_mutex_lock(&g_volume_cache_mutex);
+	ref = g_volume_cache.monitor_ref++;
+	pthread_mutex_unlock(&g_volume_cache_mutex);
+	if(ref > 0)
+		return;
+
+	for(i = 0 ; i <= MAX_VOLUME_TYPE ; i++)
+	{
+		mm_sound_volume_add_callback(i , __volume_changed_cb ,(void*) i);
+	}
 }
 
-static void __session_notify_cb(session_msg_t msg, session_event_t event, void *user_data){
-	if(g_session_notify_cb_table.user_cb){
-		g_session_notify_cb_table.user_cb(msg, g_session_notify_cb_table.user_data);
+static void __volume_monitor_unref_locked(void)
+{
+	int i;
+
+	pthread_mutex_lock(&g_volume_cache_mutex);
+	if(g_volume_cache.monitor_ref == 0 || --g_volume_cache.monitor_ref > 0){
+		pthread_mutex_unlock(&g_volume_cache_mutex);
+		return;
 	}
-	if( g_session_notify_cb_table.interrupted_cb ){
-		sound_interrupted_code_e e = SOUND_INTERRUPTED_COMPLETED;
-		if( msg == MM_SESSION_MSG_RESUME )
-			e = SOUND_INTERRUPTED_COMPLETED;
-		else{
-			switch(event){
-				case MM_SESSION_EVENT_OTHER_APP :
-					e = SOUND_INTERRUPTED_BY_OTHER_APP;
-					break;
-				case MM_SESSION_EVENT_CALL :
-					e = SOUND_INTERRUPTED_BY_CALL;
-					break;
-				case MM_SESSION_EVENT_ALARM :
-					e = SOUND_INTERRUPTED_BY_ALARM;
-					break;
-				case MM_SESSION_EVENT_EARJACK_UNPLUG:
-					e = SOUND_INTERRUPTED_BY_EARJACK_UNPLUG;
-					break;
-				case MM_SESSION_EVENT_RESOURCE_CONFLICT:
-					e = SOUND_INTERRUPTED_BY_RESOURCE_CONFLICT;
-					break;
-				default :
-					e = SOUND_INTERRUPTED_BY_OTHER_APP;
-					break;
-			}
-		}
-		g_session_notify_cb_table.interrupted_cb(e, g_session_notify_cb_table.interrupted_user_data);
+	/* without notifications the cached levels can go stale */
+	g_volume_cache.valid_mask = 0;
+	pthread_mutex_unlock(&g_volume_cache_mutex);
+
+	for(i = 0 ; i <= MAX_VOLUME_TYPE ; i++)
+	{
+		mm_sound_volume_remove_callback(i);
 	}
 }
 
-static int __convert_sound_manager_error_code(const char *func, int code){
+void _sound_manager_volume_monitor_ref(void)
+{
+	pthread_mutex_lock(&g_volume_cb_mutex);
+	__volume_monitor_ref_locked();
+	pthread_mutex_unlock(&g_volume_cb_mutex);
+}
+
+void _sound_manager_volume_monitor_unref(void)
+{
+	pthread_mutex_lock(&g_volume_cb_mutex);
+	__volume_monitor_unref_locked();
+	pthread_mutex_unlock(&g_volume_cb_mutex);
+}
+
+int __convert_sound_manager_error_code(const char *func, int code){
 	int ret = SOUND_MANAGER_ERROR_NONE;
 	char *errorstr = NULL;
 
@@ -111,6 +204,26 @@ static int __convert_sound_manager_error_code(const char *func, int code){
 			ret = SOUND_MANAGER_ERROR_INVALID_PARAMETER;
 			errorstr = "INVALID_PARAMETER";
 			break;
+		case SOUND_MANAGER_ERROR_OUT_OF_MEMORY:
+			ret = SOUND_MANAGER_ERROR_OUT_OF_MEMORY;
+			errorstr = "OUT_OF_MEMORY";
+			break;
+		case SOUND_MANAGER_ERROR_INVALID_OPERATION:
+			ret = SOUND_MANAGER_ERROR_INVALID_OPERATION;
+			errorstr = "INVALID_OPERATION";
+			break;
+		case SOUND_MANAGER_ERROR_POLICY:
+			ret = SOUND_MANAGER_ERROR_POLICY;
+			errorstr = "POLICY";
+			break;
+		case SOUND_MANAGER_ERROR_STALE_VALUE:
+			ret = SOUND_MANAGER_ERROR_STALE_VALUE;
+			errorstr = "STALE_VALUE";
+			break;
+		case SOUND_MANAGER_ERROR_TIMED_OUT:
+			ret = SOUND_MANAGER_ERROR_TIMED_OUT;
+			errorstr = "TIMED_OUT";
+			break;
 		case MM_ERROR_NONE:
 			ret = SOUND_MANAGER_ERROR_NONE;
 			errorstr = "ERROR_NONE";
@@ -142,14 +255,47 @@ int sound_manager_get_max_volume(sound_type_e type, int *max)
 
 	if(type > MAX_VOLUME_TYPE || type < 0)
 		return __convert_sound_manager_error_code(__func__, SOUND_MANAGER_ERROR_INVALID_PARAMETER);
-	int ret = mm_sound_volume_get_step(type, &volume);
 
-	if(ret == 0)
+	/* the step count is fixed by the sound server configuration */
+	pthread_mutex_lock(&g_volume_cache_mutex);
+	if(g_volume_cache.max_valid_mask & (1 << type)){
+		*max = g_volume_cache.max[type];
+		pthread_mutex_unlock(&g_volume_cache_mutex);
+		return SOUND_MANAGER_ERROR_NONE;
+	}
+	pthread_mutex_unlock(&g_volume_cache_mutex);
+
+	int ret = _sound_manager_backend_request(__backend_get_step, type, &volume);
+
+	if(ret == 0){
 		*max = volume -1;	// actual volume step can be max step - 1
+		pthread_mutex_lock(&g_volume_cache_mutex);
+		g_volume_cache.max[type] = *max;
+		g_volume_cache.max_valid_mask |= (1 << type);
+		pthread_mutex_unlock(&g_volume_cache_mutex);
+	}
 
 	return __convert_sound_manager_error_code(__func__, ret);
 }
 
+int _sound_manager_volume_write(sound_type_e type, int volume)
+{
+	int values[2] = {volume, 0};
+	int ret = _sound_manager_backend_request(__backend_set_volume, type, values);
+	if(ret == 0){
+		_sound_manager_backend_update(type, values);
+		_sound_manager_persist_volume(type, volume);
+		pthread_mutex_lock(&g_volume_cache_mutex);
+		if(g_volume_cache.monitor_ref){
+			g_volume_cache.volume[type] = volume;
+			g_volume_cache.valid_mask |= (1 << type);
+		}
+		pthread_mutex_unlock(&g_volume_cache_mutex);
+	}
+
+	return ret;
+}
+
 int sound_manager_set_volume(sound_type_e type, int volume)
 {
 	if(type > MAX_VOLUME_TYPE || type < 0)
@@ -157,22 +303,40 @@ int sound_manager_set_volume(sound_type_e type, int volume)
 	if(volume < 0)
 		return __convert_sound_manager_error_code(__func__, SOUND_MANAGER_ERROR_INVALID_PARAMETER);
 
-	int ret = mm_sound_volume_set_value(type, volume);
+	int ret;
+	if(!_sound_manager_volume_coalesce(type, volume, &ret))
+		ret = _sound_manager_volume_write(type, volume);
 	
 	return __convert_sound_manager_error_code(__func__, ret);
 }
 
 int sound_manager_get_volume(sound_type_e type, int *volume)
 {
-	unsigned int uvolume;
 	if(type > MAX_VOLUME_TYPE || type < 0)
 		return __convert_sound_manager_error_code(__func__, SOUND_MANAGER_ERROR_INVALID_PARAMETER);
 	if(volume == NULL)
 		return __convert_sound_manager_error_code(__func__, SOUND_MANAGER_ERROR_INVALID_PARAMETER);
-	int ret = mm_sound_volume_get_value(type, &uvolume);
 
-	if(ret == 0)
-		*volume = uvolume;
+	/* a level waiting in the coalescer is newer than anything the sound server has */
+	if(_sound_manager_volume_coalesce_get_pending(type, volume))
+		return SOUND_MANAGER_ERROR_NONE;
+
+	/* while the change notification is registered the cached level is current */
+	pthread_mutex_lock(&g_volume_cache_mutex);
+	if(g_volume_cache.valid_mask & (1 << type)){
+		*volume = g_volume_cache.volume[type];
+		pthread_mutex_unlock(&g_volume_cache_mutex);
+		return SOUND_MANAGER_ERROR_NONE;
+	}
+	pthread_mutex_unlock(&g_volume_cache_mutex);
+
+	int values[2];
+	int stale;
+	int ret = _sound_manager_backend_call(type, __backend_get_volume, type, values, &stale);
+	if(ret == MM_ERROR_NONE)
+		*volume = values[0];
+	if(stale)
+		ret = SOUND_MANAGER_ERROR_STALE_VALUE;
 
 	return __convert_sound_manager_error_code(__func__, ret);
 }
@@ -182,7 +346,15 @@ int sound_manager_get_current_sound_type(sound_type_e *type)
 	if(type == NULL)
 		return __convert_sound_manager_error_code(__func__, SOUND_MANAGER_ERROR_INVALID_PARAMETER);
 	int ret;
-	ret = mm_sound_volume_get_current_playing_type((volume_type_t *)type);
+	if(_sound_manager_current_sound_type_get_cached(type, &ret))
+		return __convert_sound_manager_error_code(__func__, ret);
+	int values[2];
+	int stale;
+	ret = _sound_manager_backend_call(SOUND_MANAGER_BACKEND_SLOT_CURRENT_SOUND_TYPE, __backend_get_current_sound_type, 0, values, &stale);
+	if(ret == MM_ERROR_NONE)
+		*type = values[0];
+	if(stale)
+		ret = SOUND_MANAGER_ERROR_STALE_VALUE;
 	
 	return __convert_sound_manager_error_code(__func__, ret);
 }
@@ -191,274 +363,188 @@ int sound_manager_set_volume_changed_cb(sound_manager_volume_changed_cb callback
 {
 	if(callback == NULL)
 		return __convert_sound_manager_error_code(__func__, SOUND_MANAGER_ERROR_INVALID_PARAMETER);
-	int i;
+	pthread_mutex_lock(&g_volume_cb_mutex);
 	g_volume_changed_cb_table.user_cb = callback;
 	g_volume_changed_cb_table.user_data = user_data;
-	for(i = 0 ; i <= MAX_VOLUME_TYPE ; i++)
-	{
-		mm_sound_volume_add_callback(i , __volume_changed_cb ,(void*) i);
+	if(!g_volume_cache.user_monitor){
+		g_volume_cache.user_monitor = 1;
+		__volume_monitor_ref_locked();
 	}
+	pthread_mutex_unlock(&g_volume_cb_mutex);
 	return 0;
 }
 
 void sound_manager_unset_volume_changed_cb(void)
 {
-	int i;
-	for(i = 0 ; i <= MAX_VOLUME_TYPE ; i++)
-	{
-		mm_sound_volume_remove_callback(i);
+	pthread_mutex_lock(&g_volume_cb_mutex);
+	if(g_volume_cache.user_monitor){
+		g_volume_cache.user_monitor = 0;
+		__volume_monitor_unref_locked();
 	}
 	g_volume_changed_cb_table.user_cb = NULL;
 	g_volume_changed_cb_table.user_data = NULL;	
+	pthread_mutex_unlock(&g_volume_cb_mutex);
 }
 
-int sound_manager_get_a2dp_status(bool *connected , char** bt_name){
-	int ret = mm_sound_route_get_a2dp_status((int*)connected , bt_name);
+unsigned long long _sound_manager_get_time_us(void)
+{
+	struct timespec ts;
 
-	return __convert_sound_manager_error_code(__func__, ret);
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (unsigned long long)ts.tv_sec * 1000000ULL + ts.tv_nsec / 1000;
 }
 
-int sound_manager_set_session_type(sound_session_type_e type){
-	int ret = 0;
-	if(type < 0 || type >  SOUND_SESSION_TYPE_EXCLUSIVE)
-		return __convert_sound_manager_error_code(__func__, SOUND_MANAGER_ERROR_INVALID_PARAMETER);
-
-	if(g_session_notify_cb_table.is_registered){
-		mm_session_finish();
-		g_session_notify_cb_table.is_registered = 0;
-	}
+/*
+ * Called with g_volume_key_type_mutex held, returns with it released.
+ * One thread at a time invokes the callback and the others leave their change
+ * to it, so the callback sees the changes in order and ends with the last one.
+ */
+static void __volume_key_type_notify_unlock(void)
+{
+	volume_key_type_e type;
+	sound_volume_key_type_changed_cb user_cb;
+	void *user_data;
 
-	ret = mm_session_init_ex(type , __session_notify_cb, NULL);
-	if(ret == 0){
-		g_session_notify_cb_table.is_registered = 1;
+	if(g_volume_key_type_info.notifying){
+		pthread_mutex_unlock(&g_volume_key_type_mutex);
+		return;
 	}
-	return __convert_sound_manager_error_code(__func__, ret);
-}
 
-int sound_manager_set_session_notify_cb(sound_session_notify_cb callback , void *user_data){
-	int ret =0 ;
-	if(callback == NULL)
-		return __convert_sound_manager_error_code(__func__, SOUND_MANAGER_ERROR_INVALID_PARAMETER);
+	g_volume_key_type_info.notifying = 1;
+	while(g_volume_key_type_info.notified != g_volume_key_type_info.sequence){
+		g_volume_key_type_info.notified = g_volume_key_type_info.sequence;
+		type = g_volume_key_type_info.type;
+		user_cb = g_volume_key_type_info.user_cb;
+		user_data = g_volume_key_type_info.user_data;
+		pthread_mutex_unlock(&g_volume_key_type_mutex);
 
+		if(user_cb)
+			user_cb(type, user_data);
 
-	if(g_session_notify_cb_table.is_registered ==0){
-		ret = mm_session_init_ex(SOUND_SESSION_TYPE_SHARE /*default*/ , __session_notify_cb, NULL);
-		if(ret != 0)
-			return __convert_sound_manager_error_code(__func__, ret);
-		g_session_notify_cb_table.is_registered = 1;
+		pthread_mutex_lock(&g_volume_key_type_mutex);
 	}
-
-	g_session_notify_cb_table.user_cb = callback;
-	g_session_notify_cb_table.user_data  = user_data;
-	return SOUND_MANAGER_ERROR_NONE;
-}
-
-void sound_manager_unset_session_notify_cb(void){
-	g_session_notify_cb_table.user_cb = NULL;
-	g_session_notify_cb_table.user_data  = NULL;
+	g_volume_key_type_info.notifying = 0;
+	pthread_mutex_unlock(&g_volume_key_type_mutex);
 }
 
-int sound_manager_set_interrupted_cb(sound_interrupted_cb callback, void *user_data){
-	int ret =0 ;
-	if(callback == NULL)
-		return __convert_sound_manager_error_code(__func__, SOUND_MANAGER_ERROR_INVALID_PARAMETER);
-
-	if(g_session_notify_cb_table.is_registered ==0){
-		ret = mm_session_init_ex(SOUND_SESSION_TYPE_SHARE /*default*/ , __session_notify_cb, NULL);
-		if(ret != 0)
-			return __convert_sound_manager_error_code(__func__, ret);
-		g_session_notify_cb_table.is_registered = 1;
+static int __volume_key_type_set(volume_key_type_e type, int notify)
+{
+	int ret = MM_ERROR_NONE;
+
+	pthread_mutex_lock(&g_volume_key_type_mutex);
+	if(type != g_volume_key_type_info.type){
+		ret = _sound_manager_backend_request(__backend_set_primary_type, type, NULL);
+		if(ret == MM_ERROR_NONE){
+			g_volume_key_type_info.type = type;
+			g_volume_key_type_info.sequence++;
+			_sound_manager_persist_key_type(type);
+			if(!notify)
+				g_volume_key_type_info.notified = g_volume_key_type_info.sequence;
+		}
 	}
+	__volume_key_type_notify_unlock();
 
-	g_session_notify_cb_table.interrupted_cb= callback;
-	g_session_notify_cb_table.interrupted_user_data = user_data;
-	return SOUND_MANAGER_ERROR_NONE;
-}
-
-void sound_manager_unset_interrupted_cb(void){
-	g_session_notify_cb_table.interrupted_cb= NULL;
-	g_session_notify_cb_table.interrupted_user_data = NULL;
+	return ret;
 }
 
-
 int sound_manager_set_volume_key_type(volume_key_type_e type){
 	if(type < VOLUME_KEY_TYPE_NONE || type > VOLUME_KEY_TYPE_CALL)
 		return __convert_sound_manager_error_code(__func__, SOUND_MANAGER_ERROR_INVALID_PARAMETER);
-	int ret;
-	if(type == VOLUME_KEY_TYPE_NONE)
-		ret = mm_sound_volume_primary_type_clear();
-	else
-		ret = mm_sound_volume_primary_type_set(type);
 
-	return __convert_sound_manager_error_code(__func__, ret);
+	return __convert_sound_manager_error_code(__func__, __volume_key_type_set(type, 1));
 }
 
-int sound_manager_foreach_available_route (sound_available_route_cb callback, void *user_data)
+int sound_manager_get_volume_key_type(volume_key_type_e *type)
 {
-	int ret;
-	ret = mm_sound_foreach_available_route_cb((mm_sound_available_route_cb)callback, user_data);
-
-	return __convert_sound_manager_error_code(__func__, ret);
-}
-
-int sound_manager_set_active_route (sound_route_e route)
-{
-	int ret;
-	ret = mm_sound_set_active_route(route);
-
-	return __convert_sound_manager_error_code(__func__, ret);
-}
-
-int sound_manager_get_active_device (sound_device_in_e *in, sound_device_out_e *out)
-{
-	int ret;
-	ret = mm_sound_get_active_device((mm_sound_device_in *)in, (mm_sound_device_out *)out);
-
-	return __convert_sound_manager_error_code(__func__, ret);
-}
-
-bool sound_manager_is_route_available (sound_route_e route)
-{
-	bool is_available;
-	mm_sound_is_route_available(route, &is_available);
-
-	return is_available;
-}
+	if(type == NULL)
+		return __convert_sound_manager_error_code(__func__, SOUND_MANAGER_ERROR_INVALID_PARAMETER);
 
-int sound_manager_set_available_route_changed_cb (sound_available_route_changed_cb callback, void *user_data)
-{
-	int ret;
-	ret = mm_sound_add_available_route_changed_callback((mm_sound_available_route_changed_cb)callback, user_data);
+	pthread_mutex_lock(&g_volume_key_type_mutex);
+	*type = g_volume_key_type_info.type;
+	pthread_mutex_unlock(&g_volume_key_type_mutex);
 
-	return __convert_sound_manager_error_code(__func__, ret);
+	return SOUND_MANAGER_ERROR_NONE;
 }
 
-void sound_manager_unset_available_route_changed_cb (void)
+int sound_manager_set_volume_key_type_changed_cb(sound_volume_key_type_changed_cb callback, void *user_data)
 {
-	mm_sound_remove_available_route_changed_callback();
-}
+	if(callback == NULL)
+		return __convert_sound_manager_error_code(__func__, SOUND_MANAGER_ERROR_INVALID_PARAMETER);
 
-int sound_manager_set_active_device_changed_cb (sound_active_device_changed_cb callback, void *user_data)
-{
-	int ret;
-	ret = mm_sound_add_active_device_changed_callback((mm_sound_active_device_changed_cb)callback, user_data);
+	pthread_mutex_lock(&g_volume_key_type_mutex);
+	g_volume_key_type_info.user_cb = callback;
+	g_volume_key_type_info.user_data = user_data;
+	pthread_mutex_unlock(&g_volume_key_type_mutex);
 
-	return __convert_sound_manager_error_code(__func__, ret);
+	return SOUND_MANAGER_ERROR_NONE;
 }
 
-void sound_manager_unset_active_device_changed_cb (void)
+void sound_manager_unset_volume_key_type_changed_cb(void)
 {
-	mm_sound_remove_active_device_changed_callback();
+	pthread_mutex_lock(&g_volume_key_type_mutex);
+	g_volume_key_type_info.user_cb = NULL;
+	g_volume_key_type_info.user_data = NULL;
+	pthread_mutex_unlock(&g_volume_key_type_mutex);
 }
 
-struct sound_call_session_s
-{
-	int unused;
-};
-
-int sound_manager_call_session_create(sound_call_session_type_e type, sound_call_session_h *session)
+void _sound_manager_volume_seed(sound_type_e type, int volume)
 {
-	int ret = SOUND_MANAGER_ERROR_NONE;
-	sound_call_session_h handle = NULL;
-
-	if(type < SOUND_SESSION_TYPE_CALL || type > SOUND_SESSION_TYPE_VOIP || session == NULL) {
-		ret = SOUND_MANAGER_ERROR_INVALID_PARAMETER;
-		goto ERROR;
-	}
-
-    handle = malloc(sizeof(struct sound_call_session_s));
-
-	if(!handle) {
-		ret = SOUND_MANAGER_ERROR_INVALID_OPERATION;
-		goto ERROR;
-	}
+	int values[2] = {volume, 0};
 
-    memset(handle, 0, sizeof(struct sound_call_session_s));
-
-	switch(type) {
-	case SOUND_SESSION_TYPE_CALL:
-		ret = mm_session_init(MM_SESSION_TYPE_CALL);
-		break;
-	case SOUND_SESSION_TYPE_VOIP:
-		ret = mm_session_init(MM_SESSION_TYPE_VIDEOCALL);
-		break;
-	}
-
-	if(ret != MM_ERROR_NONE)
-		goto ERROR;
-
-	*session = handle;
-
-	return SOUND_MANAGER_ERROR_NONE;
-
-ERROR:
-	if(handle)
-		free(handle);
-
-	return __convert_sound_manager_error_code(__func__, ret);
+	/* the levels belong to the system, so they are only kept as the last known ones */
+	_sound_manager_backend_seed(type, values);
 }
 
-int sound_manager_call_session_set_mode(sound_call_session_h session, sound_call_session_mode_e mode)
+void _sound_manager_volume_get_state(_sound_manager_volume_state_s *state)
 {
-	int ret = SOUND_MANAGER_ERROR_NONE;
-
-	if(mode < SOUND_CALL_SESSION_MODE_VOICE || mode > SOUND_CALL_SESSION_MODE_MEDIA || session == NULL) {
-		ret = SOUND_MANAGER_ERROR_INVALID_PARAMETER;
-		goto ERROR;
-	}
-
-	ret = mm_session_set_subsession ((mm_subsession_t)mode);
-
-	if(ret != MM_ERROR_NONE)
-		goto ERROR;
-
-	return SOUND_MANAGER_ERROR_NONE;
-
-ERROR:
-	return __convert_sound_manager_error_code(__func__, ret);
+	pthread_mutex_lock(&g_volume_cb_mutex);
+	state->volume_cb = g_volume_changed_cb_table.user_cb;
+	state->volume_user_data = g_volume_changed_cb_table.user_data;
+	pthread_mutex_unlock(&g_volume_cb_mutex);
+
+	pthread_mutex_lock(&g_volume_cache_mutex);
+	state->volume_mask = g_volume_cache.valid_mask;
+	memcpy(state->volume, g_volume_cache.volume, sizeof(state->volume));
+	pthread_mutex_unlock(&g_volume_cache_mutex);
+
+	pthread_mutex_lock(&g_volume_key_type_mutex);
+	state->key_type = g_volume_key_type_info.type;
+	state->key_type_cb = g_volume_key_type_info.user_cb;
+	state->key_type_user_data = g_volume_key_type_info.user_data;
+	pthread_mutex_unlock(&g_volume_key_type_mutex);
 }
 
-int  sound_manager_call_session_get_mode(sound_call_session_h session, sound_call_session_mode_e *mode)
+int _sound_manager_volume_restore_state(const _sound_manager_volume_state_s *state)
 {
+	_changed_volume_info_s live;
 	int ret = SOUND_MANAGER_ERROR_NONE;
-
-	if(mode == NULL || session == NULL) {
-		ret = SOUND_MANAGER_ERROR_INVALID_PARAMETER;
-		goto ERROR;
+	int key_type_ret;
+	int type;
+
+	pthread_mutex_lock(&g_volume_cb_mutex);
+	live = g_volume_changed_cb_table;
+	pthread_mutex_unlock(&g_volume_cb_mutex);
+	if(live.user_cb != state->volume_cb || live.user_data != state->volume_user_data){
+		if(state->volume_cb)
+			ret = sound_manager_set_volume_changed_cb(state->volume_cb, state->volume_user_data);
+		else
+			sound_manager_unset_volume_changed_cb();
 	}
 
-	ret = mm_session_get_subsession ((mm_subsession_t *)mode);
-
-	if(ret != MM_ERROR_NONE)
-		goto ERROR;
-
-	return SOUND_MANAGER_ERROR_NONE;
-
-ERROR:
-	return __convert_sound_manager_error_code(__func__, ret);
-}
-
-int sound_manager_call_session_destroy(sound_call_session_h session)
-{
-	int ret = SOUND_MANAGER_ERROR_NONE;
-	sound_call_session_h *handle = (sound_call_session_h *)session;
-
-	if(session == NULL) {
-		ret = SOUND_MANAGER_ERROR_INVALID_PARAMETER;
-		goto ERROR;
+	for(type = 0 ; type <= MAX_VOLUME_TYPE ; type++)
+	{
+		if(state->volume_mask & (1 << type))
+			_sound_manager_volume_seed(type, state->volume[type]);
 	}
 
-	ret = mm_session_finish();
-
-	if(ret != MM_ERROR_NONE)
-		goto ERROR;
+	pthread_mutex_lock(&g_volume_key_type_mutex);
+	g_volume_key_type_info.user_cb = state->key_type_cb;
+	g_volume_key_type_info.user_data = state->key_type_user_data;
+	pthread_mutex_unlock(&g_volume_key_type_mutex);
+	/* bringing back a known state is not a change the application made */
+	key_type_ret = __volume_key_type_set(state->key_type, 0);
+	if(ret == SOUND_MANAGER_ERROR_NONE)
+		ret = __convert_sound_manager_error_code(__func__, key_type_ret);
 
-	if(handle)
-		free(handle);
-
-	return SOUND_MANAGER_ERROR_NONE;
-
-ERROR:
-	return __convert_sound_manager_error_code(__func__, ret);
+	return ret;
 }
-
@@ -0,0 +1,593 @@
+/*
+* Copyright (c) 2011 Samsung Electronics Co., Ltd All Rights Reserved
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+
+#define LOG_TAG "TIZEN_N_SOUND_MANGER"
+
+#include <sound_manager.h>
+#include <sound_manager_private.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <malloc.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <dlog.h>
+#include <mm_error.h>
+
+/*
+ * Backend calls with a deadline
+ *
+ * Each getter owns a slot holding its last known value. Without a deadline the
+ * call runs in the caller's thread. With a deadline the call is handed to the
+ * backend worker and the caller waits at most the deadline; when it expires the
+ * last known value is returned as stale and the worker keeps going to refresh
+ * the slot. A slot has at most one call in flight, so a stuck sound server does
+ * not pile up requests.
+ */
+typedef struct {
+	_sound_manager_backend_fn func;
+	int arg;
+	int in_flight;
+	unsigned int generation;	/* bumped whenever a call completes */
+	int ret;
+	int values[2];
+	int known;
+	int last_values[2];
+}_backend_slot_s;
+
+typedef struct {
+	pthread_mutex_t lock;
+	pthread_cond_t work_cond;
+	pthread_cond_t done_cond;
+	int thread_started;
+	unsigned int deadline_ms;
+	unsigned int pending_mask;
+	_backend_slot_s slot[SOUND_MANAGER_BACKEND_SLOT_NUM];
+}_backend_info_s;
+
+/*
+ * Retry policy and circuit breaker
+ *
+ * MM_ERROR_SOUND_INTERNAL is what the client library returns while the sound
+ * server restarts or is overloaded. With a policy set, such a request is retried
+ * with exponential backoff and jitter so the clients of a busy server do not
+ * retry in step. Once failure_threshold requests in a row failed every attempt
+ * the circuit opens: requests fail at once and the getters return their last
+ * known value until cool_down_ms have passed. Then a single request probes the
+ * sound server, closing the circuit on success and opening it again otherwise.
+ */
+typedef struct {
+	pthread_mutex_t lock;
+	int enabled;	/* read without the lock on the fast path */
+	sound_backend_retry_policy_s policy;
+	sound_backend_circuit_state_e state;
+	unsigned long long open_until_us;
+	int probing;
+	unsigned int consecutive_failures;
+	sound_backend_retry_stats_s stats;
+}_backend_retry_s;
+
+static _backend_info_s g_backend_info = {PTHREAD_MUTEX_INITIALIZER, PTHREAD_COND_INITIALIZER, PTHREAD_COND_INITIALIZER, };
+/* updated with atomics so the uncontended path does not take a lock */
+static _sound_manager_latency_s g_backend_latency;
+static unsigned int g_backend_deadline_missed;
+static _backend_retry_s g_backend_retry = {PTHREAD_MUTEX_INITIALIZER, };
+
+static int __retry_admit(sound_backend_retry_policy_s *policy, int *probe)
+{
+	int ret = 0;
+
+	*probe = 0;
+	pthread_mutex_lock(&g_backend_retry.lock);
+	*policy = g_backend_retry.policy;
+	g_backend_retry.stats.requests++;
+	if(g_backend_retry.state == SOUND_BACKEND_CIRCUIT_OPEN && _sound_manager_get_time_us() >= g_backend_retry.open_until_us)
+		g_backend_retry.state = SOUND_BACKEND_CIRCUIT_HALF_OPEN;
+	if(g_backend_retry.state == SOUND_BACKEND_CIRCUIT_HALF_OPEN && !g_backend_retry.probing){
+		g_backend_retry.probing = 1;
+		*probe = 1;
+	}else if(g_backend_retry.state != SOUND_BACKEND_CIRCUIT_CLOSED){
+		g_backend_retry.stats.rejected++;
+		ret = -1;
+	}
+	pthread_mutex_unlock(&g_backend_retry.lock);
+
+	return ret;
+}
+
+/* counts the retry, unless another request opened the circuit meanwhile */
+static int __retry_continue(void)
+{
+	int ret = 0;
+
+	pthread_mutex_lock(&g_backend_retry.lock);
+	if(g_backend_retry.state == SOUND_BACKEND_CIRCUIT_CLOSED){
+		g_backend_retry.stats.retries++;
+		ret = 1;
+	}
+	pthread_mutex_unlock(&g_backend_retry.lock);
+
+	return ret;
+}
+
+static void __retry_complete(int ret, int probe)
+{
+	pthread_mutex_lock(&g_backend_retry.lock);
+	if(probe)
+		g_backend_retry.probing = 0;
+	if(ret != MM_ERROR_SOUND_INTERNAL){
+		g_backend_retry.consecutive_failures = 0;
+		if(probe && g_backend_retry.state == SOUND_BACKEND_CIRCUIT_HALF_OPEN){
+			g_backend_retry.state = SOUND_BACKEND_CIRCUIT_CLOSED;
+			LOGI("[%s] sound server is back, circuit closed", __func__);
+		}
+	}else{
+		g_backend_retry.stats.failures++;
+		g_backend_retry.consecutive_failures++;
+		if((probe && g_backend_retry.state == SOUND_BACKEND_CIRCUIT_HALF_OPEN)
+			|| (g_backend_retry.state == SOUND_BACKEND_CIRCUIT_CLOSED && g_backend_retry.policy.failure_threshold
+				&& g_backend_retry.consecutive_failures >= g_backend_retry.policy.failure_threshold)){
+			g_backend_retry.state = SOUND_BACKEND_CIRCUIT_OPEN;
+			g_backend_retry.open_until_us = _sound_manager_get_time_us() + g_backend_retry.policy.cool_down_ms * 1000ULL;
+			g_backend_retry.stats.opened++;
+			LOGE("[%s] %u failed requests in a row, circuit open for %u ms", __func__,
+				g_backend_retry.consecutive_failures, g_backend_retry.policy.cool_down_ms);
+		}
+	}
+	pthread_mutex_unlock(&g_backend_retry.lock);
+}
+
+/* non-zero while a request would be rejected */
+static int __retry_is_open(void)
+{
+	int open;
+
+	if(!__sync_fetch_and_add(&g_backend_retry.enabled, 0))
+		return 0;
+
+	pthread_mutex_lock(&g_backend_retry.lock);
+	open = (g_backend_retry.state == SOUND_BACKEND_CIRCUIT_OPEN && _sound_manager_get_time_us() < g_backend_retry.open_until_us)
+		|| (g_backend_retry.state == SOUND_BACKEND_CIRCUIT_HALF_OPEN && g_backend_retry.probing);
+	if(open)
+		g_backend_retry.stats.cached++;
+	pthread_mutex_unlock(&g_backend_retry.lock);
+
+	return open;
+}
+
+/* exponential backoff with equal jitter, between half and all of the capped delay */
+static unsigned int __retry_delay_ms(const sound_backend_retry_policy_s *policy, unsigned int attempt, unsigned int *seed)
+{
+	unsigned int delay = policy->max_delay_ms;
+
+	if(attempt < 32 && policy->base_delay_ms <= (policy->max_delay_ms >> attempt))
+		delay = policy->base_delay_ms << attempt;
+	return delay / 2 + rand_r(seed) % (delay - delay / 2 + 1);
+}
+
+int _sound_manager_backend_request(_sound_manager_backend_fn func, int arg, int *values)
+{
+	sound_backend_retry_policy_s policy;
+	unsigned int attempt;
+	unsigned int seed;
+	int probe;
+	int ret;
+
+	if(!__sync_fetch_and_add(&g_backend_retry.enabled, 0))
+		return func(arg, values);
+	if(__retry_admit(&policy, &probe) != 0)
+		return MM_ERROR_SOUND_INTERNAL;
+
+	seed = (unsigned int)_sound_manager_get_time_us() ^ (unsigned int)pthread_self();
+	ret = func(arg, values);
+	/* a probe gets a single attempt, it only decides whether the circuit closes */
+	for(attempt = 0 ; ret == MM_ERROR_SOUND_INTERNAL && !probe && attempt < policy.max_retries ; attempt++)
+	{
+		usleep(__retry_delay_ms(&policy, attempt, &seed) * 1000);
+		if(!__retry_continue())
+			break;
+		ret = func(arg, values);
+	}
+	__retry_complete(ret, probe);
+
+	return ret;
+}
+
+/* log2 buckets split in 2^SOUND_MANAGER_LATENCY_SUB_BUCKET_BITS linear steps, about 25% resolution */
+static int __latency_bucket(unsigned int us)
+{
+	int msb = 31 - __builtin_clz(us | 1);
+
+	if(msb < SOUND_MANAGER_LATENCY_SUB_BUCKET_BITS)
+		return us;
+	return ((msb - SOUND_MANAGER_LATENCY_SUB_BUCKET_BITS + 1) << SOUND_MANAGER_LATENCY_SUB_BUCKET_BITS)
+		+ ((us >> (msb - SOUND_MANAGER_LATENCY_SUB_BUCKET_BITS)) & ((1 << SOUND_MANAGER_LATENCY_SUB_BUCKET_BITS) - 1));
+}
+
+/* upper bound of a bucket */
+static unsigned int __latency_bucket_limit(int bucket)
+{
+	int shift = (bucket >> SOUND_MANAGER_LATENCY_SUB_BUCKET_BITS) - 1;
+	unsigned long long sub = bucket & ((1 << SOUND_MANAGER_LATENCY_SUB_BUCKET_BITS) - 1);
+
+	if(shift < 0)
+		return bucket;
+	sub |= 1 << SOUND_MANAGER_LATENCY_SUB_BUCKET_BITS;
+	if(((sub + 1) << shift) - 1 > 0xffffffffULL)
+		return 0xffffffff;
+	return ((sub + 1) << shift) - 1;
+}
+
+void _sound_manager_latency_record(_sound_manager_latency_s *latency, unsigned long long elapsed_us)
+{
+	unsigned int us = elapsed_us > 0xffffffffULL ? 0xffffffff : elapsed_us;
+	unsigned int max;
+
+	__sync_fetch_and_add(&latency->bucket[__latency_bucket(us)], 1);
+	__sync_fetch_and_add(&latency->count, 1);
+	max = __sync_fetch_and_add(&latency->max_us, 0);
+	while(us > max && !__sync_bool_compare_and_swap(&latency->max_us, max, us))
+		max = __sync_fetch_and_add(&latency->max_us, 0);
+}
+
+void _sound_manager_latency_get(_sound_manager_latency_s *latency, unsigned int *count,
+	unsigned int *p50_us, unsigned int *p99_us, unsigned int *p999_us, unsigned int *max_us)
+{
+	unsigned int bucket[SOUND_MANAGER_LATENCY_BUCKET_NUM];
+	unsigned long long total = 0;
+	unsigned long long seen = 0;
+	unsigned long long p50;
+	unsigned long long p99;
+	unsigned long long p999;
+	int i;
+
+	for(i = 0 ; i < SOUND_MANAGER_LATENCY_BUCKET_NUM ; i++)
+	{
+		bucket[i] = __sync_fetch_and_add(&latency->bucket[i], 0);
+		total += bucket[i];
+	}
+	*count = __sync_fetch_and_add(&latency->count, 0);
+	*max_us = __sync_fetch_and_add(&latency->max_us, 0);
+	*p50_us = *p99_us = *p999_us = 0;
+	if(total == 0)
+		return;
+
+	/* nearest rank, reported as the upper bound of the bucket */
+	p50 = (total * 50 + 99) / 100;
+	p99 = (total * 99 + 99) / 100;
+	p999 = (total * 999 + 999) / 1000;
+	for(i = 0 ; i < SOUND_MANAGER_LATENCY_BUCKET_NUM && seen < p999 ; i++)
+	{
+		if(bucket[i] == 0)
+			continue;
+		if(seen < p50 && seen + bucket[i] >= p50)
+			*p50_us = __latency_bucket_limit(i);
+		if(seen < p99 && seen + bucket[i] >= p99)
+			*p99_us = __latency_bucket_limit(i);
+		if(seen + bucket[i] >= p999)
+			*p999_us = __latency_bucket_limit(i);
+		seen += bucket[i];
+	}
+	if(*p999_us > *max_us)
+		*p999_us = *max_us;
+	if(*p99_us > *max_us)
+		*p99_us = *max_us;
+	if(*p50_us > *max_us)
+		*p50_us = *max_us;
+}
+
+void _sound_manager_latency_reset(_sound_manager_latency_s *latency)
+{
+	int i;
+
+	for(i = 0 ; i < SOUND_MANAGER_LATENCY_BUCKET_NUM ; i++)
+		__sync_lock_test_and_set(&latency->bucket[i], 0);
+	__sync_lock_test_and_set(&latency->count, 0);
+	__sync_lock_test_and_set(&latency->max_us, 0);
+}
+
+static void __slot_complete_locked(_backend_slot_s *slot, int ret, const int *values)
+{
+	slot->ret = ret;
+	slot->values[0] = values[0];
+	slot->values[1] = values[1];
+	if(ret == MM_ERROR_NONE){
+		slot->known = 1;
+		slot->last_values[0] = values[0];
+		slot->last_values[1] = values[1];
+	}
+	slot->generation++;
+}
+
+static void *__backend_thread(void *data)
+{
+	_backend_slot_s *slot;
+	_sound_manager_backend_fn func;
+	unsigned long long start;
+	int values[2];
+	int index;
+	int arg;
+	int ret;
+
+	pthread_mutex_lock(&g_backend_info.lock);
+	while(1){
+		if(g_backend_info.pending_mask == 0){
+			pthread_cond_wait(&g_backend_info.work_cond, &g_backend_info.lock);
+			continue;
+		}
+
+		index = __builtin_ctz(g_backend_info.pending_mask);
+		g_backend_info.pending_mask &= ~(1 << index);
+		slot = &g_backend_info.slot[index];
+		func = slot->func;
+		arg = slot->arg;
+		pthread_mutex_unlock(&g_backend_info.lock);
+
+		values[0] = values[1] = 0;
+		start = _sound_manager_get_time_us();
+		ret = _sound_manager_backend_request(func, arg, values);
+		_sound_manager_latency_record(&g_backend_latency, _sound_manager_get_time_us() - start);
+
+		pthread_mutex_lock(&g_backend_info.lock);
+		__slot_complete_locked(slot, ret, values);
+		slot->in_flight = 0;
+		pthread_cond_broadcast(&g_backend_info.done_cond);
+	}
+
+	return NULL;
+}
+
+static int __backend_start_locked(void)
+{
+	pthread_condattr_t attr;
+	pthread_attr_t thread_attr;
+	pthread_t thread;
+	int ret;
+
+	if(g_backend_info.thread_started)
+		return 0;
+
+	pthread_condattr_init(&attr);
+	pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+	pthread_cond_destroy(&g_backend_info.done_cond);
+	pthread_cond_init(&g_backend_info.done_cond, &attr);
+	pthread_condattr_destroy(&attr);
+
+	pthread_attr_init(&thread_attr);
+	pthread_attr_setdetachstate(&thread_attr, PTHREAD_CREATE_DETACHED);
+	ret = pthread_create(&thread, &thread_attr, __backend_thread, NULL);
+	pthread_attr_destroy(&thread_attr);
+	if(ret != 0){
+		LOGE("[%s] failed to create the backend thread (%d)", __func__, ret);
+		return -1;
+	}
+
+	g_backend_info.thread_started = 1;
+	return 0;
+}
+
+static void __backend_deadline_to_timespec(unsigned int deadline_ms, struct timespec *ts)
+{
+	/* done_cond runs on the monotonic clock, see __backend_start_locked() */
+	clock_gettime(CLOCK_MONOTONIC, ts);
+	ts->tv_sec += deadline_ms / 1000;
+	ts->tv_nsec += (long)(deadline_ms % 1000) * 1000000;
+	if(ts->tv_nsec >= 1000000000){
+		ts->tv_sec++;
+		ts->tv_nsec -= 1000000000;
+	}
+}
+
+int _sound_manager_backend_call(int index, _sound_manager_backend_fn func, int arg, int *values, int *stale)
+{
+	_backend_slot_s *slot = &g_backend_info.slot[index];
+	unsigned long long start;
+	unsigned int generation;
+	struct timespec ts;
+	int result[2] = {0, 0};
+	int missed;
+	int ret;
+
+	*stale = 0;
+
+	/* the sound server is failing, do not add to its load */
+	if(__retry_is_open()){
+		pthread_mutex_lock(&g_backend_info.lock);
+		if(slot->known){
+			values[0] = slot->last_values[0];
+			values[1] = slot->last_values[1];
+			*stale = 1;
+			ret = MM_ERROR_NONE;
+		}else{
+			ret = MM_ERROR_SOUND_INTERNAL;
+		}
+		pthread_mutex_unlock(&g_backend_info.lock);
+		return ret;
+	}
+
+	pthread_mutex_lock(&g_backend_info.lock);
+	if(g_backend_info.deadline_ms == 0 || __backend_start_locked() != 0){
+		pthread_mutex_unlock(&g_backend_info.lock);
+
+		start = _sound_manager_get_time_us();
+		ret = _sound_manager_backend_request(func, arg, result);
+		_sound_manager_latency_record(&g_backend_latency, _sound_manager_get_time_us() - start);
+
+		pthread_mutex_lock(&g_backend_info.lock);
+		__slot_complete_locked(slot, ret, result);
+		pthread_mutex_unlock(&g_backend_info.lock);
+
+		values[0] = result[0];
+		values[1] = result[1];
+		return ret;
+	}
+
+	if(!slot->in_flight){
+		slot->func = func;
+		slot->arg = arg;
+		slot->in_flight = 1;
+		g_backend_info.pending_mask |= 1 << index;
+		pthread_cond_signal(&g_backend_info.work_cond);
+	}
+	generation = slot->generation;
+
+	__backend_deadline_to_timespec(g_backend_info.deadline_ms, &ts);
+	while(slot->generation == generation){
+		if(pthread_cond_timedwait(&g_backend_info.done_cond, &g_backend_info.lock, &ts) != 0)
+			break;
+	}
+
+	missed = (slot->generation == generation);
+	if(!missed){
+		ret = slot->ret;
+		values[0] = slot->values[0];
+		values[1] = slot->values[1];
+	}else if(slot->known){
+		ret = MM_ERROR_NONE;
+		values[0] = slot->last_values[0];
+		values[1] = slot->last_values[1];
+		*stale = 1;
+	}else{
+		ret = SOUND_MANAGER_ERROR_TIMED_OUT;
+	}
+	pthread_mutex_unlock(&g_backend_info.lock);
+
+	if(missed)
+		__sync_fetch_and_add(&g_backend_deadline_missed, 1);
+
+	return ret;
+}
+
+void _sound_manager_backend_update(int index, const int *values)
+{
+	_backend_slot_s *slot = &g_backend_info.slot[index];
+
+	pthread_mutex_lock(&g_backend_info.lock);
+	slot->known = 1;
+	slot->last_values[0] = values[0];
+	slot->last_values[1] = values[1];
+	pthread_mutex_unlock(&g_backend_info.lock);
+}
+
+void _sound_manager_backend_seed(int index, const int *values)
+{
+	_backend_slot_s *slot = &g_backend_info.slot[index];
+
+	pthread_mutex_lock(&g_backend_info.lock);
+	if(!slot->known){
+		slot->known = 1;
+		slot->last_values[0] = values[0];
+		slot->last_values[1] = values[1];
+	}
+	pthread_mutex_unlock(&g_backend_info.lock);
+}
+
+int sound_manager_set_backend_deadline(unsigned int deadline_ms)
+{
+	pthread_mutex_lock(&g_backend_info.lock);
+	g_backend_info.deadline_ms = deadline_ms;
+	pthread_mutex_unlock(&g_backend_info.lock);
+
+	return SOUND_MANAGER_ERROR_NONE;
+}
+
+int sound_manager_get_backend_deadline(unsigned int *deadline_ms)
+{
+	if(deadline_ms == NULL)
+		return __convert_sound_manager_error_code(__func__, SOUND_MANAGER_ERROR_INVALID_PARAMETER);
+
+	pthread_mutex_lock(&g_backend_info.lock);
+	*deadline_ms = g_backend_info.deadline_ms;
+	pthread_mutex_unlock(&g_backend_info.lock);
+
+	return SOUND_MANAGER_ERROR_NONE;
+}
+
+int sound_manager_get_backend_latency(sound_backend_latency_s *latency)
+{
+	if(latency == NULL)
+		return __convert_sound_manager_error_code(__func__, SOUND_MANAGER_ERROR_INVALID_PARAMETER);
+
+	_sound_manager_latency_get(&g_backend_latency, &latency->count, &latency->p50_us, &latency->p99_us, &latency->p999_us, &latency->max_us);
+	latency->deadline_missed = __sync_fetch_and_add(&g_backend_deadline_missed, 0);
+
+	return SOUND_MANAGER_ERROR_NONE;
+}
+
+void sound_manager_reset_backend_latency(void)
+{
+	_sound_manager_latency_reset(&g_backend_latency);
+	__sync_lock_test_and_set(&g_backend_deadline_missed, 0);
+}
+
+int sound_manager_set_backend_retry_policy(const sound_backend_retry_policy_s *policy)
+{
+	if(policy && policy->max_retries && policy->max_delay_ms < policy->base_delay_ms)
+		return __convert_sound_manager_error_code(__func__, SOUND_MANAGER_ERROR_INVALID_PARAMETER);
+	if(policy && policy->failure_threshold && policy->cool_down_ms == 0)
+		return __convert_sound_manager_error_code(__func__, SOUND_MANAGER_ERROR_INVALID_PARAMETER);
+
+	pthread_mutex_lock(&g_backend_retry.lock);
+	if(policy)
+		g_backend_retry.policy = *policy;
+	else
+		memset(&g_backend_retry.policy, 0, sizeof(sound_backend_retry_policy_s));
+	/* a new policy starts with a closed circuit, a running probe still clears its flag */
+	g_backend_retry.state = SOUND_BACKEND_CIRCUIT_CLOSED;
+	g_backend_retry.consecutive_failures = 0;
+	__sync_lock_test_and_set(&g_backend_retry.enabled,
+		g_backend_retry.policy.max_retries != 0 || g_backend_retry.policy.failure_threshold != 0);
+	pthread_mutex_unlock(&g_backend_retry.lock);
+
+	return SOUND_MANAGER_ERROR_NONE;
+}
+
+int sound_manager_get_backend_retry_policy(sound_backend_retry_policy_s *policy)
+{
+	if(policy == NULL)
+		return __convert_sound_manager_error_code(__func__, SOUND_MANAGER_ERROR_INVALID_PARAMETER);
+
+	pthread_mutex_lock(&g_backend_retry.lock);
+	*policy = g_backend_retry.policy;
+	pthread_mutex_unlock(&g_backend_retry.lock);
+
+	return SOUND_MANAGER_ERROR_NONE;
+}
+
+int sound_manager_get_backend_retry_stats(sound_backend_retry_stats_s *stats)
+{
+	if(stats == NULL)
+		return __convert_sound_manager_error_code(__func__, SOUND_MANAGER_ERROR_INVALID_PARAMETER);
+
+	pthread_mutex_lock(&g_backend_retry.lock);
+	*stats = g_backend_retry.stats;
+	stats->state = g_backend_retry.state;
+	/* the cool-down may have run out without a request moving the circuit on */
+	if(stats->state == SOUND_BACKEND_CIRCUIT_OPEN && _sound_manager_get_time_us() >= g_backend_retry.open_until_us)
+		stats->state = SOUND_BACKEND_CIRCUIT_HALF_OPEN;
+	pthread_mutex_unlock(&g_backend_retry.lock);
+
+	return SOUND_MANAGER_ERROR_NONE;
+}
+
+void sound_manager_reset_backend_retry_stats(void)
+{
+	pthread_mutex_lock(&g_backend_retry.lock);
+	memset(&g_backend_retry.stats, 0, sizeof(sound_backend_retry_stats_s));
+	pthread_mutex_unlock(&g_backend_retry.lock);
+}
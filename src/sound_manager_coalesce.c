@@ -0,0 +1,269 @@
+/*
+* Copyright (c) 2011 Samsung Electronics Co., Ltd All Rights Reserved
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+
+#define LOG_TAG "TIZEN_N_SOUND_MANGER"
+
+#include <sound_manager.h>
+#include <sound_manager_private.h>
+#include <stdio.h>
+#include <string.h>
+#include <pthread.h>
+#include <dlog.h>
+
+/*
+ * Volume write coalescer
+ *
+ * While enabled, sound_manager_set_volume() sends at most max_rate levels per
+ * second and sound type. A request inside the window only replaces the level
+ * waiting for that type, which the timer thread sends when the window ends.
+ * A level further than the tolerance from the last sent one skips the wait.
+ * Writes are sent without the lock, one at a time per type: a level set while
+ * the previous one of its type is in flight waits, so they reach the sound
+ * server in order.
+ */
+#define VOLUME_COALESCE_TYPE_NUM (MAX_VOLUME_TYPE + 1)
+
+typedef struct {
+	pthread_mutex_t lock;
+	pthread_cond_t sent_cond;	/* signaled when a write completes */
+	unsigned int max_rate;	/* 0 when disabled */
+	int tolerance;
+	unsigned int timer_id;
+	unsigned int pending_mask;
+	int pending[VOLUME_COALESCE_TYPE_NUM];
+	unsigned int sending_mask;	/* types with a write in flight */
+	unsigned int sent_mask;	/* types with a known last sent level */
+	int sent[VOLUME_COALESCE_TYPE_NUM];
+	unsigned long long sent_us[VOLUME_COALESCE_TYPE_NUM];
+	sound_volume_coalescing_stats_s stats;
+}_volume_coalesce_info_s;
+
+static _volume_coalesce_info_s g_coalesce_info = {PTHREAD_MUTEX_INITIALIZER, PTHREAD_COND_INITIALIZER, };
+
+static unsigned long long __interval_us_locked(void)
+{
+	return 1000000ULL / g_coalesce_info.max_rate;
+}
+
+/* Called with the lock held and the type marked as sending, returns with the lock held again */
+static int __coalesce_send_locked(int type, int volume)
+{
+	int ret;
+
+	pthread_mutex_unlock(&g_coalesce_info.lock);
+	ret = _sound_manager_volume_write(type, volume);
+	pthread_mutex_lock(&g_coalesce_info.lock);
+
+	g_coalesce_info.sent_us[type] = _sound_manager_get_time_us();
+	if(ret == MM_ERROR_NONE){
+		g_coalesce_info.sent[type] = volume;
+		g_coalesce_info.sent_mask |= (1 << type);
+	}else{
+		g_coalesce_info.sent_mask &= ~(1 << type);
+	}
+	g_coalesce_info.stats.issued++;
+	g_coalesce_info.sending_mask &= ~(1 << type);
+	pthread_cond_broadcast(&g_coalesce_info.sent_cond);
+
+	return ret;
+}
+
+/* Levels of a type with a write in flight stay waiting for the next flush */
+static void __coalesce_flush_locked(int all)
+{
+	unsigned long long now = _sound_manager_get_time_us();
+	int volume[VOLUME_COALESCE_TYPE_NUM];
+	unsigned int mask = 0;
+	int type;
+	int ret;
+
+	for(type = 0 ; type < VOLUME_COALESCE_TYPE_NUM ; type++)
+	{
+		if(!(g_coalesce_info.pending_mask & (1 << type)) || (g_coalesce_info.sending_mask & (1 << type)))
+			continue;
+		if(!all && now - g_coalesce_info.sent_us[type] < __interval_us_locked())
+			continue;
+		g_coalesce_info.pending_mask &= ~(1 << type);
+		g_coalesce_info.sending_mask |= (1 << type);
+		volume[type] = g_coalesce_info.pending[type];
+		mask |= (1 << type);
+	}
+
+	for(type = 0 ; type < VOLUME_COALESCE_TYPE_NUM ; type++)
+	{
+		if(!(mask & (1 << type)))
+			continue;
+		ret = __coalesce_send_locked(type, volume[type]);
+		if(ret != MM_ERROR_NONE)
+			LOGE("[%s] failed to set the volume of type %d (0x%x)", __func__, type, ret);
+	}
+}
+
+static int __coalesce_timer_cb(void *user_data)
+{
+	int again;
+
+	pthread_mutex_lock(&g_coalesce_info.lock);
+	__coalesce_flush_locked(g_coalesce_info.max_rate == 0);
+	again = (g_coalesce_info.pending_mask != 0);
+	if(!again)
+		g_coalesce_info.timer_id = 0;
+	pthread_mutex_unlock(&g_coalesce_info.lock);
+
+	return again;
+}
+
+int _sound_manager_volume_coalesce(sound_type_e type, int volume, int *ret)
+{
+	unsigned long long interval_us;
+	int distance;
+	int max;
+
+	pthread_mutex_lock(&g_coalesce_info.lock);
+	if(g_coalesce_info.max_rate == 0){
+		pthread_mutex_unlock(&g_coalesce_info.lock);
+		return 0;
+	}
+
+	g_coalesce_info.stats.requested++;
+	interval_us = __interval_us_locked();
+	distance = volume - g_coalesce_info.sent[type];
+	if(distance < 0)
+		distance = -distance;
+
+	if(!(g_coalesce_info.sending_mask & (1 << type))
+		&& (!(g_coalesce_info.sent_mask & (1 << type)) || distance > g_coalesce_info.tolerance
+		|| _sound_manager_get_time_us() - g_coalesce_info.sent_us[type] >= interval_us)){
+		if(g_coalesce_info.pending_mask & (1 << type)){
+			g_coalesce_info.pending_mask &= ~(1 << type);
+			g_coalesce_info.stats.coalesced++;
+		}
+		g_coalesce_info.sending_mask |= (1 << type);
+		*ret = __coalesce_send_locked(type, volume);
+		pthread_mutex_unlock(&g_coalesce_info.lock);
+		return 1;
+	}
+	pthread_mutex_unlock(&g_coalesce_info.lock);
+
+	/* a deferred write can not report errors, check what can be checked now */
+	*ret = sound_manager_get_max_volume(type, &max);
+	if(*ret != SOUND_MANAGER_ERROR_NONE || volume > max){
+		if(*ret == SOUND_MANAGER_ERROR_NONE)
+			*ret = SOUND_MANAGER_ERROR_INVALID_PARAMETER;
+		return 1;
+	}
+
+	pthread_mutex_lock(&g_coalesce_info.lock);
+	if(g_coalesce_info.pending_mask & (1 << type))
+		g_coalesce_info.stats.coalesced++;
+	g_coalesce_info.pending[type] = volume;
+	g_coalesce_info.pending_mask |= (1 << type);
+
+	if(g_coalesce_info.max_rate && g_coalesce_info.timer_id == 0)
+		g_coalesce_info.timer_id = _sound_manager_timer_add((interval_us + 999) / 1000, __coalesce_timer_cb, NULL);
+	if(g_coalesce_info.max_rate == 0 || g_coalesce_info.timer_id == 0){
+		/* disabled meanwhile or no timer to send it later, wait for the write in flight and send it now */
+		while(g_coalesce_info.sending_mask & (1 << type))
+			pthread_cond_wait(&g_coalesce_info.sent_cond, &g_coalesce_info.lock);
+		if(g_coalesce_info.pending_mask & (1 << type)){
+			g_coalesce_info.pending_mask &= ~(1 << type);
+			g_coalesce_info.sending_mask |= (1 << type);
+			*ret = __coalesce_send_locked(type, g_coalesce_info.pending[type]);
+		}
+	}
+	pthread_mutex_unlock(&g_coalesce_info.lock);
+
+	return 1;
+}
+
+int _sound_manager_volume_coalesce_get_pending(sound_type_e type, int *volume)
+{
+	int pending = 0;
+
+	pthread_mutex_lock(&g_coalesce_info.lock);
+	if(g_coalesce_info.pending_mask & (1 << type)){
+		*volume = g_coalesce_info.pending[type];
+		pending = 1;
+	}
+	pthread_mutex_unlock(&g_coalesce_info.lock);
+
+	return pending;
+}
+
+int _sound_manager_volume_coalesce_write_now(sound_type_e type, int volume)
+{
+	int ret;
+
+	pthread_mutex_lock(&g_coalesce_info.lock);
+	while(g_coalesce_info.sending_mask & (1 << type))
+		pthread_cond_wait(&g_coalesce_info.sent_cond, &g_coalesce_info.lock);
+	if(g_coalesce_info.max_rate == 0){
+		pthread_mutex_unlock(&g_coalesce_info.lock);
+		return _sound_manager_volume_write(type, volume);
+	}
+
+	/* the level waiting is older, sending it later would undo this one */
+	g_coalesce_info.stats.requested++;
+	if(g_coalesce_info.pending_mask & (1 << type)){
+		g_coalesce_info.pending_mask &= ~(1 << type);
+		g_coalesce_info.stats.coalesced++;
+	}
+	g_coalesce_info.sending_mask |= (1 << type);
+	ret = __coalesce_send_locked(type, volume);
+	pthread_mutex_unlock(&g_coalesce_info.lock);
+
+	return ret;
+}
+
+int sound_manager_set_volume_coalescing(unsigned int max_rate, int tolerance)
+{
+	if(tolerance < 0)
+		return __convert_sound_manager_error_code(__func__, SOUND_MANAGER_ERROR_INVALID_PARAMETER);
+
+	pthread_mutex_lock(&g_coalesce_info.lock);
+	g_coalesce_info.max_rate = max_rate;
+	g_coalesce_info.tolerance = tolerance;
+	/* nothing is left waiting or in flight once disabled; the timer goes away by itself */
+	while(g_coalesce_info.max_rate == 0 && (g_coalesce_info.pending_mask || g_coalesce_info.sending_mask)){
+		if(g_coalesce_info.sending_mask)
+			pthread_cond_wait(&g_coalesce_info.sent_cond, &g_coalesce_info.lock);
+		else
+			__coalesce_flush_locked(1);
+	}
+	pthread_mutex_unlock(&g_coalesce_info.lock);
+
+	return SOUND_MANAGER_ERROR_NONE;
+}
+
+int sound_manager_get_volume_coalescing_stats(sound_volume_coalescing_stats_s *stats)
+{
+	if(stats == NULL)
+		return __convert_sound_manager_error_code(__func__, SOUND_MANAGER_ERROR_INVALID_PARAMETER);
+
+	pthread_mutex_lock(&g_coalesce_info.lock);
+	*stats = g_coalesce_info.stats;
+	pthread_mutex_unlock(&g_coalesce_info.lock);
+
+	return SOUND_MANAGER_ERROR_NONE;
+}
+
+void sound_manager_reset_volume_coalescing_stats(void)
+{
+	pthread_mutex_lock(&g_coalesce_info.lock);
+	memset(&g_coalesce_info.stats, 0, sizeof(g_coalesce_info.stats));
+	pthread_mutex_unlock(&g_coalesce_info.lock);
+}
@@ -0,0 +1,237 @@
+/*
+* Copyright (c) 2011 Samsung Electronics Co., Ltd All Rights Reserved
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+
+#define LOG_TAG "TIZEN_N_SOUND_MANGER"
+
+#include <sound_manager.h>
+#include <sound_manager_private.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/eventfd.h>
+#include <dlog.h>
+#include <mm_sound.h>
+
+#define CURRENT_SOUND_TYPE_POLL_MIN_MS 100
+#define CURRENT_SOUND_TYPE_POLL_MAX_MS 1000
+
+/*
+ * Current sound type monitor
+ *
+ * mm-sound does not notify playing type changes, so while anyone is subscribed
+ * the library samples it once per process on the timer thread and pushes changes
+ * to the callback and the event fd. The getter is served from the last sample.
+ * The interval doubles with every sample which finds nothing new, up to
+ * CURRENT_SOUND_TYPE_POLL_MAX_MS, and drops back to the minimum on a change,
+ * so an idle process costs one request per second instead of ten.
+ */
+typedef struct {
+	pthread_mutex_t lock;
+	int cb_subscribed;
+	int fd_subscribed;
+	int valid;
+	int last_ret;
+	sound_type_e last_type;
+	int event_fd;
+	unsigned int timer_id;
+	unsigned int interval_ms;
+	unsigned int first_poll_id;	/* one shot, the first sample without waiting a whole interval */
+	sound_current_sound_type_changed_cb user_cb;
+	void *user_data;
+}_current_type_info_s;
+
+static _current_type_info_s g_current_type_info = {PTHREAD_MUTEX_INITIALIZER, 0, 0, 0, 0, SOUND_TYPE_SYSTEM, -1, 0, CURRENT_SOUND_TYPE_POLL_MIN_MS, 0, NULL, NULL};
+
+static int __is_no_playing(int ret)
+{
+	return (ret == MM_ERROR_SOUND_VOLUME_NO_INSTANCE || ret == MM_ERROR_SOUND_VOLUME_CAPTURE_ONLY);
+}
+
+static int __current_type_poll_cb(void *user_data)
+{
+	volume_type_t type = VOLUME_TYPE_SYSTEM;
+	sound_current_sound_type_changed_cb user_cb = NULL;
+	void *cb_data = NULL;
+	unsigned int interval_ms;
+	int ret;
+	int changed;
+	uint64_t event = 1;
+
+	ret = mm_sound_volume_get_current_playing_type(&type);
+	if(ret != MM_ERROR_NONE && !__is_no_playing(ret))
+		return 1;	/* keep the last known state on backend failure */
+
+	pthread_mutex_lock(&g_current_type_info.lock);
+	changed = !g_current_type_info.valid || g_current_type_info.last_ret != ret
+		|| (ret == MM_ERROR_NONE && g_current_type_info.last_type != (sound_type_e)type);
+	g_current_type_info.valid = 1;
+	g_current_type_info.last_ret = ret;
+	g_current_type_info.last_type = (sound_type_e)type;
+	interval_ms = changed ? CURRENT_SOUND_TYPE_POLL_MIN_MS : g_current_type_info.interval_ms * 2;
+	if(interval_ms > CURRENT_SOUND_TYPE_POLL_MAX_MS)
+		interval_ms = CURRENT_SOUND_TYPE_POLL_MAX_MS;
+	if(interval_ms != g_current_type_info.interval_ms){
+		g_current_type_info.interval_ms = interval_ms;
+		_sound_manager_timer_set_interval(g_current_type_info.timer_id, interval_ms);
+	}
+	if(changed){
+		if(g_current_type_info.event_fd >= 0 && write(g_current_type_info.event_fd, &event, sizeof(event)) < 0)
+			LOGW("[%s] failed to signal the event fd", __func__);
+		user_cb = g_current_type_info.user_cb;
+		cb_data = g_current_type_info.user_data;
+	}
+	pthread_mutex_unlock(&g_current_type_info.lock);
+
+	if(user_cb)
+		user_cb((sound_type_e)type, ret == MM_ERROR_NONE, cb_data);
+
+	return 1;
+}
+
+static int __current_type_first_poll_cb(void *user_data)
+{
+	__current_type_poll_cb(user_data);
+	return 0;
+}
+
+/* called with the lock held, starts sampling on the first subscriber */
+static int __current_type_start_locked(void)
+{
+	if(g_current_type_info.timer_id)
+		return SOUND_MANAGER_ERROR_NONE;
+
+	g_current_type_info.valid = 0;
+	g_current_type_info.interval_ms = CURRENT_SOUND_TYPE_POLL_MIN_MS;
+	g_current_type_info.timer_id = _sound_manager_timer_add(CURRENT_SOUND_TYPE_POLL_MIN_MS, __current_type_poll_cb, NULL);
+	if(g_current_type_info.timer_id == 0)
+		return SOUND_MANAGER_ERROR_INVALID_OPERATION;
+	/* the subscriber does not wait for the sound server, the callback only runs on the timer thread */
+	g_current_type_info.first_poll_id = _sound_manager_timer_add(0, __current_type_first_poll_cb, NULL);
+
+	return SOUND_MANAGER_ERROR_NONE;
+}
+
+/* called with the lock held, returns the timers to remove once the lock is released */
+static void __current_type_stop_locked(unsigned int *timer_id, unsigned int *first_poll_id)
+{
+	*timer_id = 0;
+	*first_poll_id = 0;
+	if(g_current_type_info.cb_subscribed || g_current_type_info.fd_subscribed)
+		return;
+
+	*timer_id = g_current_type_info.timer_id;
+	*first_poll_id = g_current_type_info.first_poll_id;
+	g_current_type_info.timer_id = 0;
+	g_current_type_info.first_poll_id = 0;
+	g_current_type_info.valid = 0;
+}
+
+int _sound_manager_current_sound_type_get_cached(sound_type_e *type, int *ret)
+{
+	int cached = 0;
+
+	pthread_mutex_lock(&g_current_type_info.lock);
+	if(g_current_type_info.timer_id && g_current_type_info.valid){
+		*ret = g_current_type_info.last_ret;
+		if(*ret == MM_ERROR_NONE)
+			*type = g_current_type_info.last_type;
+		cached = 1;
+	}
+	pthread_mutex_unlock(&g_current_type_info.lock);
+
+	return cached;
+}
+
+int sound_manager_set_current_sound_type_changed_cb(sound_current_sound_type_changed_cb callback, void *user_data)
+{
+	int ret;
+
+	if(callback == NULL)
+		return __convert_sound_manager_error_code(__func__, SOUND_MANAGER_ERROR_INVALID_PARAMETER);
+
+	pthread_mutex_lock(&g_current_type_info.lock);
+	ret = __current_type_start_locked();
+	if(ret == SOUND_MANAGER_ERROR_NONE){
+		g_current_type_info.cb_subscribed = 1;
+		g_current_type_info.user_cb = callback;
+		g_current_type_info.user_data = user_data;
+	}
+	pthread_mutex_unlock(&g_current_type_info.lock);
+
+	return __convert_sound_manager_error_code(__func__, ret);
+}
+
+void sound_manager_unset_current_sound_type_changed_cb(void)
+{
+	unsigned int timer_id;
+	unsigned int first_poll_id;
+
+	pthread_mutex_lock(&g_current_type_info.lock);
+	g_current_type_info.cb_subscribed = 0;
+	g_current_type_info.user_cb = NULL;
+	g_current_type_info.user_data = NULL;
+	__current_type_stop_locked(&timer_id, &first_poll_id);
+	pthread_mutex_unlock(&g_current_type_info.lock);
+
+	_sound_manager_timer_remove(first_poll_id);
+	_sound_manager_timer_remove(timer_id);
+}
+
+int sound_manager_get_current_sound_type_event_fd(int *fd)
+{
+	int ret = SOUND_MANAGER_ERROR_NONE;
+
+	if(fd == NULL)
+		return __convert_sound_manager_error_code(__func__, SOUND_MANAGER_ERROR_INVALID_PARAMETER);
+
+	pthread_mutex_lock(&g_current_type_info.lock);
+	if(g_current_type_info.event_fd < 0){
+		g_current_type_info.event_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+		if(g_current_type_info.event_fd < 0)
+			ret = SOUND_MANAGER_ERROR_INVALID_OPERATION;
+	}
+	if(ret == SOUND_MANAGER_ERROR_NONE)
+		ret = __current_type_start_locked();
+	if(ret == SOUND_MANAGER_ERROR_NONE){
+		g_current_type_info.fd_subscribed = 1;
+		*fd = g_current_type_info.event_fd;
+	}
+	pthread_mutex_unlock(&g_current_type_info.lock);
+
+	return __convert_sound_manager_error_code(__func__, ret);
+}
+
+void sound_manager_release_current_sound_type_event_fd(void)
+{
+	unsigned int timer_id;
+	unsigned int first_poll_id;
+	int fd;
+
+	pthread_mutex_lock(&g_current_type_info.lock);
+	g_current_type_info.fd_subscribed = 0;
+	fd = g_current_type_info.event_fd;
+	g_current_type_info.event_fd = -1;
+	__current_type_stop_locked(&timer_id, &first_poll_id);
+	pthread_mutex_unlock(&g_current_type_info.lock);
+
+	_sound_manager_timer_remove(first_poll_id);
+	_sound_manager_timer_remove(timer_id);
+	if(fd >= 0)
+		close(fd);
+}
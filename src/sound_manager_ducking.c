@@ -0,0 +1,182 @@
+/*
+* Copyright (c) 2011 Samsung Electronics Co., Ltd All Rights Reserved
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+
+#define LOG_TAG "TIZEN_N_SOUND_MANGER"
+
+#include <sound_manager.h>
+#include <sound_manager_private.h>
+#include <stdio.h>
+#include <string.h>
+#include <pthread.h>
+#include <dlog.h>
+#include <mm_session.h>
+
+#define DUCKING_RAMP_INTERVAL_MS 10
+
+/*
+ * Automatic ducking
+ *
+ * Interrupts by other applications and alarms lower the media duck gain along a
+ * linear ramp, and MM_SESSION_MSG_RESUME brings it back. The ramp only changes
+ * the local gain of the media streams, the system volume is never written.
+ */
+typedef struct {
+	pthread_mutex_t lock;
+	int enabled;
+	int ducked;
+	double ducked_gain;
+	unsigned int attack_ms;
+	unsigned int release_ms;
+	double gain;
+	double start_gain;
+	double target_gain;
+	unsigned long long start_time;
+	unsigned long long duration;
+	unsigned int timer_id;
+}_ducking_info_s;
+
+static _ducking_info_s g_ducking_info = {PTHREAD_MUTEX_INITIALIZER, 0, 0, 0.0, 0, 0, 1.0, 1.0, 1.0, 0, 0, 0};
+
+static int __ducking_ramp_cb(void *user_data)
+{
+	unsigned long long elapsed;
+	double gain;
+	int again = 1;
+
+	pthread_mutex_lock(&g_ducking_info.lock);
+	elapsed = _sound_manager_get_time_us() - g_ducking_info.start_time;
+	if(elapsed >= g_ducking_info.duration){
+		gain = g_ducking_info.target_gain;
+		g_ducking_info.timer_id = 0;
+		again = 0;
+	}else{
+		gain = g_ducking_info.start_gain + (g_ducking_info.target_gain - g_ducking_info.start_gain) * elapsed / g_ducking_info.duration;
+	}
+	g_ducking_info.gain = gain;
+	pthread_mutex_unlock(&g_ducking_info.lock);
+
+	_sound_manager_stream_volume_set_duck_gain(SOUND_TYPE_MEDIA, gain);
+
+	return again;
+}
+
+/* returns non-zero if the target has to be applied right away */
+static int __ducking_start_ramp_locked(double target, unsigned int duration_ms)
+{
+	g_ducking_info.start_gain = g_ducking_info.gain;
+	g_ducking_info.target_gain = target;
+	g_ducking_info.start_time = _sound_manager_get_time_us();
+	g_ducking_info.duration = (unsigned long long)duration_ms * 1000;
+
+	if(duration_ms == 0 || g_ducking_info.gain == target){
+		g_ducking_info.gain = target;
+		return 1;
+	}
+
+	if(g_ducking_info.timer_id == 0){
+		g_ducking_info.timer_id = _sound_manager_timer_add(DUCKING_RAMP_INTERVAL_MS, __ducking_ramp_cb, NULL);
+		if(g_ducking_info.timer_id == 0){
+			g_ducking_info.gain = target;
+			return 1;
+		}
+	}
+	return 0;
+}
+
+int _sound_manager_ducking_session_notify(session_msg_t msg, session_event_t event)
+{
+	int handled = 0;
+	int apply = 0;
+	double gain = 1.0;
+
+	pthread_mutex_lock(&g_ducking_info.lock);
+	if(msg == MM_SESSION_MSG_RESUME){
+		if(g_ducking_info.ducked){
+			g_ducking_info.ducked = 0;
+			apply = __ducking_start_ramp_locked(1.0, g_ducking_info.release_ms);
+			handled = 1;
+		}
+	}else if(g_ducking_info.enabled && (event == MM_SESSION_EVENT_OTHER_APP || event == MM_SESSION_EVENT_ALARM)){
+		g_ducking_info.ducked = 1;
+		apply = __ducking_start_ramp_locked(g_ducking_info.ducked_gain, g_ducking_info.attack_ms);
+		handled = 1;
+	}
+	gain = g_ducking_info.gain;
+	pthread_mutex_unlock(&g_ducking_info.lock);
+
+	if(apply)
+		_sound_manager_stream_volume_set_duck_gain(SOUND_TYPE_MEDIA, gain);
+
+	return handled;
+}
+
+int sound_manager_enable_auto_ducking(double ducked_gain, unsigned int attack_ms, unsigned int release_ms)
+{
+	int ret;
+
+	if(ducked_gain < 0.0 || ducked_gain > 1.0)
+		return __convert_sound_manager_error_code(__func__, SOUND_MANAGER_ERROR_INVALID_PARAMETER);
+
+	/* interrupts only arrive with a registered session */
+	ret = _sound_manager_session_init_default();
+	if(ret != 0)
+		return __convert_sound_manager_error_code(__func__, ret);
+
+	pthread_mutex_lock(&g_ducking_info.lock);
+	g_ducking_info.enabled = 1;
+	g_ducking_info.ducked_gain = ducked_gain;
+	g_ducking_info.attack_ms = attack_ms;
+	g_ducking_info.release_ms = release_ms;
+	pthread_mutex_unlock(&g_ducking_info.lock);
+
+	return SOUND_MANAGER_ERROR_NONE;
+}
+
+int sound_manager_disable_auto_ducking(void)
+{
+	unsigned int timer_id;
+
+	pthread_mutex_lock(&g_ducking_info.lock);
+	g_ducking_info.enabled = 0;
+	g_ducking_info.ducked = 0;
+	g_ducking_info.gain = 1.0;
+	timer_id = g_ducking_info.timer_id;
+	g_ducking_info.timer_id = 0;
+	pthread_mutex_unlock(&g_ducking_info.lock);
+
+	/* the ramp callback takes the ducking lock, remove it unlocked */
+	_sound_manager_timer_remove(timer_id);
+
+	pthread_mutex_lock(&g_ducking_info.lock);
+	g_ducking_info.gain = 1.0;
+	pthread_mutex_unlock(&g_ducking_info.lock);
+	_sound_manager_stream_volume_set_duck_gain(SOUND_TYPE_MEDIA, 1.0);
+
+	return SOUND_MANAGER_ERROR_NONE;
+}
+
+int sound_manager_get_auto_ducking_gain(double *gain)
+{
+	if(gain == NULL)
+		return __convert_sound_manager_error_code(__func__, SOUND_MANAGER_ERROR_INVALID_PARAMETER);
+
+	pthread_mutex_lock(&g_ducking_info.lock);
+	*gain = g_ducking_info.gain;
+	pthread_mutex_unlock(&g_ducking_info.lock);
+
+	return SOUND_MANAGER_ERROR_NONE;
+}
@@ -0,0 +1,286 @@
+/*
+* Copyright (c) 2011 Samsung Electronics Co., Ltd All Rights Reserved
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+
+#define LOG_TAG "TIZEN_N_SOUND_MANGER"
+
+#include <sound_manager.h>
+#include <sound_manager_private.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+#include <dlog.h>
+
+/*
+ * Batched event delivery
+ *
+ * The backend notification threads append records to the filling buffer and
+ * wake the delivery thread when a batch starts or fills up. The buffer holds
+ * SOUND_EVENT_BATCH_MAX records, so a late wake up does not lose events; the
+ * delivery hands them out max_batch at a time. Batches are only delivered from
+ * the delivery thread, one at a time, so they arrive in order and the buffer
+ * being delivered is never refilled before the callback returns. A slow
+ * callback only delays the batches, not the internal timer thread.
+ */
+typedef struct {
+	pthread_mutex_t lock;
+	pthread_cond_t cond;
+	int enabled;	/* read without the lock on the fast path */
+	int stopping;
+	int thread_started;	/* not joined yet */
+	pthread_t thread;
+	sound_event_batch_cb user_cb;
+	void *user_data;
+	unsigned int window_ms;
+	unsigned int max_batch;
+	unsigned long long due_us;	/* of the batch being filled */
+	unsigned int sequence;
+	int fill;	/* index of the buffer being filled */
+	unsigned int count;
+	sound_event_s buffer[2][SOUND_EVENT_BATCH_MAX];
+}_event_batch_info_s;
+
+static _event_batch_info_s g_event_batch_info = {PTHREAD_MUTEX_INITIALIZER, PTHREAD_COND_INITIALIZER, };
+
+/* serializes set and unset with the backend registrations and the thread they start and join */
+static pthread_mutex_t g_event_batch_subscribe_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+static void *__event_batch_thread(void *data)
+{
+	sound_event_batch_cb user_cb;
+	sound_event_s *events;
+	void *cb_data;
+	unsigned int max_batch;
+	unsigned int count;
+	unsigned int slice;
+	unsigned int i;
+	struct timespec ts;
+
+	pthread_mutex_lock(&g_event_batch_info.lock);
+	while(!g_event_batch_info.stopping){
+		if(g_event_batch_info.count == 0){
+			pthread_cond_wait(&g_event_batch_info.cond, &g_event_batch_info.lock);
+			continue;
+		}
+		if(g_event_batch_info.count < g_event_batch_info.max_batch && _sound_manager_get_time_us() < g_event_batch_info.due_us){
+			/* cond runs on the monotonic clock, see sound_manager_set_event_batch_cb() */
+			ts.tv_sec = g_event_batch_info.due_us / 1000000;
+			ts.tv_nsec = (long)(g_event_batch_info.due_us % 1000000) * 1000;
+			pthread_cond_timedwait(&g_event_batch_info.cond, &g_event_batch_info.lock, &ts);
+			continue;
+		}
+
+		events = g_event_batch_info.buffer[g_event_batch_info.fill];
+		count = g_event_batch_info.count;
+		g_event_batch_info.fill ^= 1;
+		g_event_batch_info.count = 0;
+		user_cb = g_event_batch_info.user_cb;
+		cb_data = g_event_batch_info.user_data;
+		max_batch = g_event_batch_info.max_batch;
+		pthread_mutex_unlock(&g_event_batch_info.lock);
+
+		for(i = 0 ; i < count ; i += slice)
+		{
+			/* an unset from the previous slice ends the batch, registering again takes the rest */
+			if(i){
+				pthread_mutex_lock(&g_event_batch_info.lock);
+				user_cb = g_event_batch_info.stopping ? NULL : g_event_batch_info.user_cb;
+				cb_data = g_event_batch_info.user_data;
+				max_batch = g_event_batch_info.max_batch;
+				pthread_mutex_unlock(&g_event_batch_info.lock);
+			}
+			if(user_cb == NULL)
+				break;
+			slice = count - i < max_batch ? count - i : max_batch;
+			user_cb(events + i, slice, cb_data);
+		}
+
+		pthread_mutex_lock(&g_event_batch_info.lock);
+	}
+	pthread_mutex_unlock(&g_event_batch_info.lock);
+
+	return NULL;
+}
+
+void _sound_manager_event_batch_push(sound_event_type_e type, int value1, int value2)
+{
+	sound_event_s *event;
+
+	if(!__sync_fetch_and_add(&g_event_batch_info.enabled, 0))
+		return;
+
+	pthread_mutex_lock(&g_event_batch_info.lock);
+	if(g_event_batch_info.user_cb == NULL){
+		pthread_mutex_unlock(&g_event_batch_info.lock);
+		return;
+	}
+
+	g_event_batch_info.sequence++;
+	if(g_event_batch_info.count >= SOUND_EVENT_BATCH_MAX){
+		/* the callback is behind, the gap in the sequence tells it */
+		pthread_mutex_unlock(&g_event_batch_info.lock);
+		return;
+	}
+
+	if(g_event_batch_info.count == 0)
+		g_event_batch_info.due_us = _sound_manager_get_time_us() + g_event_batch_info.window_ms * 1000ULL;
+	event = &g_event_batch_info.buffer[g_event_batch_info.fill][g_event_batch_info.count++];
+	event->sequence = g_event_batch_info.sequence;
+	event->type = type;
+	switch(type){
+		case SOUND_EVENT_VOLUME_CHANGED:
+			event->data.volume.type = value1;
+			event->data.volume.volume = value2;
+			break;
+		case SOUND_EVENT_SESSION_NOTIFY:
+			event->data.session.notify = value1;
+			event->data.session.code = value2;
+			break;
+		case SOUND_EVENT_AVAILABLE_ROUTE_CHANGED:
+			event->data.route.route = value1;
+			event->data.route.available = value2;
+			break;
+		case SOUND_EVENT_ACTIVE_DEVICE_CHANGED:
+			event->data.device.in = value1;
+			event->data.device.out = value2;
+			break;
+		case SOUND_EVENT_MUTE_CHANGED:
+			event->data.mute.type = value1;
+			event->data.mute.muted = value2;
+			break;
+	}
+
+	/* the thread sleeps without a batch and until the window of one ends */
+	if(g_event_batch_info.count == 1 || g_event_batch_info.count == g_event_batch_info.max_batch)
+		pthread_cond_signal(&g_event_batch_info.cond);
+	pthread_mutex_unlock(&g_event_batch_info.lock);
+}
+
+static void __event_batch_disable(void)
+{
+	pthread_t thread;
+	int join;
+
+	pthread_mutex_lock(&g_event_batch_info.lock);
+	__sync_lock_test_and_set(&g_event_batch_info.enabled, 0);
+	g_event_batch_info.user_cb = NULL;
+	g_event_batch_info.user_data = NULL;
+	g_event_batch_info.count = 0;
+	g_event_batch_info.stopping = 1;
+	pthread_cond_signal(&g_event_batch_info.cond);
+	thread = g_event_batch_info.thread;
+	/* from the callback the thread leaves once it returns, the next set joins it */
+	join = !pthread_equal(thread, pthread_self());
+	if(join)
+		g_event_batch_info.thread_started = 0;
+	pthread_mutex_unlock(&g_event_batch_info.lock);
+
+	if(join)
+		pthread_join(thread, NULL);
+}
+
+static int __event_batch_start_thread(void)
+{
+	pthread_condattr_t attr;
+	int ret;
+
+	/* still in its callback after an unset from it, it just goes on */
+	if(g_event_batch_info.thread_started && pthread_equal(g_event_batch_info.thread, pthread_self())){
+		pthread_mutex_lock(&g_event_batch_info.lock);
+		g_event_batch_info.stopping = 0;
+		pthread_mutex_unlock(&g_event_batch_info.lock);
+		return MM_ERROR_NONE;
+	}
+	if(g_event_batch_info.thread_started){
+		pthread_join(g_event_batch_info.thread, NULL);
+		g_event_batch_info.thread_started = 0;
+	}
+
+	/* no thread waits on the cond here */
+	pthread_condattr_init(&attr);
+	pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+	pthread_cond_destroy(&g_event_batch_info.cond);
+	pthread_cond_init(&g_event_batch_info.cond, &attr);
+	pthread_condattr_destroy(&attr);
+
+	g_event_batch_info.stopping = 0;
+	ret = pthread_create(&g_event_batch_info.thread, NULL, __event_batch_thread, NULL);
+	if(ret != 0){
+		LOGE("[%s] failed to create the batch delivery thread (%d)", __func__, ret);
+		return MM_ERROR_SOUND_INTERNAL;
+	}
+	g_event_batch_info.thread_started = 1;
+
+	return MM_ERROR_NONE;
+}
+
+int sound_manager_set_event_batch_cb(unsigned int window_ms, unsigned int max_batch, sound_event_batch_cb callback, void *user_data)
+{
+	if(callback == NULL || max_batch == 0 || max_batch > SOUND_EVENT_BATCH_MAX)
+		return __convert_sound_manager_error_code(__func__, SOUND_MANAGER_ERROR_INVALID_PARAMETER);
+	int ret = MM_ERROR_NONE;
+
+	pthread_mutex_lock(&g_event_batch_subscribe_mutex);
+	if(!__sync_fetch_and_add(&g_event_batch_info.enabled, 0)){
+#ifndef SOUND_MANAGER_DISABLE_SESSION
+		ret = _sound_manager_session_init_default();
+#endif
+#ifndef SOUND_MANAGER_DISABLE_ROUTE
+		if(ret == MM_ERROR_NONE)
+			ret = _sound_manager_route_set_batched(1);
+#endif
+		if(ret == MM_ERROR_NONE){
+			ret = __event_batch_start_thread();
+#ifndef SOUND_MANAGER_DISABLE_ROUTE
+			if(ret != MM_ERROR_NONE)
+				_sound_manager_route_set_batched(0);
+#endif
+		}
+		if(ret != MM_ERROR_NONE){
+			pthread_mutex_unlock(&g_event_batch_subscribe_mutex);
+			return __convert_sound_manager_error_code(__func__, ret);
+		}
+		_sound_manager_volume_monitor_ref();
+	}
+
+	pthread_mutex_lock(&g_event_batch_info.lock);
+	g_event_batch_info.user_cb = callback;
+	g_event_batch_info.user_data = user_data;
+	g_event_batch_info.window_ms = window_ms;
+	g_event_batch_info.max_batch = max_batch;
+	/* a smaller batch than what is already waiting goes out right away */
+	if(g_event_batch_info.count > 0)
+		pthread_cond_signal(&g_event_batch_info.cond);
+	__sync_lock_test_and_set(&g_event_batch_info.enabled, 1);
+	pthread_mutex_unlock(&g_event_batch_info.lock);
+	pthread_mutex_unlock(&g_event_batch_subscribe_mutex);
+
+	return SOUND_MANAGER_ERROR_NONE;
+}
+
+void sound_manager_unset_event_batch_cb(void)
+{
+	pthread_mutex_lock(&g_event_batch_subscribe_mutex);
+	if(__sync_fetch_and_add(&g_event_batch_info.enabled, 0)){
+		__event_batch_disable();
+		_sound_manager_volume_monitor_unref();
+#ifndef SOUND_MANAGER_DISABLE_ROUTE
+		_sound_manager_route_set_batched(0);
+#endif
+	}
+	pthread_mutex_unlock(&g_event_batch_subscribe_mutex);
+}
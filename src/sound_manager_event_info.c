@@ -0,0 +1,89 @@
+/*
+* Copyright (c) 2011 Samsung Electronics Co., Ltd All Rights Reserved
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+
+#define LOG_TAG "TIZEN_N_SOUND_MANGER"
+
+#include <sound_manager.h>
+#include <sound_manager_private.h>
+#include <stdio.h>
+#include <dlog.h>
+
+/*
+ * Event timing
+ *
+ * mm-sound and mm-session notifications carry no timestamp, so an event is
+ * stamped when the backend thread enters the library. The event lives on the
+ * stack of that thread while its callbacks run; a thread local pointer makes
+ * it visible to sound_manager_get_event_info(). A callback may cause another
+ * event on the same thread, which is delivered nested and restores the outer
+ * one when done.
+ */
+static unsigned int g_event_sequence;
+/* updated with atomics, events arrive on several backend threads */
+static _sound_manager_latency_s g_event_latency;
+static __thread _sound_manager_event_s *g_delivering_event;
+
+void _sound_manager_event_receive(_sound_manager_event_s *event, sound_event_type_e type)
+{
+	event->info.receive_time_us = _sound_manager_get_time_us();
+	event->info.delivery_time_us = 0;
+	event->info.sequence = __sync_add_and_fetch(&g_event_sequence, 1);
+	event->info.type = type;
+	event->delivered = 0;
+	event->outer = NULL;
+}
+
+void _sound_manager_event_deliver_begin(_sound_manager_event_s *event)
+{
+	if(!event->delivered){
+		event->info.delivery_time_us = _sound_manager_get_time_us();
+		event->delivered = 1;
+		_sound_manager_latency_record(&g_event_latency, event->info.delivery_time_us - event->info.receive_time_us);
+	}
+	event->outer = g_delivering_event;
+	g_delivering_event = event;
+}
+
+void _sound_manager_event_deliver_end(_sound_manager_event_s *event)
+{
+	g_delivering_event = event->outer;
+}
+
+int sound_manager_get_event_info(sound_event_info_s *info)
+{
+	if(info == NULL)
+		return __convert_sound_manager_error_code(__func__, SOUND_MANAGER_ERROR_INVALID_PARAMETER);
+	if(g_delivering_event == NULL)
+		return __convert_sound_manager_error_code(__func__, SOUND_MANAGER_ERROR_INVALID_OPERATION);
+
+	*info = g_delivering_event->info;
+	return SOUND_MANAGER_ERROR_NONE;
+}
+
+int sound_manager_get_event_latency(sound_event_latency_s *latency)
+{
+	if(latency == NULL)
+		return __convert_sound_manager_error_code(__func__, SOUND_MANAGER_ERROR_INVALID_PARAMETER);
+
+	_sound_manager_latency_get(&g_event_latency, &latency->count, &latency->p50_us, &latency->p99_us, &latency->p999_us, &latency->max_us);
+	return SOUND_MANAGER_ERROR_NONE;
+}
+
+void sound_manager_reset_event_latency(void)
+{
+	_sound_manager_latency_reset(&g_event_latency);
+}
@@ -0,0 +1,415 @@
+/*
+* Copyright (c) 2011 Samsung Electronics Co., Ltd All Rights Reserved
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+
+#define LOG_TAG "TIZEN_N_SOUND_MANGER"
+
+#include <sound_manager.h>
+#include <sound_manager_private.h>
+#include <stdio.h>
+#include <string.h>
+#include <malloc.h>
+#include <pthread.h>
+#include <dlog.h>
+#include <mm_session.h>
+
+/*
+ * Focus stack
+ *
+ * Holders are kept in an intrusive doubly linked list, the top of the list is the
+ * current focus owner and the ones below it wait, paused or ducked, for it to be
+ * abandoned. A transient request only interrupts the holder right below it, a
+ * permanent one takes the focus from every holder in the stack. The holders of each
+ * priority class are counted, so a request is granted or denied without walking
+ * the stack.
+ *
+ * State changes are queued on the holders themselves through notify_next and one
+ * thread at a time drains the queue with the lock released, so a callback may
+ * request or abandon the focus again. A holder changing twice before it is told is
+ * told once, with its latest state.
+ */
+struct sound_focus_s
+{
+	sound_focus_priority_e priority;
+	sound_focus_request_e request;
+	sound_focus_state_e state;
+	sound_focus_state_changed_cb user_cb;
+	void *user_data;
+	int in_stack;
+	struct sound_focus_s *above;
+	struct sound_focus_s *below;
+	sound_focus_state_e notify_state;
+	int notify_queued;
+	struct sound_focus_s *notify_next;
+};
+
+typedef struct {
+	pthread_mutex_t lock;
+	sound_focus_h top;
+	sound_focus_h interrupted;
+	int holders[SOUND_FOCUS_PRIORITY_CALL + 1];
+	int exclusive_holders[SOUND_FOCUS_PRIORITY_CALL + 1];
+	sound_focus_h notify_head;
+	sound_focus_h notify_tail;
+	int notifying;
+	pthread_mutex_t session_lock;	/* taken before lock, never while holding it */
+	int exclusive_session;
+}_focus_info_s;
+
+static _focus_info_s g_focus_info = {PTHREAD_MUTEX_INITIALIZER, NULL, NULL, {0, }, {0, }, NULL, NULL, 0, PTHREAD_MUTEX_INITIALIZER, 0};
+
+static void __focus_push(sound_focus_h focus)
+{
+	focus->above = NULL;
+	focus->below = g_focus_info.top;
+	if(g_focus_info.top)
+		g_focus_info.top->above = focus;
+	g_focus_info.top = focus;
+	focus->in_stack = 1;
+
+	g_focus_info.holders[focus->priority]++;
+	if(focus->request == SOUND_FOCUS_REQUEST_GAIN_EXCLUSIVE)
+		g_focus_info.exclusive_holders[focus->priority]++;
+}
+
+static void __focus_unlink(sound_focus_h focus)
+{
+	if(focus->above)
+		focus->above->below = focus->below;
+	else
+		g_focus_info.top = focus->below;
+	if(focus->below)
+		focus->below->above = focus->above;
+
+	if(g_focus_info.interrupted == focus)
+		g_focus_info.interrupted = NULL;
+
+	focus->above = NULL;
+	focus->below = NULL;
+	focus->in_stack = 0;
+
+	g_focus_info.holders[focus->priority]--;
+	if(focus->request == SOUND_FOCUS_REQUEST_GAIN_EXCLUSIVE)
+		g_focus_info.exclusive_holders[focus->priority]--;
+}
+
+static int __focus_is_transient(sound_focus_request_e request)
+{
+	return (request == SOUND_FOCUS_REQUEST_GAIN_TRANSIENT || request == SOUND_FOCUS_REQUEST_GAIN_TRANSIENT_MAY_DUCK);
+}
+
+/* Checked against the holders of every higher class, the requester's own transient focus does not make it the owner of the rest */
+static int __focus_is_granted(sound_focus_h focus, sound_focus_request_e request)
+{
+	int priority;
+
+	for(priority = focus->priority + 1 ; priority <= SOUND_FOCUS_PRIORITY_CALL ; priority++)
+	{
+		/* a lower class may still interject briefly, unless the holder asked for exclusivity */
+		if(__focus_is_transient(request) ? g_focus_info.exclusive_holders[priority] : g_focus_info.holders[priority])
+			return 0;
+	}
+	return 1;
+}
+
+static sound_focus_state_e __focus_loss_state(sound_focus_request_e request)
+{
+	switch(request){
+		case SOUND_FOCUS_REQUEST_GAIN_TRANSIENT:
+			return SOUND_FOCUS_STATE_LOST_TRANSIENT;
+		case SOUND_FOCUS_REQUEST_GAIN_TRANSIENT_MAY_DUCK:
+			return SOUND_FOCUS_STATE_DUCKED;
+		default:
+			return SOUND_FOCUS_STATE_LOST;
+	}
+}
+
+/* Called with session_lock held, only touches mm-session when the stack switches between exclusive and shared ownership */
+static int __focus_apply_session(int exclusive)
+{
+	int ret = MM_ERROR_NONE;
+
+	if(exclusive == g_focus_info.exclusive_session)
+		return MM_ERROR_NONE;
+
+	/* back to the type the application chose once the exclusive holder is gone */
+	ret = _sound_manager_session_init(exclusive ? MM_SESSION_TYPE_EXCLUSIVE : _sound_manager_session_get_app_type());
+	if(ret == MM_ERROR_NONE)
+		g_focus_info.exclusive_session = exclusive;
+
+	return ret;
+}
+
+/* Brings the session in line with the current top once a holder left it */
+static void __focus_sync_session(void)
+{
+	int exclusive;
+
+	pthread_mutex_lock(&g_focus_info.session_lock);
+	pthread_mutex_lock(&g_focus_info.lock);
+	exclusive = (g_focus_info.top && g_focus_info.top->request == SOUND_FOCUS_REQUEST_GAIN_EXCLUSIVE);
+	pthread_mutex_unlock(&g_focus_info.lock);
+
+	if(__focus_apply_session(exclusive) != MM_ERROR_NONE)
+		LOGW("[%s] failed to restore the shared session", __func__);
+	pthread_mutex_unlock(&g_focus_info.session_lock);
+}
+
+static void __focus_set_state(sound_focus_h focus, sound_focus_state_e state)
+{
+	focus->state = state;
+	focus->notify_state = state;
+	if(focus->notify_queued)
+		return;
+
+	focus->notify_queued = 1;
+	focus->notify_next = NULL;
+	if(g_focus_info.notify_tail)
+		g_focus_info.notify_tail->notify_next = focus;
+	else
+		g_focus_info.notify_head = focus;
+	g_focus_info.notify_tail = focus;
+}
+
+static void __focus_dequeue(sound_focus_h focus)
+{
+	sound_focus_h prev = NULL;
+	sound_focus_h cur;
+
+	if(!focus->notify_queued)
+		return;
+
+	/* only a holder which requests again or is destroyed before it was told walks the queue */
+	for(cur = g_focus_info.notify_head ; cur != focus ; cur = cur->notify_next)
+		prev = cur;
+	if(prev)
+		prev->notify_next = focus->notify_next;
+	else
+		g_focus_info.notify_head = focus->notify_next;
+	if(g_focus_info.notify_tail == focus)
+		g_focus_info.notify_tail = prev;
+	focus->notify_queued = 0;
+	focus->notify_next = NULL;
+}
+
+/* Called with the lock held and releases it, the thread already draining the queue delivers what was queued here */
+static void __focus_notify_unlock(void)
+{
+	sound_focus_h focus;
+	sound_focus_state_e state;
+	sound_focus_state_changed_cb user_cb;
+	void *user_data;
+
+	if(g_focus_info.notifying){
+		pthread_mutex_unlock(&g_focus_info.lock);
+		return;
+	}
+
+	g_focus_info.notifying = 1;
+	while((focus = g_focus_info.notify_head) != NULL)
+	{
+		g_focus_info.notify_head = focus->notify_next;
+		if(g_focus_info.notify_head == NULL)
+			g_focus_info.notify_tail = NULL;
+		focus->notify_queued = 0;
+		focus->notify_next = NULL;
+		state = focus->notify_state;
+		user_cb = focus->user_cb;
+		user_data = focus->user_data;
+		pthread_mutex_unlock(&g_focus_info.lock);
+
+		if(user_cb)
+			user_cb(focus, state, user_data);
+
+		pthread_mutex_lock(&g_focus_info.lock);
+	}
+	g_focus_info.notifying = 0;
+	pthread_mutex_unlock(&g_focus_info.lock);
+}
+
+static int __focus_abandon_locked(sound_focus_h focus)
+{
+	int was_top = (g_focus_info.top == focus);
+	sound_focus_h top;
+
+	__focus_unlink(focus);
+	focus->state = SOUND_FOCUS_STATE_NONE;
+
+	/* the session follows the top only */
+	if(!was_top)
+		return 0;
+
+	top = g_focus_info.top;
+	if(top && top->state != SOUND_FOCUS_STATE_GAINED)
+		__focus_set_state(top, SOUND_FOCUS_STATE_GAINED);
+
+	return 1;
+}
+
+void _sound_manager_focus_session_notify(session_msg_t msg, session_event_t event)
+{
+	sound_focus_h top;
+
+	pthread_mutex_lock(&g_focus_info.lock);
+	top = g_focus_info.top;
+	if(msg == MM_SESSION_MSG_RESUME){
+		if(top && top == g_focus_info.interrupted && top->state != SOUND_FOCUS_STATE_GAINED)
+			__focus_set_state(top, SOUND_FOCUS_STATE_GAINED);
+		g_focus_info.interrupted = NULL;
+	}else if(top && top->state == SOUND_FOCUS_STATE_GAINED){
+		g_focus_info.interrupted = top;
+		__focus_set_state(top, SOUND_FOCUS_STATE_LOST_TRANSIENT);
+	}
+	__focus_notify_unlock();
+}
+
+int sound_manager_focus_create(sound_focus_priority_e priority, sound_focus_state_changed_cb callback, void *user_data, sound_focus_h *focus)
+{
+	sound_focus_h handle = NULL;
+
+	if(priority < SOUND_FOCUS_PRIORITY_NOTIFICATION || priority > SOUND_FOCUS_PRIORITY_CALL || focus == NULL)
+		return __convert_sound_manager_error_code(__func__, SOUND_MANAGER_ERROR_INVALID_PARAMETER);
+
+	handle = malloc(sizeof(struct sound_focus_s));
+	if(!handle)
+		return __convert_sound_manager_error_code(__func__, SOUND_MANAGER_ERROR_OUT_OF_MEMORY);
+
+	memset(handle, 0, sizeof(struct sound_focus_s));
+	handle->priority = priority;
+	handle->state = SOUND_FOCUS_STATE_NONE;
+	handle->user_cb = callback;
+	handle->user_data = user_data;
+
+	*focus = handle;
+
+	return SOUND_MANAGER_ERROR_NONE;
+}
+
+int sound_manager_focus_request(sound_focus_h focus, sound_focus_request_e request)
+{
+	int ret = MM_ERROR_NONE;
+	sound_focus_h holder;
+	sound_focus_h below;
+	sound_focus_state_e loss;
+
+	if(focus == NULL || request < SOUND_FOCUS_REQUEST_GAIN || request > SOUND_FOCUS_REQUEST_GAIN_EXCLUSIVE)
+		return __convert_sound_manager_error_code(__func__, SOUND_MANAGER_ERROR_INVALID_PARAMETER);
+
+	/*
+	 * Requests are ordered by session_lock, so the session is switched before the stack
+	 * changes and a failed switch leaves the stack alone. Only abandoning a holder can
+	 * run in between, and that never takes a grant away.
+	 */
+	pthread_mutex_lock(&g_focus_info.session_lock);
+	pthread_mutex_lock(&g_focus_info.lock);
+	if(g_focus_info.top == focus && focus->request == request && focus->state == SOUND_FOCUS_STATE_GAINED){
+		pthread_mutex_unlock(&g_focus_info.lock);
+		pthread_mutex_unlock(&g_focus_info.session_lock);
+		return SOUND_MANAGER_ERROR_NONE;
+	}
+	if(!__focus_is_granted(focus, request)){
+		pthread_mutex_unlock(&g_focus_info.lock);
+		pthread_mutex_unlock(&g_focus_info.session_lock);
+		return __convert_sound_manager_error_code(__func__, SOUND_MANAGER_ERROR_POLICY);
+	}
+	pthread_mutex_unlock(&g_focus_info.lock);
+
+	ret = __focus_apply_session(request == SOUND_FOCUS_REQUEST_GAIN_EXCLUSIVE);
+	if(ret != MM_ERROR_NONE){
+		pthread_mutex_unlock(&g_focus_info.session_lock);
+		return __convert_sound_manager_error_code(__func__, ret);
+	}
+
+	pthread_mutex_lock(&g_focus_info.lock);
+	if(focus->in_stack)
+		__focus_unlink(focus);
+	/* a loss not told yet is stale now */
+	__focus_dequeue(focus);
+	if(__focus_is_transient(request)){
+		/* the holders further down were interrupted already */
+		below = g_focus_info.top;
+		loss = __focus_loss_state(request);
+		if(below && below->state != loss)
+			__focus_set_state(below, loss);
+	}else{
+		while((holder = g_focus_info.top) != NULL)
+		{
+			__focus_unlink(holder);
+			__focus_set_state(holder, SOUND_FOCUS_STATE_LOST);
+		}
+	}
+	focus->request = request;
+	focus->state = SOUND_FOCUS_STATE_GAINED;
+	__focus_push(focus);
+	pthread_mutex_unlock(&g_focus_info.session_lock);
+
+	__focus_notify_unlock();
+
+	return SOUND_MANAGER_ERROR_NONE;
+}
+
+int sound_manager_focus_abandon(sound_focus_h focus)
+{
+	int resync = 0;
+
+	if(focus == NULL)
+		return __convert_sound_manager_error_code(__func__, SOUND_MANAGER_ERROR_INVALID_PARAMETER);
+
+	pthread_mutex_lock(&g_focus_info.lock);
+	if(focus->in_stack)
+		resync = __focus_abandon_locked(focus);
+	else
+		focus->state = SOUND_FOCUS_STATE_NONE;
+	__focus_notify_unlock();
+
+	if(resync)
+		__focus_sync_session();
+
+	return SOUND_MANAGER_ERROR_NONE;
+}
+
+int sound_manager_focus_get_state(sound_focus_h focus, sound_focus_state_e *state)
+{
+	if(focus == NULL || state == NULL)
+		return __convert_sound_manager_error_code(__func__, SOUND_MANAGER_ERROR_INVALID_PARAMETER);
+
+	pthread_mutex_lock(&g_focus_info.lock);
+	*state = focus->state;
+	pthread_mutex_unlock(&g_focus_info.lock);
+
+	return SOUND_MANAGER_ERROR_NONE;
+}
+
+int sound_manager_focus_destroy(sound_focus_h focus)
+{
+	int resync = 0;
+
+	if(focus == NULL)
+		return __convert_sound_manager_error_code(__func__, SOUND_MANAGER_ERROR_INVALID_PARAMETER);
+
+	pthread_mutex_lock(&g_focus_info.lock);
+	if(focus->in_stack)
+		resync = __focus_abandon_locked(focus);
+	__focus_dequeue(focus);
+	__focus_notify_unlock();
+
+	if(resync)
+		__focus_sync_session();
+
+	free(focus);
+
+	return SOUND_MANAGER_ERROR_NONE;
+}
@@ -0,0 +1,449 @@
+/*
+* Copyright (c) 2011 Samsung Electronics Co., Ltd All Rights Reserved
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+
+#define LOG_TAG "TIZEN_N_SOUND_MANGER"
+
+#include <sound_manager.h>
+#include <sound_manager_private.h>
+#include <stdio.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <dlog.h>
+
+/*
+ * Write-behind persistence
+ *
+ * The hooks only update the in-memory record and wake the writer thread,
+ * which copies the record and writes it outside the lock, so a caller never
+ * waits for the disk. The writer keeps min_interval_ms between two writes;
+ * changes made meanwhile are folded into the next one. A write goes to a
+ * temporary file which is synced and renamed over the previous one, and the
+ * directory is synced after the rename, so a crash leaves either the old or
+ * the new record. A write which failed is retried, no sooner than
+ * PERSIST_RETRY_MIN_MS after it, until one succeeds or persistence is unset. The file is a single fixed
+ * size record in host byte order, checked with a FNV-1a sum.
+ */
+#define PERSIST_MAGIC 0x534d5046	/* "SMPF" */
+#define PERSIST_VERSION 1
+#define PERSIST_VOLUME_NUM 8
+#define PERSIST_FLAG_KEY_TYPE 0x1
+#define PERSIST_FLAG_ROUTE 0x2
+#define PERSIST_TEMP_SUFFIX ".tmp"
+#define PERSIST_RETRY_MIN_MS 1000
+
+typedef struct {
+	uint32_t magic;
+	uint16_t version;
+	uint16_t size;
+	uint32_t generation;	/* bumped by every write */
+	uint16_t volume_mask;
+	uint16_t flags;
+	uint16_t volume[PERSIST_VOLUME_NUM];
+	int32_t key_type;
+	int32_t route;
+	uint32_t checksum;	/* of everything before it */
+}_persist_record_s;
+
+typedef struct {
+	pthread_mutex_t lock;
+	pthread_cond_t cond;
+	int enabled;	/* read without the lock on the fast path */
+	int stopping;
+	pthread_t thread;
+	char *path;
+	char *temp_path;
+	char *dir_path;
+	unsigned int min_interval_ms;
+	int dirty;
+	int failing;	/* the last write failed */
+	unsigned long long last_write_us;
+	_persist_record_s record;
+	sound_persistence_stats_s stats;
+}_persist_info_s;
+
+static _persist_info_s g_persist_info = {PTHREAD_MUTEX_INITIALIZER, PTHREAD_COND_INITIALIZER, };
+
+/* serializes set and unset with the writer thread they start and join */
+static pthread_mutex_t g_persist_subscribe_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+static uint32_t __persist_checksum(const _persist_record_s *record)
+{
+	const unsigned char *data = (const unsigned char *)record;
+	uint32_t hash = 2166136261U;
+	size_t i;
+
+	for(i = 0 ; i < offsetof(_persist_record_s, checksum) ; i++)
+		hash = (hash ^ data[i]) * 16777619U;
+	return hash;
+}
+
+static int __persist_load(const char *path, _persist_record_s *record)
+{
+	const _persist_record_s *mapped;
+	struct stat st;
+	int ret = -1;
+	int fd;
+
+	fd = open(path, O_RDONLY | O_CLOEXEC);
+	if(fd < 0){
+		if(errno != ENOENT)
+			LOGE("[%s] failed to open %s (%d)", __func__, path, errno);
+		return -1;
+	}
+	if(fstat(fd, &st) != 0 || st.st_size != sizeof(_persist_record_s)){
+		LOGE("[%s] %s is not a sound manager record", __func__, path);
+		close(fd);
+		return -1;
+	}
+
+	mapped = mmap(NULL, sizeof(_persist_record_s), PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if(mapped == MAP_FAILED){
+		LOGE("[%s] failed to map %s (%d)", __func__, path, errno);
+		return -1;
+	}
+	if(mapped->magic == PERSIST_MAGIC && mapped->version == PERSIST_VERSION && mapped->size == sizeof(_persist_record_s)
+		&& mapped->checksum == __persist_checksum(mapped)){
+		*record = *mapped;
+		ret = 0;
+	}else{
+		LOGE("[%s] %s is damaged, starting empty", __func__, path);
+	}
+	munmap((void *)mapped, sizeof(_persist_record_s));
+
+	return ret;
+}
+
+static int __persist_write(const char *path, const char *temp_path, const char *dir_path, _persist_record_s *record)
+{
+	ssize_t written;
+	int fd;
+
+	record->checksum = __persist_checksum(record);
+
+	fd = open(temp_path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0600);
+	if(fd < 0){
+		LOGE("[%s] failed to create %s (%d)", __func__, temp_path, errno);
+		return -1;
+	}
+	written = write(fd, record, sizeof(_persist_record_s));
+	if(written != sizeof(_persist_record_s) || fsync(fd) != 0){
+		LOGE("[%s] failed to write %s (%d)", __func__, temp_path, errno);
+		close(fd);
+		unlink(temp_path);
+		return -1;
+	}
+	close(fd);
+
+	if(rename(temp_path, path) != 0){
+		LOGE("[%s] failed to replace %s (%d)", __func__, path, errno);
+		unlink(temp_path);
+		return -1;
+	}
+
+	/* the rename is only durable once the directory is */
+	fd = open(dir_path, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+	if(fd < 0 || fsync(fd) != 0){
+		LOGE("[%s] failed to sync %s (%d)", __func__, dir_path, errno);
+		if(fd >= 0)
+			close(fd);
+		return -1;
+	}
+	close(fd);
+	return 0;
+}
+
+static void __persist_due_to_timespec(unsigned long long due_us, struct timespec *ts)
+{
+	/* cond runs on the monotonic clock, see sound_manager_set_persistence() */
+	ts->tv_sec = due_us / 1000000;
+	ts->tv_nsec = (long)(due_us % 1000000) * 1000;
+}
+
+static void *__persist_thread(void *data)
+{
+	_persist_record_s record;
+	unsigned long long due_us;
+	unsigned int interval_ms;
+	struct timespec ts;
+	int ret;
+
+	pthread_mutex_lock(&g_persist_info.lock);
+	while(1){
+		if(!g_persist_info.dirty){
+			if(g_persist_info.stopping)
+				break;
+			pthread_cond_wait(&g_persist_info.cond, &g_persist_info.lock);
+			continue;
+		}
+
+		/* stopping writes at once, the process may be about to exit */
+		interval_ms = g_persist_info.min_interval_ms;
+		if(g_persist_info.failing && interval_ms < PERSIST_RETRY_MIN_MS)
+			interval_ms = PERSIST_RETRY_MIN_MS;
+		due_us = g_persist_info.last_write_us + interval_ms * 1000ULL;
+		if(!g_persist_info.stopping && g_persist_info.last_write_us && _sound_manager_get_time_us() < due_us){
+			__persist_due_to_timespec(due_us, &ts);
+			pthread_cond_timedwait(&g_persist_info.cond, &g_persist_info.lock, &ts);
+			continue;
+		}
+
+		g_persist_info.record.generation++;
+		record = g_persist_info.record;
+		g_persist_info.dirty = 0;
+		pthread_mutex_unlock(&g_persist_info.lock);
+
+		ret = __persist_write(g_persist_info.path, g_persist_info.temp_path, g_persist_info.dir_path, &record);
+
+		pthread_mutex_lock(&g_persist_info.lock);
+		g_persist_info.last_write_us = _sound_manager_get_time_us();
+		g_persist_info.failing = (ret != 0);
+		if(ret == 0){
+			g_persist_info.stats.written++;
+		}else{
+			g_persist_info.stats.failed++;
+			/* the record is retried later, but stopping gives up after its own attempt */
+			if(!g_persist_info.stopping)
+				g_persist_info.dirty = 1;
+		}
+	}
+	pthread_mutex_unlock(&g_persist_info.lock);
+
+	return NULL;
+}
+
+/* called with the lock held once a value changed */
+static void __persist_changed_locked(void)
+{
+	g_persist_info.stats.recorded++;
+	if(!g_persist_info.dirty){
+		g_persist_info.dirty = 1;
+		pthread_cond_signal(&g_persist_info.cond);
+	}
+}
+
+void _sound_manager_persist_volume(sound_type_e type, int volume)
+{
+	if(!__sync_fetch_and_add(&g_persist_info.enabled, 0))
+		return;
+	if(type < 0 || type > MAX_VOLUME_TYPE || volume < 0 || volume > UINT16_MAX)
+		return;
+
+	pthread_mutex_lock(&g_persist_info.lock);
+	if(__sync_fetch_and_add(&g_persist_info.enabled, 0)
+		&& (!(g_persist_info.record.volume_mask & (1 << type)) || g_persist_info.record.volume[type] != volume)){
+		g_persist_info.record.volume[type] = volume;
+		g_persist_info.record.volume_mask |= (1 << type);
+		__persist_changed_locked();
+	}
+	pthread_mutex_unlock(&g_persist_info.lock);
+}
+
+void _sound_manager_persist_key_type(volume_key_type_e type)
+{
+	if(!__sync_fetch_and_add(&g_persist_info.enabled, 0))
+		return;
+
+	pthread_mutex_lock(&g_persist_info.lock);
+	if(__sync_fetch_and_add(&g_persist_info.enabled, 0)
+		&& (!(g_persist_info.record.flags & PERSIST_FLAG_KEY_TYPE) || g_persist_info.record.key_type != type)){
+		g_persist_info.record.key_type = type;
+		g_persist_info.record.flags |= PERSIST_FLAG_KEY_TYPE;
+		__persist_changed_locked();
+	}
+	pthread_mutex_unlock(&g_persist_info.lock);
+}
+
+void _sound_manager_persist_route(sound_route_e route)
+{
+	if(!__sync_fetch_and_add(&g_persist_info.enabled, 0))
+		return;
+
+	pthread_mutex_lock(&g_persist_info.lock);
+	if(__sync_fetch_and_add(&g_persist_info.enabled, 0)
+		&& (!(g_persist_info.record.flags & PERSIST_FLAG_ROUTE) || g_persist_info.record.route != route)){
+		g_persist_info.record.route = route;
+		g_persist_info.record.flags |= PERSIST_FLAG_ROUTE;
+		__persist_changed_locked();
+	}
+	pthread_mutex_unlock(&g_persist_info.lock);
+}
+
+static void __persist_disable(void)
+{
+	pthread_mutex_lock(&g_persist_info.lock);
+	__sync_lock_test_and_set(&g_persist_info.enabled, 0);
+	g_persist_info.stopping = 1;
+	pthread_cond_signal(&g_persist_info.cond);
+	pthread_mutex_unlock(&g_persist_info.lock);
+
+	/* the thread writes what is pending before it leaves */
+	pthread_join(g_persist_info.thread, NULL);
+
+	free(g_persist_info.path);
+	free(g_persist_info.temp_path);
+	free(g_persist_info.dir_path);
+	g_persist_info.path = NULL;
+	g_persist_info.temp_path = NULL;
+	g_persist_info.dir_path = NULL;
+}
+
+int sound_manager_set_persistence(const char *path, unsigned int min_interval_ms)
+{
+	if(path == NULL || path[0] == '\0')
+		return __convert_sound_manager_error_code(__func__, SOUND_MANAGER_ERROR_INVALID_PARAMETER);
+	_persist_record_s record;
+	pthread_condattr_t attr;
+	char *path_copy;
+	char *temp_path;
+	char *dir_path;
+	char *slash;
+	int type;
+	int ret;
+
+	path_copy = strdup(path);
+	temp_path = malloc(strlen(path) + sizeof(PERSIST_TEMP_SUFFIX));
+	slash = strrchr(path, '/');
+	if(slash == NULL)
+		dir_path = strdup(".");
+	else if(slash == path)
+		dir_path = strdup("/");
+	else
+		dir_path = strndup(path, slash - path);
+	if(path_copy == NULL || temp_path == NULL || dir_path == NULL){
+		free(path_copy);
+		free(temp_path);
+		free(dir_path);
+		return __convert_sound_manager_error_code(__func__, SOUND_MANAGER_ERROR_OUT_OF_MEMORY);
+	}
+	sprintf(temp_path, "%s%s", path, PERSIST_TEMP_SUFFIX);
+
+	memset(&record, 0, sizeof(_persist_record_s));
+	if(__persist_load(path, &record) != 0){
+		memset(&record, 0, sizeof(_persist_record_s));
+		record.magic = PERSIST_MAGIC;
+		record.version = PERSIST_VERSION;
+		record.size = sizeof(_persist_record_s);
+	}
+
+	pthread_mutex_lock(&g_persist_subscribe_mutex);
+	if(__sync_fetch_and_add(&g_persist_info.enabled, 0))
+		__persist_disable();
+
+	pthread_mutex_lock(&g_persist_info.lock);
+	g_persist_info.path = path_copy;
+	g_persist_info.temp_path = temp_path;
+	g_persist_info.dir_path = dir_path;
+	g_persist_info.min_interval_ms = min_interval_ms;
+	g_persist_info.stopping = 0;
+	g_persist_info.dirty = 0;
+	g_persist_info.failing = 0;
+	g_persist_info.last_write_us = 0;
+	g_persist_info.record = record;
+	memset(&g_persist_info.stats, 0, sizeof(sound_persistence_stats_s));
+
+	pthread_condattr_init(&attr);
+	pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+	pthread_cond_destroy(&g_persist_info.cond);
+	pthread_cond_init(&g_persist_info.cond, &attr);
+	pthread_condattr_destroy(&attr);
+
+	ret = pthread_create(&g_persist_info.thread, NULL, __persist_thread, NULL);
+	if(ret != 0){
+		LOGE("[%s] failed to create the persistence thread (%d)", __func__, ret);
+		g_persist_info.path = NULL;
+		g_persist_info.temp_path = NULL;
+		g_persist_info.dir_path = NULL;
+		pthread_mutex_unlock(&g_persist_info.lock);
+		pthread_mutex_unlock(&g_persist_subscribe_mutex);
+		free(path_copy);
+		free(temp_path);
+		free(dir_path);
+		return __convert_sound_manager_error_code(__func__, SOUND_MANAGER_ERROR_INVALID_OPERATION);
+	}
+	__sync_lock_test_and_set(&g_persist_info.enabled, 1);
+	pthread_mutex_unlock(&g_persist_info.lock);
+	pthread_mutex_unlock(&g_persist_subscribe_mutex);
+
+	for(type = 0 ; type <= MAX_VOLUME_TYPE ; type++)
+	{
+		if(record.volume_mask & (1 << type))
+			_sound_manager_volume_seed(type, record.volume[type]);
+	}
+
+	return SOUND_MANAGER_ERROR_NONE;
+}
+
+void sound_manager_unset_persistence(void)
+{
+	pthread_mutex_lock(&g_persist_subscribe_mutex);
+	if(__sync_fetch_and_add(&g_persist_info.enabled, 0))
+		__persist_disable();
+	pthread_mutex_unlock(&g_persist_subscribe_mutex);
+}
+
+int sound_manager_get_persisted_state(sound_persisted_state_s *state)
+{
+	if(state == NULL)
+		return __convert_sound_manager_error_code(__func__, SOUND_MANAGER_ERROR_INVALID_PARAMETER);
+	_persist_record_s record;
+	int type;
+
+	pthread_mutex_lock(&g_persist_info.lock);
+	if(!__sync_fetch_and_add(&g_persist_info.enabled, 0)){
+		pthread_mutex_unlock(&g_persist_info.lock);
+		return __convert_sound_manager_error_code(__func__, SOUND_MANAGER_ERROR_INVALID_OPERATION);
+	}
+	record = g_persist_info.record;
+	pthread_mutex_unlock(&g_persist_info.lock);
+
+	memset(state, 0, sizeof(sound_persisted_state_s));
+	for(type = 0 ; type <= MAX_VOLUME_TYPE ; type++)
+	{
+		if(!(record.volume_mask & (1 << type)))
+			continue;
+		state->volume[type] = record.volume[type];
+		state->volume_mask |= (1 << type);
+	}
+	state->key_type_known = (record.flags & PERSIST_FLAG_KEY_TYPE) != 0;
+	state->key_type = record.key_type;
+	state->route_known = (record.flags & PERSIST_FLAG_ROUTE) != 0;
+	state->route = record.route;
+
+	return SOUND_MANAGER_ERROR_NONE;
+}
+
+int sound_manager_get_persistence_stats(sound_persistence_stats_s *stats)
+{
+	if(stats == NULL)
+		return __convert_sound_manager_error_code(__func__, SOUND_MANAGER_ERROR_INVALID_PARAMETER);
+
+	pthread_mutex_lock(&g_persist_info.lock);
+	*stats = g_persist_info.stats;
+	pthread_mutex_unlock(&g_persist_info.lock);
+
+	return SOUND_MANAGER_ERROR_NONE;
+}
@@ -0,0 +1,242 @@
+/*
+* Copyright (c) 2011 Samsung Electronics Co., Ltd All Rights Reserved
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+
+#define LOG_TAG "TIZEN_N_SOUND_MANGER"
+
+#include <sound_manager.h>
+#include <sound_manager_private.h>
+
+/*
+ * Reduced profiles
+ *
+ * The no-session and volume-only builds leave sources out, but keep exporting every
+ * function of sound_manager.h, so an application linked against the full library
+ * still loads and finds out at run time that the feature is missing.
+ */
+
+#ifdef SOUND_MANAGER_DISABLE_SESSION
+int sound_manager_set_session_type(sound_session_type_e type)
+{
+	return __convert_sound_manager_error_code(__func__, SOUND_MANAGER_ERROR_INVALID_OPERATION);
+}
+
+int sound_manager_set_session_notify_cb(sound_session_notify_cb callback, void *user_data)
+{
+	return __convert_sound_manager_error_code(__func__, SOUND_MANAGER_ERROR_INVALID_OPERATION);
+}
+
+void sound_manager_unset_session_notify_cb(void)
+{
+}
+
+int sound_manager_set_interrupted_cb(sound_interrupted_cb callback, void *user_data)
+{
+	return __convert_sound_manager_error_code(__func__, SOUND_MANAGER_ERROR_INVALID_OPERATION);
+}
+
+void sound_manager_unset_interrupted_cb(void)
+{
+}
+
+int sound_manager_call_session_create(sound_call_session_type_e type, sound_call_session_h *session)
+{
+	return __convert_sound_manager_error_code(__func__, SOUND_MANAGER_ERROR_INVALID_OPERATION);
+}
+
+int sound_manager_call_session_prepare(sound_call_session_type_e type, sound_call_session_h *session)
+{
+	return __convert_sound_manager_error_code(__func__, SOUND_MANAGER_ERROR_INVALID_OPERATION);
+}
+
+int sound_manager_call_session_activate(sound_call_session_h session)
+{
+	return __convert_sound_manager_error_code(__func__, SOUND_MANAGER_ERROR_INVALID_OPERATION);
+}
+
+int sound_manager_call_session_set_mode(sound_call_session_h session, sound_call_session_mode_e mode)
+{
+	return __convert_sound_manager_error_code(__func__, SOUND_MANAGER_ERROR_INVALID_OPERATION);
+}
+
+int sound_manager_call_session_get_mode(sound_call_session_h session, sound_call_session_mode_e *mode)
+{
+	return __convert_sound_manager_error_code(__func__, SOUND_MANAGER_ERROR_INVALID_OPERATION);
+}
+
+int sound_manager_call_session_get_type(sound_call_session_h session, sound_call_session_type_e *type)
+{
+	return __convert_sound_manager_error_code(__func__, SOUND_MANAGER_ERROR_INVALID_OPERATION);
+}
+
+int sound_manager_call_session_destroy(sound_call_session_h session)
+{
+	return __convert_sound_manager_error_code(__func__, SOUND_MANAGER_ERROR_INVALID_OPERATION);
+}
+
+int sound_manager_enable_auto_ducking(double ducked_gain, unsigned int attack_ms, unsigned int release_ms)
+{
+	return __convert_sound_manager_error_code(__func__, SOUND_MANAGER_ERROR_INVALID_OPERATION);
+}
+
+int sound_manager_disable_auto_ducking(void)
+{
+	return __convert_sound_manager_error_code(__func__, SOUND_MANAGER_ERROR_INVALID_OPERATION);
+}
+
+int sound_manager_get_auto_ducking_gain(double *gain)
+{
+	return __convert_sound_manager_error_code(__func__, SOUND_MANAGER_ERROR_INVALID_OPERATION);
+}
+
+int sound_manager_transaction_create(sound_transaction_h *transaction)
+{
+	return __convert_sound_manager_error_code(__func__, SOUND_MANAGER_ERROR_INVALID_OPERATION);
+}
+
+int sound_manager_transaction_set_call_session(sound_transaction_h transaction, sound_call_session_type_e type, sound_call_session_mode_e mode)
+{
+	return __convert_sound_manager_error_code(__func__, SOUND_MANAGER_ERROR_INVALID_OPERATION);
+}
+
+int sound_manager_transaction_set_active_route(sound_transaction_h transaction, sound_route_e route)
+{
+	return __convert_sound_manager_error_code(__func__, SOUND_MANAGER_ERROR_INVALID_OPERATION);
+}
+
+int sound_manager_transaction_set_volume(sound_transaction_h transaction, sound_type_e type, int volume)
+{
+	return __convert_sound_manager_error_code(__func__, SOUND_MANAGER_ERROR_INVALID_OPERATION);
+}
+
+int sound_manager_transaction_commit(sound_transaction_h transaction, sound_call_session_h *session)
+{
+	return __convert_sound_manager_error_code(__func__, SOUND_MANAGER_ERROR_INVALID_OPERATION);
+}
+
+int sound_manager_transaction_destroy(sound_transaction_h transaction)
+{
+	return __convert_sound_manager_error_code(__func__, SOUND_MANAGER_ERROR_INVALID_OPERATION);
+}
+
+int sound_manager_focus_create(sound_focus_priority_e priority, sound_focus_state_changed_cb callback, void *user_data, sound_focus_h *focus)
+{
+	return __convert_sound_manager_error_code(__func__, SOUND_MANAGER_ERROR_INVALID_OPERATION);
+}
+
+int sound_manager_focus_request(sound_focus_h focus, sound_focus_request_e request)
+{
+	return __convert_sound_manager_error_code(__func__, SOUND_MANAGER_ERROR_INVALID_OPERATION);
+}
+
+int sound_manager_focus_abandon(sound_focus_h focus)
+{
+	return __convert_sound_manager_error_code(__func__, SOUND_MANAGER_ERROR_INVALID_OPERATION);
+}
+
+int sound_manager_focus_get_state(sound_focus_h focus, sound_focus_state_e *state)
+{
+	return __convert_sound_manager_error_code(__func__, SOUND_MANAGER_ERROR_INVALID_OPERATION);
+}
+
+int sound_manager_focus_destroy(sound_focus_h focus)
+{
+	return __convert_sound_manager_error_code(__func__, SOUND_MANAGER_ERROR_INVALID_OPERATION);
+}
+#endif /* SOUND_MANAGER_DISABLE_SESSION */
+
+#ifdef SOUND_MANAGER_DISABLE_ROUTE
+int sound_manager_get_a2dp_status(bool *connected, char **bt_name)
+{
+	return __convert_sound_manager_error_code(__func__, SOUND_MANAGER_ERROR_INVALID_OPERATION);
+}
+
+int sound_manager_foreach_available_route(sound_available_route_cb callback, void *user_data)
+{
+	return __convert_sound_manager_error_code(__func__, SOUND_MANAGER_ERROR_INVALID_OPERATION);
+}
+
+int sound_manager_get_available_routes(sound_route_e *routes, int capacity, int *count)
+{
+	return __convert_sound_manager_error_code(__func__, SOUND_MANAGER_ERROR_INVALID_OPERATION);
+}
+
+int sound_manager_set_active_route(sound_route_e route)
+{
+	return __convert_sound_manager_error_code(__func__, SOUND_MANAGER_ERROR_INVALID_OPERATION);
+}
+
+int sound_manager_get_active_device(sound_device_in_e *in, sound_device_out_e *out)
+{
+	return __convert_sound_manager_error_code(__func__, SOUND_MANAGER_ERROR_INVALID_OPERATION);
+}
+
+bool sound_manager_is_route_available(sound_route_e route)
+{
+	return false;
+}
+
+int sound_manager_set_available_route_changed_cb(sound_available_route_changed_cb callback, void *user_data)
+{
+	return __convert_sound_manager_error_code(__func__, SOUND_MANAGER_ERROR_INVALID_OPERATION);
+}
+
+void sound_manager_unset_available_route_changed_cb(void)
+{
+}
+
+int sound_manager_set_active_device_changed_cb(sound_active_device_changed_cb callback, void *user_data)
+{
+	return __convert_sound_manager_error_code(__func__, SOUND_MANAGER_ERROR_INVALID_OPERATION);
+}
+
+void sound_manager_unset_active_device_changed_cb(void)
+{
+}
+
+int sound_manager_set_active_device_diff_cb(sound_active_device_diff_cb callback, void *user_data)
+{
+	return __convert_sound_manager_error_code(__func__, SOUND_MANAGER_ERROR_INVALID_OPERATION);
+}
+
+void sound_manager_unset_active_device_diff_cb(void)
+{
+}
+
+int sound_manager_set_available_route_diff_cb(sound_available_route_diff_cb callback, void *user_data)
+{
+	return __convert_sound_manager_error_code(__func__, SOUND_MANAGER_ERROR_INVALID_OPERATION);
+}
+
+void sound_manager_unset_available_route_diff_cb(void)
+{
+}
+
+int sound_manager_route_policy_get_available_routes(unsigned int devices, sound_route_e *routes, int capacity, int *count)
+{
+	return __convert_sound_manager_error_code(__func__, SOUND_MANAGER_ERROR_INVALID_OPERATION);
+}
+
+int sound_manager_route_policy_get_default_route(unsigned int devices, sound_route_e *route)
+{
+	return __convert_sound_manager_error_code(__func__, SOUND_MANAGER_ERROR_INVALID_OPERATION);
+}
+
+int sound_manager_route_policy_is_route_available(unsigned int devices, sound_route_e route, bool *available)
+{
+	return __convert_sound_manager_error_code(__func__, SOUND_MANAGER_ERROR_INVALID_OPERATION);
+}
+#endif /* SOUND_MANAGER_DISABLE_ROUTE */
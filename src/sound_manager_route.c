@@ -0,0 +1,677 @@
+/*
+* Copyright (c) 2011 Samsung Electronics Co., Ltd All Rights Reserved
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+
+#define LOG_TAG "TIZEN_N_SOUND_MANGER"
+
+#include <sound_manager.h>
+#include <sound_manager_private.h>
+#include <mm_sound.h>
+#include <mm_sound_private.h>
+#include <stdio.h>
+#include <string.h>
+#include <malloc.h>
+#include <pthread.h>
+#include <dlog.h>
+
+/*
+ * Routes and devices
+ *
+ * Left out of the build with the volume-only profile.
+ */
+typedef struct {
+	void *user_data;
+	sound_available_route_changed_cb user_cb;
+}_changed_available_route_info_s;
+
+typedef struct {
+	void *user_data;
+	sound_active_device_changed_cb user_cb;
+}_changed_active_device_info_s;
+
+typedef struct {
+	void *user_data;
+	sound_available_route_diff_cb user_cb;
+}_available_route_diff_info_s;
+
+typedef struct {
+	void *user_data;
+	sound_active_device_diff_cb user_cb;
+}_active_device_diff_info_s;
+
+/* available routes, current only while the route change notification is registered */
+typedef struct {
+	int monitored;
+	int batched;	/* the batched event subscription keeps the notification registered */
+	int valid;
+	unsigned int generation;	/* bumped on every change notification */
+	int count;
+	sound_route_e route[MAX_ROUTE_NUM];
+}_route_cache_s;
+
+/* last notified devices, current only while the device change notification is registered */
+typedef struct {
+	int monitored;
+	int batched;	/* the batched event subscription keeps the notification registered */
+	int known;
+	unsigned int generation;	/* bumped on every change notification */
+	unsigned int sequence;	/* of the last change delivered to the diff callback */
+	sound_device_in_e in;
+	sound_device_out_e out;
+}_active_device_state_s;
+
+static _changed_available_route_info_s g_available_route_changed_cb_table;
+static _available_route_diff_info_s g_available_route_diff_cb_table;
+static _route_cache_s g_route_cache;
+static unsigned int g_route_sequence;
+
+/* guards the available route callbacks, g_route_cache and g_route_sequence */
+static pthread_mutex_t g_route_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+static _changed_active_device_info_s g_active_device_changed_cb_table;
+static _active_device_diff_info_s g_active_device_diff_cb_table;
+static _active_device_state_s g_active_device;
+
+/* guards the active device callbacks and g_active_device */
+static pthread_mutex_t g_device_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+static int __backend_get_active_device(int arg, int *values)
+{
+	mm_sound_device_in in = 0;
+	mm_sound_device_out out = 0;
+	int ret = mm_sound_get_active_device(&in, &out);
+
+	values[0] = in;
+	values[1] = out;
+	return ret;
+}
+
+static int __backend_set_active_route(int route, int *values)
+{
+	return mm_sound_set_active_route(route);
+}
+
+int sound_manager_get_a2dp_status(bool *connected , char** bt_name){
+	int ret = mm_sound_route_get_a2dp_status((int*)connected , bt_name);
+
+	return __convert_sound_manager_error_code(__func__, ret);
+}
+
+typedef struct {
+	sound_route_e *route;
+	int capacity;
+	int count;
+}_route_array_s;
+
+static bool __route_array_add_cb(mm_sound_route route, void *user_data)
+{
+	_route_array_s *array = (_route_array_s *)user_data;
+
+	if(array->count < array->capacity)
+		array->route[array->count] = route;
+	array->count++;
+	return true;
+}
+
+/* Copies the cached routes, returns -1 if the cache is not current */
+static int __route_cache_copy(sound_route_e *route, int capacity)
+{
+	int count = -1;
+
+	pthread_mutex_lock(&g_route_mutex);
+	if(g_route_cache.valid){
+		count = g_route_cache.count;
+		if(capacity > 0)
+			memcpy(route, g_route_cache.route, sizeof(sound_route_e) * (count < capacity ? count : capacity));
+	}
+	pthread_mutex_unlock(&g_route_mutex);
+
+	return count;
+}
+
+/* Walks the backend into @a array and keeps the result when no change was notified meanwhile */
+static int __route_cache_fill(_route_array_s *array)
+{
+	unsigned int generation;
+	int monitored;
+	int ret;
+
+	pthread_mutex_lock(&g_route_mutex);
+	monitored = g_route_cache.monitored;
+	generation = g_route_cache.generation;
+	pthread_mutex_unlock(&g_route_mutex);
+
+	ret = mm_sound_foreach_available_route_cb(__route_array_add_cb, array);
+	if(ret != MM_ERROR_NONE || !monitored || array->count > array->capacity || array->count > MAX_ROUTE_NUM)
+		return ret;
+
+	pthread_mutex_lock(&g_route_mutex);
+	if(g_route_cache.monitored && g_route_cache.generation == generation){
+		memcpy(g_route_cache.route, array->route, sizeof(sound_route_e) * array->count);
+		g_route_cache.count = array->count;
+		g_route_cache.valid = 1;
+	}
+	pthread_mutex_unlock(&g_route_mutex);
+
+	return ret;
+}
+
+static void __route_cache_update_locked(sound_route_e route, bool available)
+{
+	int i;
+
+	g_route_cache.generation++;
+	if(!g_route_cache.valid)
+		return;
+
+	for(i = 0 ; i < g_route_cache.count ; i++)
+	{
+		if(g_route_cache.route[i] == route)
+			break;
+	}
+	if(available && i == g_route_cache.count){
+		if(g_route_cache.count == MAX_ROUTE_NUM){
+			g_route_cache.valid = 0;
+			return;
+		}
+		g_route_cache.route[g_route_cache.count++] = route;
+	}else if(!available && i < g_route_cache.count){
+		memmove(&g_route_cache.route[i], &g_route_cache.route[i + 1], sizeof(sound_route_e) * (g_route_cache.count - i - 1));
+		g_route_cache.count--;
+	}
+}
+
+/* Returns non-zero if @a route is in the cache, -1 if the cache is not current */
+static int __route_cache_find_locked(sound_route_e route)
+{
+	int i;
+
+	if(!g_route_cache.valid)
+		return -1;
+	for(i = 0 ; i < g_route_cache.count ; i++)
+	{
+		if(g_route_cache.route[i] == route)
+			return 1;
+	}
+	return 0;
+}
+
+static void __available_route_changed_cb(mm_sound_route route, bool available, void *user_data)
+{
+	_changed_available_route_info_s cb_info;
+	_available_route_diff_info_s diff_info;
+	sound_available_route_change_s change;
+	_sound_manager_event_s event;
+	int previous;
+
+	_sound_manager_event_receive(&event, SOUND_EVENT_AVAILABLE_ROUTE_CHANGED);
+	pthread_mutex_lock(&g_route_mutex);
+	previous = __route_cache_find_locked(route);
+	__route_cache_update_locked(route, available);
+	cb_info = g_available_route_changed_cb_table;
+	diff_info = g_available_route_diff_cb_table;
+	if(previous == (available ? 1 : 0)){
+		/* repeated notification */
+		diff_info.user_cb = NULL;
+	}else if(diff_info.user_cb){
+		change.sequence = ++g_route_sequence;
+		change.route = route;
+		change.previous_available = previous < 0 ? !available : previous;
+		change.available = available;
+	}
+	pthread_mutex_unlock(&g_route_mutex);
+
+	_sound_manager_event_batch_push(SOUND_EVENT_AVAILABLE_ROUTE_CHANGED, route, available);
+	if(cb_info.user_cb || diff_info.user_cb)
+		_sound_manager_event_deliver_begin(&event);
+	if(cb_info.user_cb)
+		cb_info.user_cb(route, available, cb_info.user_data);
+	if(diff_info.user_cb)
+		diff_info.user_cb(&change, diff_info.user_data);
+	if(cb_info.user_cb || diff_info.user_cb)
+		_sound_manager_event_deliver_end(&event);
+}
+
+static void __active_device_changed_cb(mm_sound_device_in in, mm_sound_device_out out, void *user_data)
+{
+	_changed_active_device_info_s cb_info;
+	_active_device_diff_info_s diff_info;
+	sound_active_device_change_s change;
+	_sound_manager_event_s event;
+	int values[2] = {in, out};
+
+	_sound_manager_event_receive(&event, SOUND_EVENT_ACTIVE_DEVICE_CHANGED);
+	pthread_mutex_lock(&g_device_mutex);
+	cb_info = g_active_device_changed_cb_table;
+	diff_info = g_active_device_diff_cb_table;
+	if(g_active_device.known && g_active_device.in == in && g_active_device.out == out){
+		/* repeated notification */
+		diff_info.user_cb = NULL;
+	}else if(diff_info.user_cb){
+		change.sequence = ++g_active_device.sequence;
+		change.previous_in = g_active_device.known ? g_active_device.in : in;
+		change.previous_out = g_active_device.known ? g_active_device.out : out;
+		change.in = in;
+		change.out = out;
+	}
+	g_active_device.in = in;
+	g_active_device.out = out;
+	g_active_device.known = 1;
+	g_active_device.generation++;
+	pthread_mutex_unlock(&g_device_mutex);
+
+	/* the notification is newer than anything the getter could have seen */
+	_sound_manager_backend_update(SOUND_MANAGER_BACKEND_SLOT_ACTIVE_DEVICE, values);
+	_sound_manager_event_batch_push(SOUND_EVENT_ACTIVE_DEVICE_CHANGED, in, out);
+
+	if(cb_info.user_cb || diff_info.user_cb)
+		_sound_manager_event_deliver_begin(&event);
+	if(cb_info.user_cb)
+		cb_info.user_cb(in, out, cb_info.user_data);
+	if(diff_info.user_cb)
+		diff_info.user_cb(&change, diff_info.user_data);
+	if(cb_info.user_cb || diff_info.user_cb)
+		_sound_manager_event_deliver_end(&event);
+}
+
+int sound_manager_foreach_available_route (sound_available_route_cb callback, void *user_data)
+{
+	if(callback == NULL)
+		return __convert_sound_manager_error_code(__func__, SOUND_MANAGER_ERROR_INVALID_PARAMETER);
+	sound_route_e route[MAX_ROUTE_NUM];
+	int count;
+	int i;
+	int ret;
+
+	/* walk a snapshot, so the callback does not hold up the sound server */
+	count = __route_cache_copy(route, MAX_ROUTE_NUM);
+	if(count < 0){
+		_route_array_s array = {route, MAX_ROUTE_NUM, 0};
+		ret = __route_cache_fill(&array);
+		if(ret != MM_ERROR_NONE)
+			return __convert_sound_manager_error_code(__func__, ret);
+		count = array.count;
+	}
+	if(count > MAX_ROUTE_NUM){
+		ret = mm_sound_foreach_available_route_cb((mm_sound_available_route_cb)callback, user_data);
+		return __convert_sound_manager_error_code(__func__, ret);
+	}
+
+	for(i = 0 ; i < count ; i++)
+	{
+		if(!callback(route[i], user_data))
+			break;
+	}
+
+	return SOUND_MANAGER_ERROR_NONE;
+}
+
+int sound_manager_get_available_routes(sound_route_e *routes, int capacity, int *count)
+{
+	if(capacity < 0 || (routes == NULL && capacity > 0) || count == NULL)
+		return __convert_sound_manager_error_code(__func__, SOUND_MANAGER_ERROR_INVALID_PARAMETER);
+	sound_route_e route[MAX_ROUTE_NUM];
+	_route_array_s array = {routes, capacity, 0};
+	int ret;
+
+	*count = __route_cache_copy(routes, capacity);
+	if(*count >= 0)
+		return SOUND_MANAGER_ERROR_NONE;
+
+	/* while monitored, walk into a full size buffer so the result can be cached */
+	if(capacity < MAX_ROUTE_NUM){
+		array.route = route;
+		array.capacity = MAX_ROUTE_NUM;
+	}
+	ret = __route_cache_fill(&array);
+	if(array.route != routes && capacity > 0)
+		memcpy(routes, route, sizeof(sound_route_e) * (array.count < capacity ? array.count : capacity));
+	*count = array.count;
+
+	return __convert_sound_manager_error_code(__func__, ret);
+}
+
+int sound_manager_set_active_route (sound_route_e route)
+{
+	int ret;
+	ret = _sound_manager_backend_request(__backend_set_active_route, route, NULL);
+	if(ret == MM_ERROR_NONE)
+		_sound_manager_persist_route(route);
+
+	return __convert_sound_manager_error_code(__func__, ret);
+}
+
+int sound_manager_get_active_device (sound_device_in_e *in, sound_device_out_e *out)
+{
+	if(in == NULL || out == NULL)
+		return __convert_sound_manager_error_code(__func__, SOUND_MANAGER_ERROR_INVALID_PARAMETER);
+	int values[2];
+	int stale;
+	int ret = _sound_manager_backend_call(SOUND_MANAGER_BACKEND_SLOT_ACTIVE_DEVICE, __backend_get_active_device, 0, values, &stale);
+	if(ret == MM_ERROR_NONE){
+		*in = values[0];
+		*out = values[1];
+	}
+	if(stale)
+		ret = SOUND_MANAGER_ERROR_STALE_VALUE;
+
+	return __convert_sound_manager_error_code(__func__, ret);
+}
+
+bool sound_manager_is_route_available (sound_route_e route)
+{
+	bool is_available;
+	int cached;
+
+	if(_sound_manager_route_policy_find(route) < 0)
+		return false;
+
+	pthread_mutex_lock(&g_route_mutex);
+	cached = __route_cache_find_locked(route);
+	pthread_mutex_unlock(&g_route_mutex);
+	if(cached >= 0)
+		return cached;
+
+	mm_sound_is_route_available(route, &is_available);
+
+	return is_available;
+}
+
+static int __route_monitor_start_locked(void)
+{
+	int ret = MM_ERROR_NONE;
+
+	if(!g_route_cache.monitored){
+		ret = mm_sound_add_available_route_changed_callback(__available_route_changed_cb, NULL);
+		if(ret == MM_ERROR_NONE)
+			g_route_cache.monitored = 1;
+	}
+	return ret;
+}
+
+/* Unregisters from the sound server once neither callback is left */
+static void __route_monitor_stop_locked(void)
+{
+	if(g_available_route_changed_cb_table.user_cb || g_available_route_diff_cb_table.user_cb || g_route_cache.batched)
+		return;
+	if(g_route_cache.monitored)
+		mm_sound_remove_available_route_changed_callback();
+	g_route_cache.monitored = 0;
+	g_route_cache.valid = 0;
+}
+
+int sound_manager_set_available_route_changed_cb (sound_available_route_changed_cb callback, void *user_data)
+{
+	if(callback == NULL)
+		return __convert_sound_manager_error_code(__func__, SOUND_MANAGER_ERROR_INVALID_PARAMETER);
+	int ret;
+
+	pthread_mutex_lock(&g_route_mutex);
+	ret = __route_monitor_start_locked();
+	if(ret == MM_ERROR_NONE){
+		g_available_route_changed_cb_table.user_cb = callback;
+		g_available_route_changed_cb_table.user_data = user_data;
+	}
+	pthread_mutex_unlock(&g_route_mutex);
+
+	return __convert_sound_manager_error_code(__func__, ret);
+}
+
+void sound_manager_unset_available_route_changed_cb (void)
+{
+	pthread_mutex_lock(&g_route_mutex);
+	g_available_route_changed_cb_table.user_cb = NULL;
+	g_available_route_changed_cb_table.user_data = NULL;
+	__route_monitor_stop_locked();
+	pthread_mutex_unlock(&g_route_mutex);
+}
+
+int sound_manager_set_available_route_diff_cb(sound_available_route_diff_cb callback, void *user_data)
+{
+	if(callback == NULL)
+		return __convert_sound_manager_error_code(__func__, SOUND_MANAGER_ERROR_INVALID_PARAMETER);
+	sound_route_e route[MAX_ROUTE_NUM];
+	_route_array_s array = {route, MAX_ROUTE_NUM, 0};
+	int valid;
+	int ret;
+
+	pthread_mutex_lock(&g_route_mutex);
+	ret = __route_monitor_start_locked();
+	if(ret == MM_ERROR_NONE){
+		g_available_route_diff_cb_table.user_cb = callback;
+		g_available_route_diff_cb_table.user_data = user_data;
+	}
+	valid = g_route_cache.valid;
+	pthread_mutex_unlock(&g_route_mutex);
+
+	/* the cache is the previous state, without it changes are delivered as they come */
+	if(ret == MM_ERROR_NONE && !valid)
+		__route_cache_fill(&array);
+
+	return __convert_sound_manager_error_code(__func__, ret);
+}
+
+void sound_manager_unset_available_route_diff_cb(void)
+{
+	pthread_mutex_lock(&g_route_mutex);
+	g_available_route_diff_cb_table.user_cb = NULL;
+	g_available_route_diff_cb_table.user_data = NULL;
+	__route_monitor_stop_locked();
+	pthread_mutex_unlock(&g_route_mutex);
+}
+
+static int __device_monitor_start_locked(void)
+{
+	int ret = MM_ERROR_NONE;
+
+	if(!g_active_device.monitored){
+		ret = mm_sound_add_active_device_changed_callback(__active_device_changed_cb, NULL);
+		if(ret == MM_ERROR_NONE)
+			g_active_device.monitored = 1;
+	}
+	return ret;
+}
+
+/* Unregisters from the sound server once neither callback is left */
+static void __device_monitor_stop_locked(void)
+{
+	if(g_active_device_changed_cb_table.user_cb || g_active_device_diff_cb_table.user_cb || g_active_device.batched)
+		return;
+	if(g_active_device.monitored)
+		mm_sound_remove_active_device_changed_callback();
+	g_active_device.monitored = 0;
+	g_active_device.known = 0;
+}
+
+int sound_manager_set_active_device_changed_cb (sound_active_device_changed_cb callback, void *user_data)
+{
+	if(callback == NULL)
+		return __convert_sound_manager_error_code(__func__, SOUND_MANAGER_ERROR_INVALID_PARAMETER);
+	int ret;
+
+	pthread_mutex_lock(&g_device_mutex);
+	ret = __device_monitor_start_locked();
+	if(ret == MM_ERROR_NONE){
+		g_active_device_changed_cb_table.user_cb = callback;
+		g_active_device_changed_cb_table.user_data = user_data;
+	}
+	pthread_mutex_unlock(&g_device_mutex);
+
+	return __convert_sound_manager_error_code(__func__, ret);
+}
+
+void sound_manager_unset_active_device_changed_cb (void)
+{
+	pthread_mutex_lock(&g_device_mutex);
+	g_active_device_changed_cb_table.user_cb = NULL;
+	g_active_device_changed_cb_table.user_data = NULL;
+	__device_monitor_stop_locked();
+	pthread_mutex_unlock(&g_device_mutex);
+}
+
+int sound_manager_set_active_device_diff_cb(sound_active_device_diff_cb callback, void *user_data)
+{
+	if(callback == NULL)
+		return __convert_sound_manager_error_code(__func__, SOUND_MANAGER_ERROR_INVALID_PARAMETER);
+	unsigned int generation;
+	int values[2];
+	int stale;
+	int known;
+	int ret;
+
+	pthread_mutex_lock(&g_device_mutex);
+	ret = __device_monitor_start_locked();
+	if(ret == MM_ERROR_NONE){
+		g_active_device_diff_cb_table.user_cb = callback;
+		g_active_device_diff_cb_table.user_data = user_data;
+	}
+	known = g_active_device.known;
+	generation = g_active_device.generation;
+	pthread_mutex_unlock(&g_device_mutex);
+
+	if(ret != MM_ERROR_NONE || known)
+		return __convert_sound_manager_error_code(__func__, ret);
+
+	/* the previous devices, kept unless a notification came in meanwhile */
+	if(_sound_manager_backend_call(SOUND_MANAGER_BACKEND_SLOT_ACTIVE_DEVICE, __backend_get_active_device, 0, values, &stale) == MM_ERROR_NONE && !stale){
+		pthread_mutex_lock(&g_device_mutex);
+		if(g_active_device.monitored && g_active_device.generation == generation){
+			g_active_device.in = values[0];
+			g_active_device.out = values[1];
+			g_active_device.known = 1;
+		}
+		pthread_mutex_unlock(&g_device_mutex);
+	}
+
+	return SOUND_MANAGER_ERROR_NONE;
+}
+
+void sound_manager_unset_active_device_diff_cb(void)
+{
+	pthread_mutex_lock(&g_device_mutex);
+	g_active_device_diff_cb_table.user_cb = NULL;
+	g_active_device_diff_cb_table.user_data = NULL;
+	__device_monitor_stop_locked();
+	pthread_mutex_unlock(&g_device_mutex);
+}
+
+int _sound_manager_route_set_batched(int batched)
+{
+	int ret = MM_ERROR_NONE;
+
+	pthread_mutex_lock(&g_route_mutex);
+	g_route_cache.batched = batched;
+	if(batched)
+		ret = __route_monitor_start_locked();
+	if(ret != MM_ERROR_NONE)
+		g_route_cache.batched = 0;
+	__route_monitor_stop_locked();
+	pthread_mutex_unlock(&g_route_mutex);
+	if(ret != MM_ERROR_NONE)
+		return ret;
+
+	pthread_mutex_lock(&g_device_mutex);
+	g_active_device.batched = batched;
+	if(batched)
+		ret = __device_monitor_start_locked();
+	if(ret != MM_ERROR_NONE)
+		g_active_device.batched = 0;
+	__device_monitor_stop_locked();
+	pthread_mutex_unlock(&g_device_mutex);
+
+	/* all or nothing */
+	if(ret != MM_ERROR_NONE){
+		pthread_mutex_lock(&g_route_mutex);
+		g_route_cache.batched = 0;
+		__route_monitor_stop_locked();
+		pthread_mutex_unlock(&g_route_mutex);
+	}
+	return ret;
+}
+
+void _sound_manager_route_get_state(_sound_manager_route_state_s *state)
+{
+	pthread_mutex_lock(&g_route_mutex);
+	state->route_cb = g_available_route_changed_cb_table.user_cb;
+	state->route_user_data = g_available_route_changed_cb_table.user_data;
+	state->route_diff_cb = g_available_route_diff_cb_table.user_cb;
+	state->route_diff_user_data = g_available_route_diff_cb_table.user_data;
+	pthread_mutex_unlock(&g_route_mutex);
+
+	pthread_mutex_lock(&g_device_mutex);
+	state->device_cb = g_active_device_changed_cb_table.user_cb;
+	state->device_user_data = g_active_device_changed_cb_table.user_data;
+	state->device_diff_cb = g_active_device_diff_cb_table.user_cb;
+	state->device_diff_user_data = g_active_device_diff_cb_table.user_data;
+	state->device_known = g_active_device.known;
+	state->in = g_active_device.in;
+	state->out = g_active_device.out;
+	pthread_mutex_unlock(&g_device_mutex);
+}
+
+int _sound_manager_route_restore_state(const _sound_manager_route_state_s *state)
+{
+	_sound_manager_route_state_s live;
+	int ret = SOUND_MANAGER_ERROR_NONE;
+	int r = SOUND_MANAGER_ERROR_NONE;
+	int values[2];
+
+	_sound_manager_route_get_state(&live);
+
+	/* callbacks being set are registered before the old ones go, so the sound server registration is kept */
+	if(live.route_cb != state->route_cb || live.route_user_data != state->route_user_data){
+		if(state->route_cb)
+			r = sound_manager_set_available_route_changed_cb(state->route_cb, state->route_user_data);
+		if(ret == SOUND_MANAGER_ERROR_NONE)
+			ret = r;
+	}
+	if(live.route_diff_cb != state->route_diff_cb || live.route_diff_user_data != state->route_diff_user_data){
+		if(state->route_diff_cb)
+			r = sound_manager_set_available_route_diff_cb(state->route_diff_cb, state->route_diff_user_data);
+		if(ret == SOUND_MANAGER_ERROR_NONE)
+			ret = r;
+	}
+	if(live.device_cb != state->device_cb || live.device_user_data != state->device_user_data){
+		if(state->device_cb)
+			r = sound_manager_set_active_device_changed_cb(state->device_cb, state->device_user_data);
+		if(ret == SOUND_MANAGER_ERROR_NONE)
+			ret = r;
+	}
+	if(live.device_diff_cb != state->device_diff_cb || live.device_diff_user_data != state->device_diff_user_data){
+		if(state->device_diff_cb)
+			r = sound_manager_set_active_device_diff_cb(state->device_diff_cb, state->device_diff_user_data);
+		if(ret == SOUND_MANAGER_ERROR_NONE)
+			ret = r;
+	}
+
+	if(state->route_cb == NULL && live.route_cb)
+		sound_manager_unset_available_route_changed_cb();
+	if(state->route_diff_cb == NULL && live.route_diff_cb)
+		sound_manager_unset_available_route_diff_cb();
+	if(state->device_cb == NULL && live.device_cb)
+		sound_manager_unset_active_device_changed_cb();
+	if(state->device_diff_cb == NULL && live.device_diff_cb)
+		sound_manager_unset_active_device_diff_cb();
+
+	/* like the volumes, the devices are only kept as the last known ones */
+	if(state->device_known){
+		values[0] = state->in;
+		values[1] = state->out;
+		_sound_manager_backend_seed(SOUND_MANAGER_BACKEND_SLOT_ACTIVE_DEVICE, values);
+	}
+
+	return ret;
+}
@@ -0,0 +1,157 @@
+/*
+* Copyright (c) 2011 Samsung Electronics Co., Ltd All Rights Reserved
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+
+#define LOG_TAG "TIZEN_N_SOUND_MANGER"
+
+#include <sound_manager.h>
+#include <sound_manager_private.h>
+#include <stdio.h>
+#include <string.h>
+#include <pthread.h>
+#include <dlog.h>
+
+/*
+ * Route policy
+ *
+ * Resolves a set of connected devices to the usable routes and the default
+ * one without the sound server. A route is usable when every device it names
+ * is connected; the default is the first usable route in policy order. The
+ * answer for each of the 256 device sets is computed once into a table, so a
+ * query is an index. Left out of the build with the volume-only profile.
+ */
+#define ROUTE_POLICY_IN_MASK (SOUND_DEVICE_IN_MIC | SOUND_DEVICE_IN_WIRED_ACCESSORY | SOUND_DEVICE_IN_BT_SCO)
+#define ROUTE_POLICY_OUT_MASK (SOUND_DEVICE_OUT_SPEAKER | SOUND_DEVICE_OUT_RECEIVER | SOUND_DEVICE_OUT_WIRED_ACCESSORY \
+	| SOUND_DEVICE_OUT_BT_SCO | SOUND_DEVICE_OUT_BT_A2DP)
+/* 3 input bits below 5 output bits */
+#define ROUTE_POLICY_INDEX(devices) (((devices) & ROUTE_POLICY_IN_MASK) | (((devices) & ROUTE_POLICY_OUT_MASK) >> 5))
+#define ROUTE_POLICY_TABLE_SIZE 256
+#define ROUTE_POLICY_NO_ROUTE 0xff
+
+/* policy order, external devices first */
+static const sound_route_e g_route_policy[MAX_ROUTE_NUM] = {
+	SOUND_ROUTE_OUT_BLUETOOTH,
+	SOUND_ROUTE_INOUT_BLUETOOTH,
+	SOUND_ROUTE_INOUT_HEADSET,
+	SOUND_ROUTE_IN_MIC_OUT_HEADPHONE,
+	SOUND_ROUTE_OUT_WIRED_ACCESSORY,
+	SOUND_ROUTE_IN_WIRED_ACCESSORY,
+	SOUND_ROUTE_IN_MIC_OUT_SPEAKER,
+	SOUND_ROUTE_OUT_SPEAKER,
+	SOUND_ROUTE_IN_MIC_OUT_RECEIVER,
+	SOUND_ROUTE_IN_MIC,
+};
+
+typedef struct {
+	unsigned short route_mask;	/* bit i set when g_route_policy[i] is usable */
+	unsigned char default_route;	/* index in g_route_policy or ROUTE_POLICY_NO_ROUTE */
+}_route_policy_entry_s;
+
+static _route_policy_entry_s g_route_policy_table[ROUTE_POLICY_TABLE_SIZE];
+static pthread_once_t g_route_policy_once = PTHREAD_ONCE_INIT;
+
+static void __route_policy_build(void)
+{
+	unsigned int index;
+	unsigned int devices;
+	int i;
+
+	for(index = 0 ; index < ROUTE_POLICY_TABLE_SIZE ; index++)
+	{
+		devices = (index & ROUTE_POLICY_IN_MASK) | ((index << 5) & ROUTE_POLICY_OUT_MASK);
+		g_route_policy_table[index].route_mask = 0;
+		g_route_policy_table[index].default_route = ROUTE_POLICY_NO_ROUTE;
+		for(i = MAX_ROUTE_NUM - 1 ; i >= 0 ; i--)
+		{
+			if((g_route_policy[i] & ~devices) != 0)
+				continue;
+			g_route_policy_table[index].route_mask |= (1 << i);
+			g_route_policy_table[index].default_route = i;
+		}
+	}
+}
+
+static const _route_policy_entry_s *__route_policy_lookup(unsigned int devices)
+{
+	pthread_once(&g_route_policy_once, __route_policy_build);
+	return &g_route_policy_table[ROUTE_POLICY_INDEX(devices)];
+}
+
+static int __route_policy_is_valid_devices(unsigned int devices)
+{
+	return (devices & ~(ROUTE_POLICY_IN_MASK | ROUTE_POLICY_OUT_MASK)) == 0;
+}
+
+int _sound_manager_route_policy_find(sound_route_e route)
+{
+	int i;
+
+	for(i = 0 ; i < MAX_ROUTE_NUM ; i++)
+	{
+		if(g_route_policy[i] == route)
+			return i;
+	}
+	return -1;
+}
+
+int sound_manager_route_policy_get_available_routes(unsigned int devices, sound_route_e *routes, int capacity, int *count)
+{
+	if(!__route_policy_is_valid_devices(devices) || capacity < 0 || (routes == NULL && capacity > 0) || count == NULL)
+		return __convert_sound_manager_error_code(__func__, SOUND_MANAGER_ERROR_INVALID_PARAMETER);
+	const _route_policy_entry_s *entry = __route_policy_lookup(devices);
+	int i;
+
+	*count = 0;
+	for(i = 0 ; i < MAX_ROUTE_NUM ; i++)
+	{
+		if(!(entry->route_mask & (1 << i)))
+			continue;
+		if(*count < capacity)
+			routes[*count] = g_route_policy[i];
+		(*count)++;
+	}
+
+	return SOUND_MANAGER_ERROR_NONE;
+}
+
+int sound_manager_route_policy_get_default_route(unsigned int devices, sound_route_e *route)
+{
+	if(!__route_policy_is_valid_devices(devices) || route == NULL)
+		return __convert_sound_manager_error_code(__func__, SOUND_MANAGER_ERROR_INVALID_PARAMETER);
+	const _route_policy_entry_s *entry = __route_policy_lookup(devices);
+
+	if(entry->default_route == ROUTE_POLICY_NO_ROUTE)
+		return __convert_sound_manager_error_code(__func__, SOUND_MANAGER_ERROR_INVALID_OPERATION);
+	*route = g_route_policy[entry->default_route];
+
+	return SOUND_MANAGER_ERROR_NONE;
+}
+
+int sound_manager_route_policy_is_route_available(unsigned int devices, sound_route_e route, bool *available)
+{
+	if(!__route_policy_is_valid_devices(devices) || available == NULL)
+		return __convert_sound_manager_error_code(__func__, SOUND_MANAGER_ERROR_INVALID_PARAMETER);
+	const _route_policy_entry_s *entry;
+	int i = _sound_manager_route_policy_find(route);
+
+	if(i < 0)
+		return __convert_sound_manager_error_code(__func__, SOUND_MANAGER_ERROR_INVALID_PARAMETER);
+
+	entry = __route_policy_lookup(devices);
+	*available = (entry->route_mask & (1 << i)) != 0;
+
+	return SOUND_MANAGER_ERROR_NONE;
+}
@@ -0,0 +1,746 @@
+/*
+* Copyright (c) 2011 Samsung Electronics Co., Ltd All Rights Reserved
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+
+#define LOG_TAG "TIZEN_N_SOUND_MANGER"
+
+#include <sound_manager.h>
+#include <sound_manager_private.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include <pthread.h>
+#include <dlog.h>
+#include <mm_session.h>
+#include <mm_session_private.h>
+
+/*
+ * Sessions
+ *
+ * mm-session registration, its notifications and the call sessions. Left out of
+ * the build with the no-session and volume-only profiles.
+ */
+typedef struct {
+	int is_registered;
+	int session_type;
+	int app_session_type;	/* the type chosen with sound_manager_set_session_type() */
+	void *user_data;
+	sound_session_notify_cb user_cb;
+	void *interrupted_user_data;
+	sound_interrupted_cb interrupted_cb;
+}_session_notify_info_s;
+
+static _session_notify_info_s g_session_notify_cb_table = {0, MM_SESSION_TYPE_SHARE, MM_SESSION_TYPE_SHARE, NULL, NULL, NULL, NULL};
+
+/* guards the callback fields of g_session_notify_cb_table */
+static pthread_mutex_t g_session_cb_mutex = PTHREAD_MUTEX_INITIALIZER;
+/* serializes mm-session init/finish and guards is_registered, the session types and g_call_session */
+static pthread_mutex_t g_session_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+/* the call session alive in this process, if any */
+static sound_call_session_h g_call_session;
+
+static sound_interrupted_code_e __interrupted_code(session_msg_t msg, session_event_t event)
+{
+	if( msg == MM_SESSION_MSG_RESUME )
+		return SOUND_INTERRUPTED_COMPLETED;
+
+	switch(event){
+		case MM_SESSION_EVENT_OTHER_APP :
+			return SOUND_INTERRUPTED_BY_OTHER_APP;
+		case MM_SESSION_EVENT_CALL :
+			return SOUND_INTERRUPTED_BY_CALL;
+		case MM_SESSION_EVENT_ALARM :
+			return SOUND_INTERRUPTED_BY_ALARM;
+		case MM_SESSION_EVENT_EARJACK_UNPLUG:
+			return SOUND_INTERRUPTED_BY_EARJACK_UNPLUG;
+		case MM_SESSION_EVENT_RESOURCE_CONFLICT:
+			return SOUND_INTERRUPTED_BY_RESOURCE_CONFLICT;
+		default :
+			return SOUND_INTERRUPTED_BY_OTHER_APP;
+	}
+}
+
+static void __session_notify_cb(session_msg_t msg, session_event_t event, void *user_data){
+	_session_notify_info_s cb_info = {0, };
+	_sound_manager_event_s notify;
+	int ducked;
+
+	_sound_manager_event_receive(&notify, SOUND_EVENT_SESSION_NOTIFY);
+	_sound_manager_focus_session_notify(msg, event);
+	ducked = _sound_manager_ducking_session_notify(msg, event);
+	_sound_manager_event_batch_push(SOUND_EVENT_SESSION_NOTIFY, msg, __interrupted_code(msg, event));
+
+	pthread_mutex_lock(&g_session_cb_mutex);
+	cb_info.user_cb = g_session_notify_cb_table.user_cb;
+	cb_info.user_data = g_session_notify_cb_table.user_data;
+	cb_info.interrupted_cb = g_session_notify_cb_table.interrupted_cb;
+	cb_info.interrupted_user_data = g_session_notify_cb_table.interrupted_user_data;
+	pthread_mutex_unlock(&g_session_cb_mutex);
+
+	if(ducked)
+		cb_info.interrupted_cb = NULL;
+	if(cb_info.user_cb || cb_info.interrupted_cb)
+		_sound_manager_event_deliver_begin(&notify);
+	if(cb_info.user_cb){
+		cb_info.user_cb(msg, cb_info.user_data);
+	}
+	if(cb_info.interrupted_cb){
+		cb_info.interrupted_cb(__interrupted_code(msg, event), cb_info.interrupted_user_data);
+	}
+	if(cb_info.user_cb || cb_info.interrupted_cb)
+		_sound_manager_event_deliver_end(&notify);
+}
+
+static int __session_init_locked(int session_type)
+{
+	int ret = MM_ERROR_NONE;
+
+	/* re-initializing the same session type only costs a server round trip */
+	if(g_session_notify_cb_table.is_registered && g_session_notify_cb_table.session_type == session_type)
+		return MM_ERROR_NONE;
+
+	if(g_session_notify_cb_table.is_registered){
+		mm_session_finish();
+		g_session_notify_cb_table.is_registered = 0;
+	}
+
+	ret = mm_session_init_ex(session_type , __session_notify_cb, NULL);
+	if(ret == 0){
+		g_session_notify_cb_table.is_registered = 1;
+		g_session_notify_cb_table.session_type = session_type;
+	}
+	return ret;
+}
+
+int _sound_manager_session_init(int session_type)
+{
+	int ret;
+
+	pthread_mutex_lock(&g_session_mutex);
+	ret = __session_init_locked(session_type);
+	pthread_mutex_unlock(&g_session_mutex);
+
+	return ret;
+}
+
+int _sound_manager_session_init_default(void)
+{
+	int ret = MM_ERROR_NONE;
+
+	pthread_mutex_lock(&g_session_mutex);
+	if(g_session_notify_cb_table.is_registered ==0)
+		ret = __session_init_locked(SOUND_SESSION_TYPE_SHARE /*default*/);
+	pthread_mutex_unlock(&g_session_mutex);
+
+	return ret;
+}
+
+int _sound_manager_session_get_app_type(void)
+{
+	int session_type;
+
+	pthread_mutex_lock(&g_session_mutex);
+	session_type = g_session_notify_cb_table.app_session_type;
+	pthread_mutex_unlock(&g_session_mutex);
+
+	return session_type;
+}
+
+int sound_manager_set_session_type(sound_session_type_e type){
+	int ret = 0;
+	if(type < 0 || type >  SOUND_SESSION_TYPE_EXCLUSIVE)
+		return __convert_sound_manager_error_code(__func__, SOUND_MANAGER_ERROR_INVALID_PARAMETER);
+
+	pthread_mutex_lock(&g_session_mutex);
+	ret = __session_init_locked(type);
+	if(ret == MM_ERROR_NONE)
+		g_session_notify_cb_table.app_session_type = type;
+	pthread_mutex_unlock(&g_session_mutex);
+	return __convert_sound_manager_error_code(__func__, ret);
+}
+
+int sound_manager_set_session_notify_cb(sound_session_notify_cb callback , void *user_data){
+	int ret =0 ;
+	if(callback == NULL)
+		return __convert_sound_manager_error_code(__func__, SOUND_MANAGER_ERROR_INVALID_PARAMETER);
+
+
+	ret = _sound_manager_session_init_default();
+	if(ret != 0)
+		return __convert_sound_manager_error_code(__func__, ret);
+
+	pthread_mutex_lock(&g_session_cb_mutex);
+	g_session_notify_cb_table.user_cb = callback;
+	g_session_notify_cb_table.user_data  = user_data;
+	pthread_mutex_unlock(&g_session_cb_mutex);
+	return SOUND_MANAGER_ERROR_NONE;
+}
+
+void sound_manager_unset_session_notify_cb(void){
+	pthread_mutex_lock(&g_session_cb_mutex);
+	g_session_notify_cb_table.user_cb = NULL;
+	g_session_notify_cb_table.user_data  = NULL;
+	pthread_mutex_unlock(&g_session_cb_mutex);
+}
+
+int sound_manager_set_interrupted_cb(sound_interrupted_cb callback, void *user_data){
+	int ret =0 ;
+	if(callback == NULL)
+		return __convert_sound_manager_error_code(__func__, SOUND_MANAGER_ERROR_INVALID_PARAMETER);
+
+	ret = _sound_manager_session_init_default();
+	if(ret != 0)
+		return __convert_sound_manager_error_code(__func__, ret);
+
+	pthread_mutex_lock(&g_session_cb_mutex);
+	g_session_notify_cb_table.interrupted_cb= callback;
+	g_session_notify_cb_table.interrupted_user_data = user_data;
+	pthread_mutex_unlock(&g_session_cb_mutex);
+	return SOUND_MANAGER_ERROR_NONE;
+}
+
+void sound_manager_unset_interrupted_cb(void){
+	pthread_mutex_lock(&g_session_cb_mutex);
+	g_session_notify_cb_table.interrupted_cb= NULL;
+	g_session_notify_cb_table.interrupted_user_data = NULL;
+	pthread_mutex_unlock(&g_session_cb_mutex);
+}
+
+struct sound_call_session_s
+{
+	sound_call_session_type_e type;
+	sound_call_session_mode_e mode;
+	int mode_cached;
+	int mode_pending;	/* set before activation, applied by it */
+	int active;	/* the mm-session is initialized */
+	int prepared;	/* holds a reference on g_call_warm_info */
+	unsigned long long created_time;	/* for the log at destroy */
+	unsigned int mode_transitions;
+};
+
+/*
+ * Call session handle pool
+ *
+ * A sound_call_session_h is a token rather than a pointer: the slot number
+ * (index + 1, so a token is never NULL) in the low bits and the generation of
+ * the slot above them. Destroying a handle bumps the generation, so a stale or
+ * twice destroyed handle no longer matches and is rejected. Free slots form a
+ * lock-free stack whose head carries a tag against ABA; slots never used yet
+ * are taken from the end of the pool. Every use of a session holds the lock of
+ * its slot, under which the generation is checked, so a destroy can not free
+ * the slot while a call is still reading or writing it.
+ */
+#define CALL_SESSION_POOL_SIZE 16
+#define CALL_SESSION_INDEX_BITS 8
+#define CALL_SESSION_INDEX_MASK ((1U << CALL_SESSION_INDEX_BITS) - 1)
+/* what is left of a 32 bit pointer */
+#define CALL_SESSION_GENERATION_MASK (0xffffffffU >> CALL_SESSION_INDEX_BITS)
+
+typedef struct {
+	pthread_mutex_t lock;	/* taken before g_session_mutex */
+	struct sound_call_session_s session;
+	unsigned int generation;	/* of the live handle */
+	unsigned int next_free;	/* slot number, 0 at the bottom of the stack */
+}_call_session_slot_s;
+
+typedef struct {
+	unsigned int free_head;	/* tag << CALL_SESSION_INDEX_BITS | slot number */
+	unsigned int used;	/* slots taken from the end of the pool */
+	_call_session_slot_s slot[CALL_SESSION_POOL_SIZE];
+}_call_session_pool_s;
+
+static _call_session_pool_s g_call_session_pool;
+static pthread_once_t g_call_session_pool_once = PTHREAD_ONCE_INIT;
+
+static void __call_session_pool_init(void)
+{
+	int i;
+
+	for(i = 0 ; i < CALL_SESSION_POOL_SIZE ; i++)
+		pthread_mutex_init(&g_call_session_pool.slot[i].lock, NULL);
+}
+
+static unsigned int __call_session_slot_alloc(void)
+{
+	unsigned int head;
+	unsigned int next;
+	unsigned int number;
+
+	do {
+		head = __sync_fetch_and_add(&g_call_session_pool.free_head, 0);
+		number = head & CALL_SESSION_INDEX_MASK;
+		if(number == 0)
+			break;
+		next = __sync_fetch_and_add(&g_call_session_pool.slot[number - 1].next_free, 0);
+	} while(!__sync_bool_compare_and_swap(&g_call_session_pool.free_head, head,
+		(((head >> CALL_SESSION_INDEX_BITS) + 1) << CALL_SESSION_INDEX_BITS) | next));
+	if(number)
+		return number;
+
+	do {
+		number = __sync_fetch_and_add(&g_call_session_pool.used, 0);
+		if(number >= CALL_SESSION_POOL_SIZE)
+			return 0;
+	} while(!__sync_bool_compare_and_swap(&g_call_session_pool.used, number, number + 1));
+
+	return number + 1;
+}
+
+static void __call_session_slot_free(unsigned int number)
+{
+	unsigned int head;
+
+	do {
+		head = __sync_fetch_and_add(&g_call_session_pool.free_head, 0);
+		__sync_lock_test_and_set(&g_call_session_pool.slot[number - 1].next_free, head & CALL_SESSION_INDEX_MASK);
+	} while(!__sync_bool_compare_and_swap(&g_call_session_pool.free_head, head,
+		(((head >> CALL_SESSION_INDEX_BITS) + 1) << CALL_SESSION_INDEX_BITS) | number));
+}
+
+static sound_call_session_h __call_session_handle(unsigned int number)
+{
+	unsigned int generation = __sync_fetch_and_add(&g_call_session_pool.slot[number - 1].generation, 0);
+
+	return (sound_call_session_h)(uintptr_t)((generation << CALL_SESSION_INDEX_BITS) | number);
+}
+
+/* Returns the session of a live handle with its slot locked, NULL for a stale or foreign one */
+static struct sound_call_session_s *__call_session_lock(sound_call_session_h handle, unsigned int *number)
+{
+	uintptr_t token = (uintptr_t)handle;
+	unsigned int slot_number = token & CALL_SESSION_INDEX_MASK;
+	_call_session_slot_s *slot;
+
+	if(slot_number == 0 || slot_number > CALL_SESSION_POOL_SIZE)
+		return NULL;
+
+	pthread_once(&g_call_session_pool_once, __call_session_pool_init);
+	slot = &g_call_session_pool.slot[slot_number - 1];
+	pthread_mutex_lock(&slot->lock);
+	if((token >> CALL_SESSION_INDEX_BITS) != __sync_fetch_and_add(&slot->generation, 0)){
+		pthread_mutex_unlock(&slot->lock);
+		return NULL;
+	}
+
+	if(number)
+		*number = slot_number;
+	return &slot->session;
+}
+
+static void __call_session_unlock(sound_call_session_h handle)
+{
+	pthread_mutex_unlock(&g_call_session_pool.slot[((uintptr_t)handle & CALL_SESSION_INDEX_MASK) - 1].lock);
+}
+
+static int __call_session_alloc(sound_call_session_type_e type, sound_call_session_h *handle, struct sound_call_session_s **session)
+{
+	unsigned int number;
+
+	pthread_once(&g_call_session_pool_once, __call_session_pool_init);
+	number = __call_session_slot_alloc();
+	if(number == 0){
+		LOGE("[%s] all %d call sessions are in use", __func__, CALL_SESSION_POOL_SIZE);
+		return SOUND_MANAGER_ERROR_INVALID_OPERATION;
+	}
+
+	pthread_mutex_lock(&g_call_session_pool.slot[number - 1].lock);
+	*session = &g_call_session_pool.slot[number - 1].session;
+	memset(*session, 0, sizeof(struct sound_call_session_s));
+	(*session)->type = type;
+	(*session)->created_time = _sound_manager_get_time_us();
+	*handle = __call_session_handle(number);
+	pthread_mutex_unlock(&g_call_session_pool.slot[number - 1].lock);
+
+	return SOUND_MANAGER_ERROR_NONE;
+}
+
+/*
+ * While a prepared call session exists the call volume is kept current by the
+ * volume change notification, registered and read on the timer thread.
+ */
+typedef struct {
+	pthread_mutex_t lock;
+	int sessions;
+	int monitor_held;
+}_call_warm_info_s;
+
+static _call_warm_info_s g_call_warm_info = {PTHREAD_MUTEX_INITIALIZER, 0, 0};
+
+static int __call_session_warm_up_cb(void *user_data)
+{
+	int held;
+	int max;
+	int volume;
+
+	pthread_mutex_lock(&g_call_warm_info.lock);
+	if(g_call_warm_info.sessions > 0 && !g_call_warm_info.monitor_held){
+		_sound_manager_volume_monitor_ref();
+		g_call_warm_info.monitor_held = 1;
+	}
+	held = g_call_warm_info.monitor_held;
+	pthread_mutex_unlock(&g_call_warm_info.lock);
+
+	if(held){
+		sound_manager_get_max_volume(SOUND_TYPE_CALL, &max);
+		sound_manager_get_volume(SOUND_TYPE_CALL, &volume);
+	}
+
+	return 0;
+}
+
+static void __call_session_warm_release(void)
+{
+	pthread_mutex_lock(&g_call_warm_info.lock);
+	if(--g_call_warm_info.sessions == 0 && g_call_warm_info.monitor_held){
+		_sound_manager_volume_monitor_unref();
+		g_call_warm_info.monitor_held = 0;
+	}
+	pthread_mutex_unlock(&g_call_warm_info.lock);
+}
+
+static int __call_session_init_locked(sound_call_session_h handle, struct sound_call_session_s *session)
+{
+	int ret = MM_ERROR_NONE;
+
+	switch(session->type) {
+	case SOUND_SESSION_TYPE_CALL:
+		ret = mm_session_init(MM_SESSION_TYPE_CALL);
+		break;
+	case SOUND_SESSION_TYPE_VOIP:
+		ret = mm_session_init(MM_SESSION_TYPE_VIDEOCALL);
+		break;
+	}
+	if(ret == MM_ERROR_NONE){
+		session->active = 1;
+		g_call_session = handle;
+	}
+
+	return ret;
+}
+
+int sound_manager_call_session_create(sound_call_session_type_e type, sound_call_session_h *session)
+{
+	int ret = SOUND_MANAGER_ERROR_NONE;
+	sound_call_session_h handle = NULL;
+	struct sound_call_session_s *s = NULL;
+	unsigned int number = 0;
+
+	if(type < SOUND_SESSION_TYPE_CALL || type > SOUND_SESSION_TYPE_VOIP || session == NULL) {
+		ret = SOUND_MANAGER_ERROR_INVALID_PARAMETER;
+		goto ERROR;
+	}
+
+	ret = __call_session_alloc(type, &handle, &s);
+	if(ret != SOUND_MANAGER_ERROR_NONE)
+		goto ERROR;
+
+	s = __call_session_lock(handle, &number);
+	pthread_mutex_lock(&g_session_mutex);
+	ret = __call_session_init_locked(handle, s);
+	pthread_mutex_unlock(&g_session_mutex);
+
+	if(ret != MM_ERROR_NONE)
+		goto ERROR;
+
+	__call_session_unlock(handle);
+	*session = handle;
+
+	return SOUND_MANAGER_ERROR_NONE;
+
+ERROR:
+	/* the handle was never returned, so nobody else can hold it */
+	if(number){
+		__sync_lock_test_and_set(&g_call_session_pool.slot[number - 1].generation,
+			(((uintptr_t)handle >> CALL_SESSION_INDEX_BITS) + 1) & CALL_SESSION_GENERATION_MASK);
+		__call_session_unlock(handle);
+		__call_session_slot_free(number);
+	}
+
+	return __convert_sound_manager_error_code(__func__, ret);
+}
+
+int sound_manager_call_session_prepare(sound_call_session_type_e type, sound_call_session_h *session)
+{
+	int ret = SOUND_MANAGER_ERROR_NONE;
+	sound_call_session_h handle = NULL;
+	struct sound_call_session_s *s = NULL;
+
+	if(type < SOUND_SESSION_TYPE_CALL || type > SOUND_SESSION_TYPE_VOIP || session == NULL) {
+		ret = SOUND_MANAGER_ERROR_INVALID_PARAMETER;
+		goto ERROR;
+	}
+
+	ret = __call_session_alloc(type, &handle, &s);
+	if(ret != SOUND_MANAGER_ERROR_NONE)
+		goto ERROR;
+	s->prepared = 1;
+
+	pthread_mutex_lock(&g_call_warm_info.lock);
+	g_call_warm_info.sessions++;
+	pthread_mutex_unlock(&g_call_warm_info.lock);
+
+	/* without the timer thread the activation just finds a cold cache */
+	_sound_manager_timer_add(0, __call_session_warm_up_cb, NULL);
+
+	*session = handle;
+
+	return SOUND_MANAGER_ERROR_NONE;
+
+ERROR:
+	return __convert_sound_manager_error_code(__func__, ret);
+}
+
+int sound_manager_call_session_activate(sound_call_session_h session)
+{
+	int ret = SOUND_MANAGER_ERROR_NONE;
+	struct sound_call_session_s *s = __call_session_lock(session, NULL);
+
+	if(s == NULL) {
+		ret = SOUND_MANAGER_ERROR_INVALID_PARAMETER;
+		goto ERROR;
+	}
+
+	if(s->active) {
+		__call_session_unlock(session);
+		return SOUND_MANAGER_ERROR_NONE;
+	}
+
+	pthread_mutex_lock(&g_session_mutex);
+	ret = __call_session_init_locked(session, s);
+	pthread_mutex_unlock(&g_session_mutex);
+
+	if(ret == MM_ERROR_NONE && s->mode_pending) {
+		s->mode_pending = 0;
+		ret = mm_session_set_subsession((mm_subsession_t)s->mode);
+		if(ret == MM_ERROR_NONE)
+			s->mode_cached = 1;
+	}
+	__call_session_unlock(session);
+
+	if(ret != MM_ERROR_NONE)
+		goto ERROR;
+
+	return SOUND_MANAGER_ERROR_NONE;
+
+ERROR:
+	return __convert_sound_manager_error_code(__func__, ret);
+}
+
+int sound_manager_call_session_set_mode(sound_call_session_h session, sound_call_session_mode_e mode)
+{
+	int ret = SOUND_MANAGER_ERROR_NONE;
+	struct sound_call_session_s *s = NULL;
+
+	if(mode < SOUND_CALL_SESSION_MODE_VOICE || mode > SOUND_CALL_SESSION_MODE_MEDIA
+		|| (s = __call_session_lock(session, NULL)) == NULL) {
+		ret = SOUND_MANAGER_ERROR_INVALID_PARAMETER;
+		goto ERROR;
+	}
+
+	/* a prepared session takes the mode with its activation */
+	if(!s->active) {
+		s->mode = mode;
+		s->mode_pending = 1;
+		__call_session_unlock(session);
+		return SOUND_MANAGER_ERROR_NONE;
+	}
+
+	/* this process owns the call session, so an unchanged mode needs no round trip */
+	if(s->mode_cached && s->mode == mode) {
+		__call_session_unlock(session);
+		return SOUND_MANAGER_ERROR_NONE;
+	}
+
+	ret = mm_session_set_subsession ((mm_subsession_t)mode);
+
+	if(ret == MM_ERROR_NONE) {
+		if(s->mode_cached)
+			s->mode_transitions++;
+		s->mode = mode;
+		s->mode_cached = 1;
+	}
+	__call_session_unlock(session);
+
+	if(ret != MM_ERROR_NONE)
+		goto ERROR;
+
+	return SOUND_MANAGER_ERROR_NONE;
+
+ERROR:
+	return __convert_sound_manager_error_code(__func__, ret);
+}
+
+int  sound_manager_call_session_get_mode(sound_call_session_h session, sound_call_session_mode_e *mode)
+{
+	int ret = SOUND_MANAGER_ERROR_NONE;
+	struct sound_call_session_s *s = NULL;
+
+	if(mode == NULL || (s = __call_session_lock(session, NULL)) == NULL) {
+		ret = SOUND_MANAGER_ERROR_INVALID_PARAMETER;
+		goto ERROR;
+	}
+
+	if(s->mode_cached || s->mode_pending) {
+		*mode = s->mode;
+		__call_session_unlock(session);
+		return SOUND_MANAGER_ERROR_NONE;
+	}
+
+	if(!s->active) {
+		__call_session_unlock(session);
+		ret = SOUND_MANAGER_ERROR_INVALID_OPERATION;
+		goto ERROR;
+	}
+
+	ret = mm_session_get_subsession ((mm_subsession_t *)mode);
+
+	if(ret == MM_ERROR_NONE) {
+		s->mode = *mode;
+		s->mode_cached = 1;
+	}
+	__call_session_unlock(session);
+
+	if(ret != MM_ERROR_NONE)
+		goto ERROR;
+
+	return SOUND_MANAGER_ERROR_NONE;
+
+ERROR:
+	return __convert_sound_manager_error_code(__func__, ret);
+}
+
+int sound_manager_call_session_get_type(sound_call_session_h session, sound_call_session_type_e *type)
+{
+	struct sound_call_session_s *s = NULL;
+
+	if(type == NULL || (s = __call_session_lock(session, NULL)) == NULL)
+		return __convert_sound_manager_error_code(__func__, SOUND_MANAGER_ERROR_INVALID_PARAMETER);
+
+	*type = s->type;
+	__call_session_unlock(session);
+
+	return SOUND_MANAGER_ERROR_NONE;
+}
+
+int sound_manager_call_session_destroy(sound_call_session_h session)
+{
+	int ret = SOUND_MANAGER_ERROR_NONE;
+	unsigned int generation = (uintptr_t)session >> CALL_SESSION_INDEX_BITS;
+	unsigned int number;
+	struct sound_call_session_s *s = __call_session_lock(session, &number);
+
+	if(s == NULL) {
+		ret = SOUND_MANAGER_ERROR_INVALID_PARAMETER;
+		goto ERROR;
+	}
+
+	/* the handle is claimed before anything is torn down, only one of two racing destroys gets here */
+	if(!__sync_bool_compare_and_swap(&g_call_session_pool.slot[number - 1].generation, generation,
+		(generation + 1) & CALL_SESSION_GENERATION_MASK)) {
+		__call_session_unlock(session);
+		ret = SOUND_MANAGER_ERROR_INVALID_PARAMETER;
+		goto ERROR;
+	}
+
+	if(s->active) {
+		pthread_mutex_lock(&g_session_mutex);
+		ret = mm_session_finish();
+		if(ret == MM_ERROR_NONE){
+			g_session_notify_cb_table.is_registered = 0;
+			if(g_call_session == session)
+				g_call_session = NULL;
+		}
+		pthread_mutex_unlock(&g_session_mutex);
+
+		if(ret != MM_ERROR_NONE) {
+			/* still registered, the handle stays valid for another try */
+			__sync_lock_test_and_set(&g_call_session_pool.slot[number - 1].generation, generation);
+			__call_session_unlock(session);
+			goto ERROR;
+		}
+	}
+
+	if(s->prepared)
+		__call_session_warm_release();
+
+	LOGI("[%s] call session(%d) lasted %llu ms, %u mode transitions", __func__, s->type,
+		(_sound_manager_get_time_us() - s->created_time) / 1000, s->mode_transitions);
+
+	__call_session_unlock(session);
+	__call_session_slot_free(number);
+
+	return SOUND_MANAGER_ERROR_NONE;
+
+ERROR:
+	return __convert_sound_manager_error_code(__func__, ret);
+}
+
+
+void _sound_manager_session_get_state(_sound_manager_session_state_s *state)
+{
+	struct sound_call_session_s *call_session;
+	sound_call_session_h handle;
+
+	pthread_mutex_lock(&g_session_mutex);
+	state->registered = g_session_notify_cb_table.is_registered && g_call_session == NULL;
+	state->session_type = g_session_notify_cb_table.session_type;
+	handle = g_call_session;
+	pthread_mutex_unlock(&g_session_mutex);
+
+	/* the slot lock is taken before g_session_mutex, so only once it is released */
+	call_session = __call_session_lock(handle, NULL);
+	state->call_mode_known = call_session && call_session->mode_cached;
+	state->call_mode = call_session ? call_session->mode : SOUND_CALL_SESSION_MODE_VOICE;
+	if(call_session)
+		__call_session_unlock(handle);
+
+	pthread_mutex_lock(&g_session_cb_mutex);
+	state->notify_cb = g_session_notify_cb_table.user_cb;
+	state->notify_user_data = g_session_notify_cb_table.user_data;
+	state->interrupted_cb = g_session_notify_cb_table.interrupted_cb;
+	state->interrupted_user_data = g_session_notify_cb_table.interrupted_user_data;
+	pthread_mutex_unlock(&g_session_cb_mutex);
+}
+
+int _sound_manager_session_restore_state(const _sound_manager_session_state_s *state)
+{
+	int ret = MM_ERROR_NONE;
+	sound_call_session_h handle;
+
+	pthread_mutex_lock(&g_session_mutex);
+	/* a call session replaces the process session, it is left alone */
+	if(state->registered && g_call_session == NULL)
+		ret = __session_init_locked(state->session_type);
+	handle = g_call_session;
+	pthread_mutex_unlock(&g_session_mutex);
+
+	/* a call session destroyed in between fails the handle check and has no mode to restore */
+	if(ret == MM_ERROR_NONE && state->call_mode_known && handle){
+		ret = sound_manager_call_session_set_mode(handle, state->call_mode);
+		if(ret == SOUND_MANAGER_ERROR_INVALID_PARAMETER)
+			ret = MM_ERROR_NONE;
+	}
+
+	pthread_mutex_lock(&g_session_cb_mutex);
+	g_session_notify_cb_table.user_cb = state->notify_cb;
+	g_session_notify_cb_table.user_data = state->notify_user_data;
+	g_session_notify_cb_table.interrupted_cb = state->interrupted_cb;
+	g_session_notify_cb_table.interrupted_user_data = state->interrupted_user_data;
+	pthread_mutex_unlock(&g_session_cb_mutex);
+
+	return __convert_sound_manager_error_code(__func__, ret);
+}
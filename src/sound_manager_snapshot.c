@@ -0,0 +1,98 @@
+/*
+* Copyright (c) 2011 Samsung Electronics Co., Ltd All Rights Reserved
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+
+#define LOG_TAG "TIZEN_N_SOUND_MANGER"
+
+#include <sound_manager.h>
+#include <sound_manager_private.h>
+#include <stdio.h>
+#include <string.h>
+#include <malloc.h>
+#include <dlog.h>
+
+/*
+ * State snapshots
+ *
+ * Collects the state of each subsystem built into the library, see the
+ * _sound_manager_*_get_state() hooks.
+ */
+struct sound_manager_snapshot_s
+{
+	_sound_manager_volume_state_s volume;
+#ifndef SOUND_MANAGER_DISABLE_ROUTE
+	_sound_manager_route_state_s route;
+#endif
+#ifndef SOUND_MANAGER_DISABLE_SESSION
+	_sound_manager_session_state_s session;
+#endif
+};
+
+int sound_manager_snapshot_create(sound_manager_snapshot_h *snapshot)
+{
+	if(snapshot == NULL)
+		return __convert_sound_manager_error_code(__func__, SOUND_MANAGER_ERROR_INVALID_PARAMETER);
+	sound_manager_snapshot_h handle = malloc(sizeof(struct sound_manager_snapshot_s));
+
+	if(handle == NULL)
+		return __convert_sound_manager_error_code(__func__, SOUND_MANAGER_ERROR_OUT_OF_MEMORY);
+	memset(handle, 0, sizeof(struct sound_manager_snapshot_s));
+
+#ifndef SOUND_MANAGER_DISABLE_SESSION
+	_sound_manager_session_get_state(&handle->session);
+#endif
+	_sound_manager_volume_get_state(&handle->volume);
+#ifndef SOUND_MANAGER_DISABLE_ROUTE
+	_sound_manager_route_get_state(&handle->route);
+#endif
+
+	*snapshot = handle;
+	return SOUND_MANAGER_ERROR_NONE;
+}
+
+int sound_manager_snapshot_restore(sound_manager_snapshot_h snapshot)
+{
+	if(snapshot == NULL)
+		return __convert_sound_manager_error_code(__func__, SOUND_MANAGER_ERROR_INVALID_PARAMETER);
+	int ret = SOUND_MANAGER_ERROR_NONE;
+	int part;
+
+	/* the session goes first, its callbacks are only delivered once it is registered */
+#ifndef SOUND_MANAGER_DISABLE_SESSION
+	part = _sound_manager_session_restore_state(&snapshot->session);
+	if(ret == SOUND_MANAGER_ERROR_NONE)
+		ret = part;
+#endif
+	part = _sound_manager_volume_restore_state(&snapshot->volume);
+	if(ret == SOUND_MANAGER_ERROR_NONE)
+		ret = part;
+#ifndef SOUND_MANAGER_DISABLE_ROUTE
+	part = _sound_manager_route_restore_state(&snapshot->route);
+	if(ret == SOUND_MANAGER_ERROR_NONE)
+		ret = part;
+#endif
+
+	return ret;
+}
+
+int sound_manager_snapshot_destroy(sound_manager_snapshot_h snapshot)
+{
+	if(snapshot == NULL)
+		return __convert_sound_manager_error_code(__func__, SOUND_MANAGER_ERROR_INVALID_PARAMETER);
+
+	free(snapshot);
+	return SOUND_MANAGER_ERROR_NONE;
+}
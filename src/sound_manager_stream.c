@@ -0,0 +1,345 @@
+/*
+* Copyright (c) 2011 Samsung Electronics Co., Ltd All Rights Reserved
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+
+#define LOG_TAG "TIZEN_N_SOUND_MANGER"
+
+#include <sound_manager.h>
+#include <sound_manager_private.h>
+#include <stdio.h>
+#include <string.h>
+#include <malloc.h>
+#include <pthread.h>
+#include <dlog.h>
+
+/*
+ * Stream volume
+ *
+ * Streams hang off their sound type. The effective gain (type level x duck gain x
+ * stream gain, 0.0 while the type is muted) is kept in each handle, so a stream
+ * gain change is a local multiplication and a type level, ducking or mute change
+ * only walks the streams of that type. Muting leaves the type level alone, so
+ * unmuting needs no sound server request.
+ */
+struct sound_stream_volume_s
+{
+	sound_type_e type;
+	double gain;
+	double effective_gain;
+	sound_stream_volume_changed_cb user_cb;
+	void *user_data;
+	struct sound_stream_volume_s *prev;
+	struct sound_stream_volume_s *next;
+};
+
+#define STREAM_VOLUME_NOTIFY_BATCH 16	/* callbacks collected per pass of a refresh */
+
+typedef struct {
+	sound_stream_volume_h stream;
+	double gain;
+	sound_stream_volume_changed_cb user_cb;
+	void *user_data;
+}_stream_volume_notify_s;
+
+typedef struct {
+	pthread_mutex_t lock;
+	sound_stream_volume_h head[MAX_VOLUME_TYPE + 1];
+	double type_gain[MAX_VOLUME_TYPE + 1];
+	double duck_attenuation[MAX_VOLUME_TYPE + 1];	/* 0.0 when not ducked */
+	int muted[MAX_VOLUME_TYPE + 1];
+	sound_mute_changed_cb mute_cb;
+	void *mute_user_data;
+}_stream_volume_info_s;
+
+static _stream_volume_info_s g_stream_volume_info = {PTHREAD_MUTEX_INITIALIZER, };
+
+static double __type_gain(int volume, int max)
+{
+	if(max <= 0 || volume <= 0)
+		return 0.0;
+	if(volume >= max)
+		return 1.0;
+	return (double)volume / max;
+}
+
+static double __effective_gain_locked(sound_stream_volume_h stream)
+{
+	if(g_stream_volume_info.muted[stream->type])
+		return 0.0;
+	return g_stream_volume_info.type_gain[stream->type] * (1.0 - g_stream_volume_info.duck_attenuation[stream->type]) * stream->gain;
+}
+
+/* Recomputes the streams of a type and notifies the ones whose effective gain moved */
+static void __stream_volume_refresh(sound_type_e type)
+{
+	_stream_volume_notify_s notify[STREAM_VOLUME_NOTIFY_BATCH];
+	sound_stream_volume_h stream;
+	int count;
+	int i;
+
+	/* streams already refreshed keep their gain, so each pass starts over at the head */
+	do{
+		count = 0;
+		pthread_mutex_lock(&g_stream_volume_info.lock);
+		for(stream = g_stream_volume_info.head[type] ; stream && count < STREAM_VOLUME_NOTIFY_BATCH ; stream = stream->next)
+		{
+			double effective_gain = __effective_gain_locked(stream);
+			if(effective_gain == stream->effective_gain)
+				continue;
+			stream->effective_gain = effective_gain;
+			if(stream->user_cb){
+				notify[count].stream = stream;
+				notify[count].gain = effective_gain;
+				notify[count].user_cb = stream->user_cb;
+				notify[count].user_data = stream->user_data;
+				count++;
+			}
+		}
+		pthread_mutex_unlock(&g_stream_volume_info.lock);
+
+		for(i = 0 ; i < count ; i++)
+			notify[i].user_cb(notify[i].stream, notify[i].gain, notify[i].user_data);
+	}while(count == STREAM_VOLUME_NOTIFY_BATCH);
+}
+
+void _sound_manager_stream_volume_type_changed(sound_type_e type, int volume, int max)
+{
+	if(type > MAX_VOLUME_TYPE || type < 0)
+		return;
+
+	pthread_mutex_lock(&g_stream_volume_info.lock);
+	g_stream_volume_info.type_gain[type] = __type_gain(volume, max);
+	pthread_mutex_unlock(&g_stream_volume_info.lock);
+
+	__stream_volume_refresh(type);
+}
+
+void _sound_manager_stream_volume_set_duck_gain(sound_type_e type, double gain)
+{
+	if(type > MAX_VOLUME_TYPE || type < 0)
+		return;
+
+	pthread_mutex_lock(&g_stream_volume_info.lock);
+	g_stream_volume_info.duck_attenuation[type] = 1.0 - gain;
+	pthread_mutex_unlock(&g_stream_volume_info.lock);
+
+	__stream_volume_refresh(type);
+}
+
+int sound_manager_set_mute(sound_type_e type, bool muted)
+{
+	if(type > MAX_VOLUME_TYPE || type < 0)
+		return __convert_sound_manager_error_code(__func__, SOUND_MANAGER_ERROR_INVALID_PARAMETER);
+	sound_mute_changed_cb user_cb = NULL;
+	void *user_data = NULL;
+	int changed;
+
+	pthread_mutex_lock(&g_stream_volume_info.lock);
+	changed = (g_stream_volume_info.muted[type] != (muted ? 1 : 0));
+	if(changed){
+		g_stream_volume_info.muted[type] = muted ? 1 : 0;
+		user_cb = g_stream_volume_info.mute_cb;
+		user_data = g_stream_volume_info.mute_user_data;
+	}
+	pthread_mutex_unlock(&g_stream_volume_info.lock);
+
+	if(!changed)
+		return SOUND_MANAGER_ERROR_NONE;
+
+	__stream_volume_refresh(type);
+	_sound_manager_event_batch_push(SOUND_EVENT_MUTE_CHANGED, type, muted ? 1 : 0);
+	if(user_cb)
+		user_cb(type, muted, user_data);
+
+	return SOUND_MANAGER_ERROR_NONE;
+}
+
+int sound_manager_get_mute(sound_type_e type, bool *muted)
+{
+	if(type > MAX_VOLUME_TYPE || type < 0 || muted == NULL)
+		return __convert_sound_manager_error_code(__func__, SOUND_MANAGER_ERROR_INVALID_PARAMETER);
+
+	pthread_mutex_lock(&g_stream_volume_info.lock);
+	*muted = g_stream_volume_info.muted[type] ? true : false;
+	pthread_mutex_unlock(&g_stream_volume_info.lock);
+
+	return SOUND_MANAGER_ERROR_NONE;
+}
+
+int sound_manager_set_mute_changed_cb(sound_mute_changed_cb callback, void *user_data)
+{
+	if(callback == NULL)
+		return __convert_sound_manager_error_code(__func__, SOUND_MANAGER_ERROR_INVALID_PARAMETER);
+
+	pthread_mutex_lock(&g_stream_volume_info.lock);
+	g_stream_volume_info.mute_cb = callback;
+	g_stream_volume_info.mute_user_data = user_data;
+	pthread_mutex_unlock(&g_stream_volume_info.lock);
+
+	return SOUND_MANAGER_ERROR_NONE;
+}
+
+void sound_manager_unset_mute_changed_cb(void)
+{
+	pthread_mutex_lock(&g_stream_volume_info.lock);
+	g_stream_volume_info.mute_cb = NULL;
+	g_stream_volume_info.mute_user_data = NULL;
+	pthread_mutex_unlock(&g_stream_volume_info.lock);
+}
+
+int sound_manager_stream_volume_create(sound_type_e type, sound_stream_volume_h *stream)
+{
+	sound_stream_volume_h handle = NULL;
+	int volume = 0;
+	int max = 0;
+	int ret;
+
+	if(type > MAX_VOLUME_TYPE || type < 0 || stream == NULL)
+		return __convert_sound_manager_error_code(__func__, SOUND_MANAGER_ERROR_INVALID_PARAMETER);
+
+	handle = malloc(sizeof(struct sound_stream_volume_s));
+	if(!handle)
+		return __convert_sound_manager_error_code(__func__, SOUND_MANAGER_ERROR_OUT_OF_MEMORY);
+
+	memset(handle, 0, sizeof(struct sound_stream_volume_s));
+	handle->type = type;
+	handle->gain = 1.0;
+
+	/* type level changes must reach the streams, and keep later reads local */
+	_sound_manager_volume_monitor_ref();
+
+	ret = sound_manager_get_max_volume(type, &max);
+	if(ret == SOUND_MANAGER_ERROR_NONE)
+		ret = sound_manager_get_volume(type, &volume);
+	/* a late level is kept until the next change notification */
+	if(ret == SOUND_MANAGER_ERROR_STALE_VALUE)
+		ret = SOUND_MANAGER_ERROR_NONE;
+	if(ret != SOUND_MANAGER_ERROR_NONE){
+		_sound_manager_volume_monitor_unref();
+		free(handle);
+		return ret;
+	}
+
+	pthread_mutex_lock(&g_stream_volume_info.lock);
+	g_stream_volume_info.type_gain[type] = __type_gain(volume, max);
+	handle->effective_gain = __effective_gain_locked(handle);
+	handle->next = g_stream_volume_info.head[type];
+	if(handle->next)
+		handle->next->prev = handle;
+	g_stream_volume_info.head[type] = handle;
+	pthread_mutex_unlock(&g_stream_volume_info.lock);
+
+	*stream = handle;
+
+	return SOUND_MANAGER_ERROR_NONE;
+}
+
+int sound_manager_stream_volume_set_gain(sound_stream_volume_h stream, double gain)
+{
+	_stream_volume_notify_s notify = {NULL, };
+	double effective_gain;
+
+	if(stream == NULL || gain < 0.0 || gain > 1.0)
+		return __convert_sound_manager_error_code(__func__, SOUND_MANAGER_ERROR_INVALID_PARAMETER);
+
+	pthread_mutex_lock(&g_stream_volume_info.lock);
+	stream->gain = gain;
+	effective_gain = __effective_gain_locked(stream);
+	if(effective_gain != stream->effective_gain){
+		stream->effective_gain = effective_gain;
+		notify.stream = stream;
+		notify.gain = effective_gain;
+		notify.user_cb = stream->user_cb;
+		notify.user_data = stream->user_data;
+	}
+	pthread_mutex_unlock(&g_stream_volume_info.lock);
+
+	if(notify.user_cb)
+		notify.user_cb(notify.stream, notify.gain, notify.user_data);
+
+	return SOUND_MANAGER_ERROR_NONE;
+}
+
+int sound_manager_stream_volume_get_gain(sound_stream_volume_h stream, double *gain)
+{
+	if(stream == NULL || gain == NULL)
+		return __convert_sound_manager_error_code(__func__, SOUND_MANAGER_ERROR_INVALID_PARAMETER);
+
+	pthread_mutex_lock(&g_stream_volume_info.lock);
+	*gain = stream->gain;
+	pthread_mutex_unlock(&g_stream_volume_info.lock);
+
+	return SOUND_MANAGER_ERROR_NONE;
+}
+
+int sound_manager_stream_volume_get_effective_gain(sound_stream_volume_h stream, double *gain)
+{
+	if(stream == NULL || gain == NULL)
+		return __convert_sound_manager_error_code(__func__, SOUND_MANAGER_ERROR_INVALID_PARAMETER);
+
+	pthread_mutex_lock(&g_stream_volume_info.lock);
+	*gain = stream->effective_gain;
+	pthread_mutex_unlock(&g_stream_volume_info.lock);
+
+	return SOUND_MANAGER_ERROR_NONE;
+}
+
+int sound_manager_stream_volume_set_changed_cb(sound_stream_volume_h stream, sound_stream_volume_changed_cb callback, void *user_data)
+{
+	if(stream == NULL || callback == NULL)
+		return __convert_sound_manager_error_code(__func__, SOUND_MANAGER_ERROR_INVALID_PARAMETER);
+
+	pthread_mutex_lock(&g_stream_volume_info.lock);
+	stream->user_cb = callback;
+	stream->user_data = user_data;
+	pthread_mutex_unlock(&g_stream_volume_info.lock);
+
+	return SOUND_MANAGER_ERROR_NONE;
+}
+
+int sound_manager_stream_volume_unset_changed_cb(sound_stream_volume_h stream)
+{
+	if(stream == NULL)
+		return __convert_sound_manager_error_code(__func__, SOUND_MANAGER_ERROR_INVALID_PARAMETER);
+
+	pthread_mutex_lock(&g_stream_volume_info.lock);
+	stream->user_cb = NULL;
+	stream->user_data = NULL;
+	pthread_mutex_unlock(&g_stream_volume_info.lock);
+
+	return SOUND_MANAGER_ERROR_NONE;
+}
+
+int sound_manager_stream_volume_destroy(sound_stream_volume_h stream)
+{
+	if(stream == NULL)
+		return __convert_sound_manager_error_code(__func__, SOUND_MANAGER_ERROR_INVALID_PARAMETER);
+
+	pthread_mutex_lock(&g_stream_volume_info.lock);
+	if(stream->prev)
+		stream->prev->next = stream->next;
+	else
+		g_stream_volume_info.head[stream->type] = stream->next;
+	if(stream->next)
+		stream->next->prev = stream->prev;
+	pthread_mutex_unlock(&g_stream_volume_info.lock);
+
+	_sound_manager_volume_monitor_unref();
+
+	free(stream);
+
+	return SOUND_MANAGER_ERROR_NONE;
+}
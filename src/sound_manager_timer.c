@@ -0,0 +1,241 @@
+/*
+* Copyright (c) 2011 Samsung Electronics Co., Ltd All Rights Reserved
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+
+#define LOG_TAG "TIZEN_N_SOUND_MANGER"
+
+#include <sound_manager.h>
+#include <sound_manager_private.h>
+#include <stdio.h>
+#include <string.h>
+#include <malloc.h>
+#include <errno.h>
+#include <time.h>
+#include <pthread.h>
+#include <dlog.h>
+
+/*
+ * Internal timers
+ *
+ * One worker thread, started on first use, runs every library timer. The
+ * application does not need to run a main loop. Callbacks run without the
+ * timer lock held and return non-zero to be scheduled again.
+ */
+typedef struct _sound_manager_timer_s {
+	unsigned int id;
+	unsigned int interval_ms;
+	unsigned long long due;
+	_sound_manager_timer_cb callback;
+	void *user_data;
+	struct _sound_manager_timer_s *next;
+}_sound_manager_timer_s;
+
+typedef struct {
+	pthread_mutex_t lock;
+	pthread_cond_t cond;
+	pthread_t thread;
+	int thread_started;
+	unsigned int last_id;
+	unsigned int running_id;
+	unsigned int running_interval_ms;	/* the interval of the running timer, it may change meanwhile */
+	int running_removed;
+	_sound_manager_timer_s *list;
+}_timer_info_s;
+
+static _timer_info_s g_timer_info = {PTHREAD_MUTEX_INITIALIZER, PTHREAD_COND_INITIALIZER, };
+
+/* keeps the list sorted by due time */
+static void __timer_insert_locked(_sound_manager_timer_s *timer)
+{
+	_sound_manager_timer_s **pos = &g_timer_info.list;
+
+	while(*pos && (*pos)->due <= timer->due)
+		pos = &(*pos)->next;
+	timer->next = *pos;
+	*pos = timer;
+}
+
+static void __timer_wait_locked(unsigned long long due)
+{
+	struct timespec ts;
+	unsigned long long now = _sound_manager_get_time_us();
+	unsigned long long wait_us = due > now ? due - now : 0;
+
+	/* the condition variable runs on the monotonic clock, see __timer_start_locked() */
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	ts.tv_sec += wait_us / 1000000;
+	ts.tv_nsec += (wait_us % 1000000) * 1000;
+	if(ts.tv_nsec >= 1000000000){
+		ts.tv_sec++;
+		ts.tv_nsec -= 1000000000;
+	}
+	pthread_cond_timedwait(&g_timer_info.cond, &g_timer_info.lock, &ts);
+}
+
+static void *__timer_thread(void *data)
+{
+	_sound_manager_timer_s *timer;
+	int again;
+
+	pthread_mutex_lock(&g_timer_info.lock);
+	while(1){
+		timer = g_timer_info.list;
+		if(timer == NULL){
+			pthread_cond_wait(&g_timer_info.cond, &g_timer_info.lock);
+			continue;
+		}
+		if(timer->due > _sound_manager_get_time_us()){
+			__timer_wait_locked(timer->due);
+			continue;
+		}
+
+		g_timer_info.list = timer->next;
+		g_timer_info.running_id = timer->id;
+		g_timer_info.running_interval_ms = timer->interval_ms;
+		g_timer_info.running_removed = 0;
+		pthread_mutex_unlock(&g_timer_info.lock);
+
+		again = timer->callback(timer->user_data);
+
+		pthread_mutex_lock(&g_timer_info.lock);
+		if(again && !g_timer_info.running_removed){
+			timer->interval_ms = g_timer_info.running_interval_ms;
+			timer->due = _sound_manager_get_time_us() + (unsigned long long)timer->interval_ms * 1000;
+			__timer_insert_locked(timer);
+		}else{
+			free(timer);
+		}
+		g_timer_info.running_id = 0;
+		pthread_cond_broadcast(&g_timer_info.cond);
+	}
+
+	return NULL;
+}
+
+static int __timer_start_locked(void)
+{
+	pthread_condattr_t attr;
+	pthread_attr_t thread_attr;
+	int ret;
+
+	if(g_timer_info.thread_started)
+		return 0;
+
+	pthread_condattr_init(&attr);
+	pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+	pthread_cond_destroy(&g_timer_info.cond);
+	pthread_cond_init(&g_timer_info.cond, &attr);
+	pthread_condattr_destroy(&attr);
+
+	pthread_attr_init(&thread_attr);
+	pthread_attr_setdetachstate(&thread_attr, PTHREAD_CREATE_DETACHED);
+	ret = pthread_create(&g_timer_info.thread, &thread_attr, __timer_thread, NULL);
+	pthread_attr_destroy(&thread_attr);
+	if(ret != 0){
+		LOGE("[%s] failed to create the timer thread (%d)", __func__, ret);
+		return -1;
+	}
+
+	g_timer_info.thread_started = 1;
+	return 0;
+}
+
+unsigned int _sound_manager_timer_add(unsigned int interval_ms, _sound_manager_timer_cb callback, void *user_data)
+{
+	_sound_manager_timer_s *timer;
+	unsigned int id;
+
+	if(callback == NULL)
+		return 0;
+
+	timer = malloc(sizeof(_sound_manager_timer_s));
+	if(timer == NULL)
+		return 0;
+
+	memset(timer, 0, sizeof(_sound_manager_timer_s));
+	timer->interval_ms = interval_ms;
+	timer->due = _sound_manager_get_time_us() + (unsigned long long)interval_ms * 1000;
+	timer->callback = callback;
+	timer->user_data = user_data;
+
+	pthread_mutex_lock(&g_timer_info.lock);
+	if(__timer_start_locked() != 0){
+		pthread_mutex_unlock(&g_timer_info.lock);
+		free(timer);
+		return 0;
+	}
+	if(++g_timer_info.last_id == 0)
+		++g_timer_info.last_id;
+	id = timer->id = g_timer_info.last_id;
+	__timer_insert_locked(timer);
+	pthread_cond_broadcast(&g_timer_info.cond);
+	pthread_mutex_unlock(&g_timer_info.lock);
+
+	return id;
+}
+
+void _sound_manager_timer_set_interval(unsigned int id, unsigned int interval_ms)
+{
+	_sound_manager_timer_s *timer;
+
+	if(id == 0)
+		return;
+
+	pthread_mutex_lock(&g_timer_info.lock);
+	if(g_timer_info.running_id == id){
+		g_timer_info.running_interval_ms = interval_ms;
+	}else{
+		for(timer = g_timer_info.list ; timer ; timer = timer->next)
+		{
+			if(timer->id == id){
+				timer->interval_ms = interval_ms;
+				break;
+			}
+		}
+	}
+	pthread_mutex_unlock(&g_timer_info.lock);
+}
+
+void _sound_manager_timer_remove(unsigned int id)
+{
+	_sound_manager_timer_s **pos;
+	_sound_manager_timer_s *timer;
+
+	if(id == 0)
+		return;
+
+	pthread_mutex_lock(&g_timer_info.lock);
+	for(pos = &g_timer_info.list ; *pos ; pos = &(*pos)->next)
+	{
+		if((*pos)->id == id){
+			timer = *pos;
+			*pos = timer->next;
+			free(timer);
+			pthread_mutex_unlock(&g_timer_info.lock);
+			return;
+		}
+	}
+
+	if(g_timer_info.running_id == id){
+		g_timer_info.running_removed = 1;
+		/* wait for the running callback unless it is removing itself */
+		if(!pthread_equal(pthread_self(), g_timer_info.thread)){
+			while(g_timer_info.running_id == id)
+				pthread_cond_wait(&g_timer_info.cond, &g_timer_info.lock);
+		}
+	}
+	pthread_mutex_unlock(&g_timer_info.lock);
+}
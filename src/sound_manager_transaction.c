@@ -0,0 +1,164 @@
+/*
+* Copyright (c) 2011 Samsung Electronics Co., Ltd All Rights Reserved
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+
+#define LOG_TAG "TIZEN_N_SOUND_MANGER"
+
+#include <sound_manager.h>
+#include <sound_manager_private.h>
+#include <stdio.h>
+#include <string.h>
+#include <malloc.h>
+#include <dlog.h>
+
+struct sound_transaction_s
+{
+	int committed;
+	int has_call_session;
+	sound_call_session_type_e call_session_type;
+	sound_call_session_mode_e call_session_mode;
+	int has_route;
+	sound_route_e route;
+	unsigned int volume_mask;
+	int volume[MAX_VOLUME_TYPE + 1];
+};
+
+int sound_manager_transaction_create(sound_transaction_h *transaction)
+{
+	sound_transaction_h handle = NULL;
+
+	if(transaction == NULL)
+		return __convert_sound_manager_error_code(__func__, SOUND_MANAGER_ERROR_INVALID_PARAMETER);
+
+	handle = malloc(sizeof(struct sound_transaction_s));
+	if(!handle)
+		return __convert_sound_manager_error_code(__func__, SOUND_MANAGER_ERROR_OUT_OF_MEMORY);
+
+	memset(handle, 0, sizeof(struct sound_transaction_s));
+
+	*transaction = handle;
+
+	return SOUND_MANAGER_ERROR_NONE;
+}
+
+int sound_manager_transaction_set_call_session(sound_transaction_h transaction, sound_call_session_type_e type, sound_call_session_mode_e mode)
+{
+	if(transaction == NULL || transaction->committed)
+		return __convert_sound_manager_error_code(__func__, SOUND_MANAGER_ERROR_INVALID_PARAMETER);
+	if(type < SOUND_SESSION_TYPE_CALL || type > SOUND_SESSION_TYPE_VOIP)
+		return __convert_sound_manager_error_code(__func__, SOUND_MANAGER_ERROR_INVALID_PARAMETER);
+	if(mode < SOUND_CALL_SESSION_MODE_VOICE || mode > SOUND_CALL_SESSION_MODE_MEDIA)
+		return __convert_sound_manager_error_code(__func__, SOUND_MANAGER_ERROR_INVALID_PARAMETER);
+
+	transaction->has_call_session = 1;
+	transaction->call_session_type = type;
+	transaction->call_session_mode = mode;
+
+	return SOUND_MANAGER_ERROR_NONE;
+}
+
+int sound_manager_transaction_set_active_route(sound_transaction_h transaction, sound_route_e route)
+{
+	if(transaction == NULL || transaction->committed)
+		return __convert_sound_manager_error_code(__func__, SOUND_MANAGER_ERROR_INVALID_PARAMETER);
+	if(_sound_manager_route_policy_find(route) < 0)
+		return __convert_sound_manager_error_code(__func__, SOUND_MANAGER_ERROR_INVALID_PARAMETER);
+
+	transaction->has_route = 1;
+	transaction->route = route;
+
+	return SOUND_MANAGER_ERROR_NONE;
+}
+
+int sound_manager_transaction_set_volume(sound_transaction_h transaction, sound_type_e type, int volume)
+{
+	if(transaction == NULL || transaction->committed)
+		return __convert_sound_manager_error_code(__func__, SOUND_MANAGER_ERROR_INVALID_PARAMETER);
+	if(type > MAX_VOLUME_TYPE || type < 0 || volume < 0)
+		return __convert_sound_manager_error_code(__func__, SOUND_MANAGER_ERROR_INVALID_PARAMETER);
+
+	transaction->volume_mask |= (1 << type);
+	transaction->volume[type] = volume;
+
+	return SOUND_MANAGER_ERROR_NONE;
+}
+
+int sound_manager_transaction_commit(sound_transaction_h transaction, sound_call_session_h *session)
+{
+	int ret = SOUND_MANAGER_ERROR_NONE;
+	sound_call_session_h call_session = NULL;
+	int i;
+
+	if(transaction == NULL || (transaction->has_call_session && session == NULL))
+		return __convert_sound_manager_error_code(__func__, SOUND_MANAGER_ERROR_INVALID_PARAMETER);
+	if(transaction->committed)
+		return __convert_sound_manager_error_code(__func__, SOUND_MANAGER_ERROR_INVALID_OPERATION);
+
+	transaction->committed = 1;
+	if(session)
+		*session = NULL;
+
+	/* levels first, so nothing is heard at the old level once the new path opens; the coalescer must not defer them */
+	for(i = 0 ; i <= MAX_VOLUME_TYPE ; i++)
+	{
+		if(!(transaction->volume_mask & (1 << i)))
+			continue;
+		ret = _sound_manager_volume_coalesce_write_now(i, transaction->volume[i]);
+		if(ret != MM_ERROR_NONE){
+			ret = __convert_sound_manager_error_code(__func__, ret);
+			goto ERROR;
+		}
+	}
+
+	if(transaction->has_call_session) {
+		ret = sound_manager_call_session_create(transaction->call_session_type, &call_session);
+		if(ret != SOUND_MANAGER_ERROR_NONE)
+			goto ERROR;
+	}
+
+	/* route before mode, the mode switch then opens the path on the requested device directly */
+	if(transaction->has_route) {
+		ret = sound_manager_set_active_route(transaction->route);
+		if(ret != SOUND_MANAGER_ERROR_NONE)
+			goto ERROR;
+	}
+
+	if(call_session) {
+		ret = sound_manager_call_session_set_mode(call_session, transaction->call_session_mode);
+		if(ret != SOUND_MANAGER_ERROR_NONE)
+			goto ERROR;
+		*session = call_session;
+	}
+
+	return SOUND_MANAGER_ERROR_NONE;
+
+ERROR:
+	LOGE("[%s] commit failed (0x%08x)", __func__, ret);
+	if(call_session)
+		sound_manager_call_session_destroy(call_session);
+
+	return ret;
+}
+
+int sound_manager_transaction_destroy(sound_transaction_h transaction)
+{
+	if(transaction == NULL)
+		return __convert_sound_manager_error_code(__func__, SOUND_MANAGER_ERROR_INVALID_PARAMETER);
+
+	free(transaction);
+
+	return SOUND_MANAGER_ERROR_NONE;
+}
@@ -0,0 +1,35 @@
+# cmake -DLIBRARY=<so> -DLOAD_BENCH=<exe> -DPROFILE=<name> -P size_report.cmake
+#
+# Prints what a feature profile costs: file and section sizes, dynamic
+# relocations (each one is resolved at load time) and the measured load time.
+
+FILE(READ ${LIBRARY} _content HEX)
+STRING(LENGTH "${_content}" _hex_length)
+MATH(EXPR _file_size "${_hex_length} / 2")
+
+EXECUTE_PROCESS(COMMAND size ${LIBRARY} OUTPUT_VARIABLE _size)
+STRING(REGEX MATCH "\n *([0-9]+)[ \t]+([0-9]+)[ \t]+([0-9]+)" _match "${_size}")
+SET(_text ${CMAKE_MATCH_1})
+SET(_data ${CMAKE_MATCH_2})
+SET(_bss ${CMAKE_MATCH_3})
+
+EXECUTE_PROCESS(COMMAND readelf --wide --relocs ${LIBRARY} OUTPUT_VARIABLE _relocs)
+STRING(REGEX MATCHALL "\n[0-9a-f]+ +[0-9a-f]+ +R_[A-Z0-9_]+" _reloc_lines "${_relocs}")
+LIST(LENGTH _reloc_lines _reloc_count)
+
+EXECUTE_PROCESS(COMMAND readelf --wide --dyn-syms ${LIBRARY} OUTPUT_VARIABLE _syms)
+STRING(REGEX MATCHALL "FUNC +GLOBAL +DEFAULT +[0-9]+ sound_manager_[a-z_]+" _exports "${_syms}")
+LIST(LENGTH _exports _export_count)
+
+EXECUTE_PROCESS(COMMAND ${LOAD_BENCH} ${LIBRARY} OUTPUT_VARIABLE _load RESULT_VARIABLE _load_result)
+
+MESSAGE("profile           ${PROFILE}")
+MESSAGE("file size         ${_file_size} bytes")
+MESSAGE("text/data/bss     ${_text}/${_data}/${_bss} bytes")
+MESSAGE("relocations       ${_reloc_count}")
+MESSAGE("exported API      ${_export_count} functions")
+IF(_load_result EQUAL 0)
+    MESSAGE("${_load}")
+ELSE()
+    MESSAGE("load time         not measured")
+ENDIF()
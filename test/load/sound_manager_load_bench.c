@@ -0,0 +1,101 @@
+/*
+* Copyright (c) 2011 Samsung Electronics Co., Ltd All Rights Reserved
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+
+
+/*
+ * Load time benchmark
+ *
+ * Measures dlopen(RTLD_NOW) + dlclose() of a library, which is what an
+ * application pays at startup for linking it, and the resident memory the
+ * first load adds.
+ *
+ * usage : sound_manager_load_bench <library> [iterations]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <dlfcn.h>
+
+#define DEFAULT_ITERATIONS 200
+
+static double __now_us(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * 1000000.0 + ts.tv_nsec / 1000.0;
+}
+
+static long __rss_kb(void)
+{
+	char line[128];
+	long rss = -1;
+	FILE *fp = fopen("/proc/self/status", "r");
+
+	if(fp == NULL)
+		return -1;
+	while(fgets(line, sizeof(line), fp)) {
+		if(strncmp(line, "VmRSS:", 6) == 0) {
+			rss = atol(line + 6);
+			break;
+		}
+	}
+	fclose(fp);
+	return rss;
+}
+
+int main(int argc, char *argv[])
+{
+	int iterations = argc > 2 ? atoi(argv[2]) : DEFAULT_ITERATIONS;
+	double total = 0;
+	double best = 0;
+	double start;
+	double elapsed;
+	long rss_before;
+	long rss_loaded;
+	void *handle;
+	int i;
+
+	if(argc < 2 || iterations <= 0) {
+		fprintf(stderr, "usage : %s <library> [iterations]\n", argv[0]);
+		return 1;
+	}
+
+	rss_before = __rss_kb();
+	for(i = 0 ; i < iterations ; i++) {
+		start = __now_us();
+		handle = dlopen(argv[1], RTLD_NOW | RTLD_LOCAL);
+		elapsed = __now_us() - start;
+		if(handle == NULL) {
+			fprintf(stderr, "%s\n", dlerror());
+			return 1;
+		}
+		if(i == 0)
+			rss_loaded = __rss_kb();
+		dlclose(handle);
+
+		total += elapsed;
+		if(i == 0 || elapsed < best)
+			best = elapsed;
+	}
+
+	printf("dlopen            %.1f us (best %.1f us, %d runs)\n", total / iterations, best, iterations);
+	printf("rss on first load %ld kB\n", rss_loaded - rss_before);
+	return 0;
+}
@@ -0,0 +1,292 @@
+/*
+* Copyright (c) 2011 Samsung Electronics Co., Ltd All Rights Reserved
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+
+
+/*
+ * Call session handle test
+ *
+ * Checks that the create/destroy cycle of a call session makes no heap
+ * allocation once warm, that destroyed handles are rejected, that the pool
+ * runs out cleanly, that handles survive concurrent use and that of two racing
+ * destroys only one tears the session down. Linked with
+ * -Wl,--wrap=malloc,--wrap=calloc,--wrap=realloc, so every allocation the
+ * library makes is counted.
+ *
+ * usage : sound_manager_alloc_test [cycles] [threads]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <sound_manager.h>
+#include "sound_manager_stub_backend.h"
+#include "sound_manager_bench.h"
+
+#define DEFAULT_CYCLES 1000
+#define DEFAULT_THREADS 8
+#define MAX_THREADS 64
+#define POOL_SIZE 16
+
+void *__real_malloc(size_t size);
+void *__real_calloc(size_t nmemb, size_t size);
+void *__real_realloc(void *ptr, size_t size);
+
+static unsigned long g_allocations;
+
+void *__wrap_malloc(size_t size)
+{
+	__sync_fetch_and_add(&g_allocations, 1);
+	return __real_malloc(size);
+}
+
+void *__wrap_calloc(size_t nmemb, size_t size)
+{
+	__sync_fetch_and_add(&g_allocations, 1);
+	return __real_calloc(nmemb, size);
+}
+
+void *__wrap_realloc(void *ptr, size_t size)
+{
+	__sync_fetch_and_add(&g_allocations, 1);
+	return __real_realloc(ptr, size);
+}
+
+static int __cycle(int i)
+{
+	sound_call_session_h session;
+	sound_call_session_mode_e mode;
+	sound_call_session_type_e type;
+
+	if(sound_manager_call_session_create(SOUND_CALL_SESSION_TYPE_CALL, &session) != SOUND_MANAGER_ERROR_NONE)
+		return -1;
+	if(sound_manager_call_session_set_mode(session, i & 1 ? SOUND_CALL_SESSION_MODE_MEDIA : SOUND_CALL_SESSION_MODE_VOICE) != SOUND_MANAGER_ERROR_NONE
+		|| sound_manager_call_session_get_mode(session, &mode) != SOUND_MANAGER_ERROR_NONE
+		|| sound_manager_call_session_get_type(session, &type) != SOUND_MANAGER_ERROR_NONE){
+		sound_manager_call_session_destroy(session);
+		return -1;
+	}
+	return sound_manager_call_session_destroy(session);
+}
+
+static int __test_no_allocation(int cycles)
+{
+	unsigned long allocations;
+	double start;
+	int i;
+
+	/* first use starts whatever the library keeps for the process */
+	if(__cycle(0) != SOUND_MANAGER_ERROR_NONE)
+		return -1;
+
+	allocations = __sync_fetch_and_add(&g_allocations, 0);
+	start = bench_now_us();
+	for(i = 0 ; i < cycles ; i++)
+	{
+		if(__cycle(i) != SOUND_MANAGER_ERROR_NONE)
+			return -1;
+	}
+	start = bench_now_us() - start;
+	allocations = __sync_fetch_and_add(&g_allocations, 0) - allocations;
+
+	printf("%-28s %d cycles, %.2f us/cycle, %lu allocations\n", "create/destroy", cycles, start / cycles, allocations);
+	return allocations == 0 ? 0 : -1;
+}
+
+static int __test_stale_handle(void)
+{
+	sound_call_session_h session;
+	sound_call_session_h reused;
+	sound_call_session_mode_e mode;
+	int ret = 0;
+
+	if(sound_manager_call_session_create(SOUND_CALL_SESSION_TYPE_VOIP, &session) != SOUND_MANAGER_ERROR_NONE
+		|| sound_manager_call_session_destroy(session) != SOUND_MANAGER_ERROR_NONE)
+		return -1;
+
+	if(sound_manager_call_session_destroy(session) != SOUND_MANAGER_ERROR_INVALID_PARAMETER
+		|| sound_manager_call_session_set_mode(session, SOUND_CALL_SESSION_MODE_VOICE) != SOUND_MANAGER_ERROR_INVALID_PARAMETER
+		|| sound_manager_call_session_get_mode(session, &mode) != SOUND_MANAGER_ERROR_INVALID_PARAMETER
+		|| sound_manager_call_session_activate(session) != SOUND_MANAGER_ERROR_INVALID_PARAMETER)
+		ret = -1;
+
+	/* the slot comes back with a new generation, the old handle stays dead */
+	if(sound_manager_call_session_create(SOUND_CALL_SESSION_TYPE_CALL, &reused) != SOUND_MANAGER_ERROR_NONE)
+		return -1;
+	if(reused == session || sound_manager_call_session_destroy(session) != SOUND_MANAGER_ERROR_INVALID_PARAMETER)
+		ret = -1;
+	if(sound_manager_call_session_destroy(reused) != SOUND_MANAGER_ERROR_NONE)
+		ret = -1;
+
+	printf("%-28s %s\n", "stale handles rejected", ret ? "no" : "yes");
+	return ret;
+}
+
+static int __test_exhaustion(void)
+{
+	sound_call_session_h session[POOL_SIZE + 1];
+	int created = 0;
+	int ret = 0;
+	int i;
+
+	for(i = 0 ; i < POOL_SIZE + 1 ; i++)
+	{
+		if(sound_manager_call_session_prepare(SOUND_CALL_SESSION_TYPE_CALL, &session[i]) != SOUND_MANAGER_ERROR_NONE)
+			break;
+		created++;
+	}
+	if(created != POOL_SIZE)
+		ret = -1;
+	for(i = 0 ; i < created ; i++)
+	{
+		if(sound_manager_call_session_destroy(session[i]) != SOUND_MANAGER_ERROR_NONE)
+			ret = -1;
+	}
+
+	printf("%-28s %d handles\n", "pool", created);
+	return ret;
+}
+
+typedef struct {
+	sound_call_session_h session;
+	int destroyed;
+	long errors;
+}_race_s;
+
+static void *__user(void *data)
+{
+	_race_s *race = data;
+	sound_call_session_mode_e mode;
+	int ret;
+	int i;
+
+	for(i = 0 ; !__sync_fetch_and_add(&race->destroyed, 0) ; i++)
+	{
+		ret = sound_manager_call_session_set_mode(race->session, i & 1 ? SOUND_CALL_SESSION_MODE_MEDIA : SOUND_CALL_SESSION_MODE_VOICE);
+		if(ret == SOUND_MANAGER_ERROR_NONE)
+			ret = sound_manager_call_session_get_mode(race->session, &mode);
+		if(ret != SOUND_MANAGER_ERROR_NONE && ret != SOUND_MANAGER_ERROR_INVALID_PARAMETER)
+			race->errors++;
+	}
+	return NULL;
+}
+
+static void *__destroyer(void *data)
+{
+	_race_s *race = data;
+
+	return (void *)(long)(sound_manager_call_session_destroy(race->session) == SOUND_MANAGER_ERROR_NONE);
+}
+
+static int __test_racing_destroy(int rounds)
+{
+	pthread_t user;
+	pthread_t destroyer[2];
+	_race_s race;
+	void *destroyed;
+	long wins;
+	int ret = 0;
+	int i;
+	int j;
+
+	for(i = 0 ; i < rounds ; i++)
+	{
+		memset(&race, 0, sizeof(race));
+		if(sound_manager_call_session_create(SOUND_CALL_SESSION_TYPE_CALL, &race.session) != SOUND_MANAGER_ERROR_NONE)
+			return -1;
+		pthread_create(&user, NULL, __user, &race);
+		wins = 0;
+		for(j = 0 ; j < 2 ; j++)
+			pthread_create(&destroyer[j], NULL, __destroyer, &race);
+		for(j = 0 ; j < 2 ; j++)
+		{
+			pthread_join(destroyer[j], &destroyed);
+			wins += (long)destroyed;
+		}
+		__sync_lock_test_and_set(&race.destroyed, 1);
+		pthread_join(user, NULL);
+
+		/* exactly one destroy tears the session down, the user only ever sees a live or a dead handle */
+		if(wins != 1 || race.errors
+			|| sound_manager_call_session_set_mode(race.session, SOUND_CALL_SESSION_MODE_VOICE) != SOUND_MANAGER_ERROR_INVALID_PARAMETER)
+			ret = -1;
+	}
+
+	printf("%-28s %d rounds %s\n", "racing destroy", rounds, ret ? "failed" : "passed");
+	return ret == 0 && __test_exhaustion() == 0 ? 0 : -1;
+}
+
+static void *__worker(void *data)
+{
+	long cycles = (long)data;
+	long failed = 0;
+	long i;
+
+	for(i = 0 ; i < cycles ; i++)
+	{
+		if(__cycle(i) != SOUND_MANAGER_ERROR_NONE)
+			failed++;
+	}
+	return (void *)failed;
+}
+
+static int __test_concurrent(int cycles, int threads)
+{
+	pthread_t thread[MAX_THREADS];
+	void *failed;
+	long failures = 0;
+	int i;
+
+	for(i = 0 ; i < threads ; i++)
+		pthread_create(&thread[i], NULL, __worker, (void *)(long)cycles);
+	for(i = 0 ; i < threads ; i++)
+	{
+		pthread_join(thread[i], &failed);
+		failures += (long)failed;
+	}
+
+	printf("%-28s %d threads, %ld failures\n", "concurrent create/destroy", threads, failures);
+	/* nothing leaked from the pool */
+	return failures == 0 && __test_exhaustion() == 0 ? 0 : -1;
+}
+
+int main(int argc, char *argv[])
+{
+	int cycles = DEFAULT_CYCLES;
+	int threads = DEFAULT_THREADS;
+	int ret = 0;
+
+	if(bench_parse_args(argc, argv, "[cycles] [threads]", &cycles, 1, &threads, 1, NULL) != 0)
+		return 1;
+	if(threads > POOL_SIZE || threads > MAX_THREADS) {
+		fprintf(stderr, "usage : %s [cycles] [threads(1~%d)]\n", argv[0], POOL_SIZE < MAX_THREADS ? POOL_SIZE : MAX_THREADS);
+		return 1;
+	}
+
+	if(__test_no_allocation(cycles) != 0)
+		ret = 1;
+	if(__test_stale_handle() != 0)
+		ret = 1;
+	if(__test_exhaustion() != 0)
+		ret = 1;
+	if(__test_concurrent(cycles / threads + 1, threads) != 0)
+		ret = 1;
+	if(__test_racing_destroy(cycles / 10 + 1) != 0)
+		ret = 1;
+
+	return bench_end(ret);
+}
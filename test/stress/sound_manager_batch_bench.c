@@ -0,0 +1,249 @@
+/*
+* Copyright (c) 2011 Samsung Electronics Co., Ltd All Rights Reserved
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+
+
+/*
+ * Batched event delivery benchmark
+ *
+ * A telemetry consumer subscribes to every volume, session, route and device
+ * event, either with the per-event callbacks or with one batched callback.
+ * The stub backend fires a burst of events and the consumer counts what it
+ * receives; the batched records are checked for order, and the records
+ * dropped while the consumer was behind are accounted for by the sequence.
+ * A callback unsetting and registering again from its own delivery keeps
+ * receiving, and one which only unsets gets nothing more of its batch.
+ *
+ * usage : sound_manager_batch_bench [events]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <sound_manager.h>
+#include "sound_manager_stub_backend.h"
+#include "sound_manager_bench.h"
+
+#define DEFAULT_EVENTS 100000
+#define BATCH_WINDOW_MS 5
+#define BATCH_MAX 64
+#define UNSUBSCRIBE_EVENTS 8
+#define UNSUBSCRIBE_HOLD_US 50000
+
+typedef struct {
+	unsigned long events;
+	unsigned long calls;
+	unsigned int last_sequence;
+	unsigned long dropped;
+	unsigned long mismatches;
+}_consumer_s;
+
+static _consumer_s g_consumer;
+
+static void __volume_changed_cb(sound_type_e type, unsigned int volume, void *user_data)
+{
+	g_consumer.events++;
+	g_consumer.calls++;
+}
+
+static void __session_notify_cb(sound_session_notify_e notify, void *user_data)
+{
+	g_consumer.events++;
+	g_consumer.calls++;
+}
+
+static void __available_route_changed_cb(sound_route_e route, bool available, void *user_data)
+{
+	g_consumer.events++;
+	g_consumer.calls++;
+}
+
+static void __active_device_changed_cb(sound_device_in_e in, sound_device_out_e out, void *user_data)
+{
+	g_consumer.events++;
+	g_consumer.calls++;
+}
+
+static void __event_batch_cb(const sound_event_s *events, unsigned int count, void *user_data)
+{
+	unsigned int i;
+
+	__sync_fetch_and_add(&g_consumer.calls, 1);
+	for(i = 0 ; i < count ; i++)
+	{
+		if(events[i].sequence <= g_consumer.last_sequence)
+			g_consumer.mismatches++;
+		else
+			__sync_fetch_and_add(&g_consumer.dropped, events[i].sequence - g_consumer.last_sequence - 1);
+		g_consumer.last_sequence = events[i].sequence;
+		/* the injector emits the kinds round robin */
+		if(events[i].type != (events[i].sequence - 1) % 4)
+			g_consumer.mismatches++;
+	}
+	__sync_fetch_and_add(&g_consumer.events, count);
+}
+
+static void __resubscribed_cb(const sound_event_s *events, unsigned int count, void *user_data)
+{
+	__sync_fetch_and_add((unsigned long *)user_data, count);
+}
+
+/* leaves and comes back from its own delivery thread */
+static void __resubscribe_cb(const sound_event_s *events, unsigned int count, void *user_data)
+{
+	sound_manager_unset_event_batch_cb();
+	sound_manager_set_event_batch_cb(0, 1, __resubscribed_cb, user_data);
+}
+
+static int __check_resubscribe(void)
+{
+	unsigned long received = 0;
+	int i;
+
+	if(sound_manager_set_event_batch_cb(0, 1, __resubscribe_cb, &received) != SOUND_MANAGER_ERROR_NONE)
+		return -1;
+	stub_backend_emit_volume_changed(SOUND_TYPE_MEDIA);
+	for(i = 0 ; i < 100 && __sync_fetch_and_add(&received, 0) == 0 ; i++)
+	{
+		usleep(1000);
+		stub_backend_emit_volume_changed(SOUND_TYPE_MEDIA);
+	}
+	sound_manager_unset_event_batch_cb();
+
+	printf("%-20s %s\n", "resubscribed", received ? "yes" : "no");
+	return received ? 0 : -1;
+}
+
+static void __unsubscribe_cb(const sound_event_s *events, unsigned int count, void *user_data)
+{
+	int calls = __sync_add_and_fetch((int *)user_data, 1);
+
+	/* the events emitted meanwhile make the next batch, handed out one at a time */
+	if(calls == 1)
+		usleep(UNSUBSCRIBE_HOLD_US);
+	else
+		sound_manager_unset_event_batch_cb();
+}
+
+static int __check_unsubscribe(void)
+{
+	int calls = 0;
+	int i;
+
+	if(sound_manager_set_event_batch_cb(0, 1, __unsubscribe_cb, &calls) != SOUND_MANAGER_ERROR_NONE)
+		return -1;
+	stub_backend_emit_volume_changed(SOUND_TYPE_MEDIA);
+	for(i = 0 ; i < 100 && __sync_fetch_and_add(&calls, 0) == 0 ; i++)
+		usleep(1000);
+	for(i = 0 ; i < UNSUBSCRIBE_EVENTS ; i++)
+		stub_backend_emit_volume_changed(SOUND_TYPE_MEDIA);
+	usleep(2 * UNSUBSCRIBE_HOLD_US);
+	sound_manager_unset_event_batch_cb();
+
+	printf("%-20s %s\n", "unsubscribed", calls == 2 ? "yes" : "no");
+	return calls == 2 ? 0 : -1;
+}
+
+static void __emit(int events)
+{
+	int i;
+
+	for(i = 0 ; i < events ; i++)
+	{
+		switch(i % 4){
+			case SOUND_EVENT_VOLUME_CHANGED:
+				stub_backend_emit_volume_changed(SOUND_TYPE_MEDIA);
+				break;
+			case SOUND_EVENT_SESSION_NOTIFY:
+				stub_backend_emit_session(MM_SESSION_MSG_RESUME, MM_SESSION_EVENT_OTHER_APP);
+				break;
+			case SOUND_EVENT_AVAILABLE_ROUTE_CHANGED:
+				stub_backend_emit_available_route_changed(SOUND_ROUTE_OUT_WIRED_ACCESSORY, i & 1);
+				break;
+			default:
+				stub_backend_emit_active_device_changed(SOUND_DEVICE_IN_MIC, SOUND_DEVICE_OUT_SPEAKER);
+				break;
+		}
+		/* bursts of half a batch */
+		if(i % (BATCH_MAX / 2) == 0)
+			usleep(50);
+	}
+}
+
+static void __report(const char *name)
+{
+	printf("%-20s %10lu %10lu %10lu %12.1f\n", name, g_consumer.events, g_consumer.dropped, g_consumer.calls,
+		(double)g_consumer.events / (g_consumer.calls ? g_consumer.calls : 1));
+}
+
+int main(int argc, char *argv[])
+{
+	int events = DEFAULT_EVENTS;
+	unsigned long received;
+	int ret = 0;
+	int i;
+
+	if(bench_parse_args(argc, argv, "[events]", &events, 1, NULL) != 0)
+		return 1;
+
+	printf("%d events, %dms window, batches of up to %d records of %zu bytes\n", events, BATCH_WINDOW_MS, BATCH_MAX, sizeof(sound_event_s));
+	printf("%-20s %10s %10s %10s %12s\n", "", "events", "dropped", "callbacks", "events/call");
+
+	if(sound_manager_set_volume_changed_cb(__volume_changed_cb, NULL) != SOUND_MANAGER_ERROR_NONE
+		|| sound_manager_set_session_notify_cb(__session_notify_cb, NULL) != SOUND_MANAGER_ERROR_NONE
+		|| sound_manager_set_available_route_changed_cb(__available_route_changed_cb, NULL) != SOUND_MANAGER_ERROR_NONE
+		|| sound_manager_set_active_device_changed_cb(__active_device_changed_cb, NULL) != SOUND_MANAGER_ERROR_NONE)
+		return 1;
+	__emit(events);
+	__report("per-event callbacks");
+	if(g_consumer.events != (unsigned long)events)
+		ret = 1;
+	sound_manager_unset_volume_changed_cb();
+	sound_manager_unset_session_notify_cb();
+	sound_manager_unset_available_route_changed_cb();
+	sound_manager_unset_active_device_changed_cb();
+
+	g_consumer.events = 0;
+	g_consumer.calls = 0;
+	if(sound_manager_set_event_batch_cb(BATCH_WINDOW_MS, BATCH_MAX, __event_batch_cb, NULL) != SOUND_MANAGER_ERROR_NONE)
+		return 1;
+	__emit(events);
+	/* the last batch waits for its window */
+	for(i = 0 ; i < 100 ; i++)
+	{
+		received = __sync_fetch_and_add(&g_consumer.events, 0);
+		if(received + __sync_fetch_and_add(&g_consumer.dropped, 0) >= (unsigned long)events)
+			break;
+		usleep(BATCH_WINDOW_MS * 1000);
+	}
+	sound_manager_unset_event_batch_cb();
+	__report("batched");
+
+	/* every event is either delivered in order or counted as dropped */
+	if(g_consumer.events + g_consumer.dropped != (unsigned long)events || g_consumer.last_sequence != (unsigned int)events
+		|| g_consumer.mismatches || g_consumer.calls >= g_consumer.events){
+		printf("sequence %u, order or kind mismatches %lu\n", g_consumer.last_sequence, g_consumer.mismatches);
+		ret = 1;
+	}
+
+	/* the thread left by an unset from its own callback is joined by the next registration */
+	if(__check_unsubscribe() != 0)
+		ret = 1;
+	if(__check_resubscribe() != 0)
+		ret = 1;
+
+	return bench_end(ret);
+}
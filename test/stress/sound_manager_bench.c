@@ -0,0 +1,86 @@
+/*
+* Copyright (c) 2011 Samsung Electronics Co., Ltd All Rights Reserved
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <time.h>
+#include "sound_manager_stub_backend.h"
+#include "sound_manager_bench.h"
+
+double bench_now_us(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * 1000000.0 + ts.tv_nsec / 1000.0;
+}
+
+int bench_parse_args(int argc, char *argv[], const char *usage, ...)
+{
+	va_list ap;
+	int *value;
+	int min;
+	int i = 1;
+	int ret = 0;
+
+	va_start(ap, usage);
+	while((value = va_arg(ap, int *)) != NULL)
+	{
+		min = va_arg(ap, int);
+		if(i < argc)
+			*value = atoi(argv[i]);
+		if(*value < min)
+			ret = -1;
+		i++;
+	}
+	va_end(ap);
+
+	if(argc > i)
+		ret = -1;
+	if(ret != 0)
+		fprintf(stderr, "usage : %s %s\n", argv[0], usage);
+	return ret;
+}
+
+void bench_begin(unsigned int round_trip_us)
+{
+	stub_backend_set_latency(round_trip_us);
+}
+
+int bench_end(int failed)
+{
+	stub_backend_set_latency(0);
+	printf("%s\n", failed ? "FAIL" : "PASS");
+	return failed ? 1 : 0;
+}
+
+void bench_span_begin(bench_span_s *span)
+{
+	span->calls = stub_backend_get_call_count();
+	span->start_us = bench_now_us();
+}
+
+double bench_span_end(const bench_span_s *span, unsigned long *calls)
+{
+	double elapsed = bench_now_us() - span->start_us;
+
+	if(calls)
+		*calls = stub_backend_get_call_count() - span->calls;
+	return elapsed;
+}
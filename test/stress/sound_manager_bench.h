@@ -0,0 +1,59 @@
+/*
+* Copyright (c) 2011 Samsung Electronics Co., Ltd All Rights Reserved
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+
+
+
+#ifndef __TIZEN_MEDIA_SOUND_MANAGER_BENCH_H__
+#define __TIZEN_MEDIA_SOUND_MANAGER_BENCH_H__
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/*
+ * Helpers shared by the benchmarks and tests built over the stub backend.
+ */
+
+typedef struct {
+	double start_us;
+	unsigned long calls;
+}bench_span_s;
+
+double bench_now_us(void);
+
+/*
+ * Reads the optional arguments in order, each given as an int pointer holding
+ * its default followed by the smallest accepted value, up to a NULL pointer.
+ * Prints the usage and returns -1 when an argument is out of range.
+ */
+int bench_parse_args(int argc, char *argv[], const char *usage, ...);
+
+/* charges round_trip_us to every request reaching the stub backend */
+void bench_begin(unsigned int round_trip_us);
+/* clears the round trip and prints the verdict, returns the exit status */
+int bench_end(int failed);
+
+/* elapsed time and backend requests of a measured section */
+void bench_span_begin(bench_span_s *span);
+double bench_span_end(const bench_span_s *span, unsigned long *calls);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __TIZEN_MEDIA_SOUND_MANAGER_BENCH_H__ */
@@ -0,0 +1,123 @@
+/*
+* Copyright (c) 2011 Samsung Electronics Co., Ltd All Rights Reserved
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+
+
+/*
+ * Call answer latency benchmark
+ *
+ * Measures the time from answering a call until the call audio can start:
+ * the call session is switched in voice mode and the call volume is known.
+ * The session is either created on answer or prepared while the ringtone
+ * plays and activated on answer. The stub backend charges a fixed round trip
+ * per request.
+ *
+ * usage : sound_manager_call_bench [iterations] [round_trip_us]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <sound_manager.h>
+#include "sound_manager_stub_backend.h"
+#include "sound_manager_bench.h"
+
+#define DEFAULT_ITERATIONS 100
+#define DEFAULT_ROUND_TRIP_US 200
+/* long enough for the preparation to finish on the internal thread */
+#define RINGING_US 20000
+
+static int __audio_ready(void)
+{
+	int max;
+	int volume;
+
+	if(sound_manager_get_max_volume(SOUND_TYPE_CALL, &max) != SOUND_MANAGER_ERROR_NONE)
+		return -1;
+	return sound_manager_get_volume(SOUND_TYPE_CALL, &volume);
+}
+
+static int __answer(int prepare, int iterations)
+{
+	sound_call_session_h session = NULL;
+	bench_span_s span;
+	unsigned long calls = 0;
+	unsigned long requests;
+	double elapsed = 0;
+	double best = 0;
+	double start;
+	int ret;
+	int i;
+
+	for(i = 0 ; i < iterations ; i++)
+	{
+		if(prepare){
+			if(sound_manager_call_session_prepare(SOUND_CALL_SESSION_TYPE_CALL, &session) != SOUND_MANAGER_ERROR_NONE
+				|| sound_manager_call_session_set_mode(session, SOUND_CALL_SESSION_MODE_VOICE) != SOUND_MANAGER_ERROR_NONE)
+				return -1;
+		}
+		usleep(RINGING_US);
+
+		bench_span_begin(&span);
+		if(prepare){
+			ret = sound_manager_call_session_activate(session);
+		}else{
+			ret = sound_manager_call_session_create(SOUND_CALL_SESSION_TYPE_CALL, &session);
+			if(ret == SOUND_MANAGER_ERROR_NONE)
+				ret = sound_manager_call_session_set_mode(session, SOUND_CALL_SESSION_MODE_VOICE);
+		}
+		if(ret == SOUND_MANAGER_ERROR_NONE)
+			ret = __audio_ready();
+		start = bench_span_end(&span, &requests);
+		calls += requests;
+
+		if(session)
+			sound_manager_call_session_destroy(session);
+		session = NULL;
+		if(ret != SOUND_MANAGER_ERROR_NONE)
+			return -1;
+
+		elapsed += start;
+		if(i == 0 || start < best)
+			best = start;
+	}
+
+	printf("%-28s %10.1f %10.1f %14.1f\n", prepare ? "prepare + activate" : "create on answer",
+		elapsed / iterations, best, (double)calls / iterations);
+	return 0;
+}
+
+int main(int argc, char *argv[])
+{
+	int iterations = DEFAULT_ITERATIONS;
+	int round_trip_us = DEFAULT_ROUND_TRIP_US;
+	int ret = 0;
+
+	if(bench_parse_args(argc, argv, "[iterations] [round_trip_us]", &iterations, 1, &round_trip_us, 0, NULL) != 0)
+		return 1;
+
+	bench_begin(round_trip_us);
+
+	printf("%d iterations, %dus round trip\n", iterations, round_trip_us);
+	printf("%-28s %10s %10s %14s\n", "", "us/answer", "best us", "requests");
+	if(__answer(0, iterations) != 0)
+		ret = 1;
+	if(__answer(1, iterations) != 0)
+		ret = 1;
+
+
+	return bench_end(ret);
+}
@@ -0,0 +1,145 @@
+/*
+* Copyright (c) 2011 Samsung Electronics Co., Ltd All Rights Reserved
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+
+
+/*
+ * Volume coalescing test
+ *
+ * A slider drag sets the media volume many times in a row while coalescing
+ * is enabled. Checks that the sound server receives no more levels than the
+ * rate allows, that the last level set is the one it ends up with, and that
+ * a slow write does not hold the coalescer lock.
+ *
+ * usage : sound_manager_coalesce_test [writes] [round_trip_us]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <mm_sound.h>
+#include <sound_manager.h>
+#include "sound_manager_stub_backend.h"
+#include "sound_manager_bench.h"
+
+#define DEFAULT_WRITES 200
+#define DEFAULT_ROUND_TRIP_US 200
+#define MAX_RATE 20
+#define INTERVAL_US (1000000 / MAX_RATE)
+#define DRAG_STEP_US 1000
+#define SLOW_WRITE_US 100000
+
+static int __backend_volume(sound_type_e type)
+{
+	unsigned int volume = 0;
+
+	mm_sound_volume_get_value(type, &volume);
+	return volume;
+}
+
+static int __drag(int writes, int *last)
+{
+	int i;
+
+	for(i = 0 ; i < writes ; i++)
+	{
+		*last = 1 + i % 14;
+		if(sound_manager_set_volume(SOUND_TYPE_MEDIA, *last) != SOUND_MANAGER_ERROR_NONE)
+			return -1;
+		usleep(DRAG_STEP_US);
+	}
+	return 0;
+}
+
+static int __test_coalesced(int writes)
+{
+	sound_volume_coalescing_stats_s stats;
+	unsigned int allowed;
+	double elapsed;
+	int volume;
+	int last = 0;
+	int ret = 0;
+
+	sound_manager_reset_volume_coalescing_stats();
+	elapsed = bench_now_us();
+	if(__drag(writes, &last) != 0)
+		return -1;
+	elapsed = bench_now_us() - elapsed;
+
+	/* the waiting level goes out once its interval ends */
+	usleep(2 * INTERVAL_US);
+	sound_manager_get_volume_coalescing_stats(&stats);
+	/* one write per interval over the drag and the interval the last level waited for, plus the first one */
+	allowed = (elapsed + INTERVAL_US) / INTERVAL_US + 2;
+	volume = __backend_volume(SOUND_TYPE_MEDIA);
+
+	printf("%-28s %d writes in %.0f ms, %u sent (at most %u), %u coalesced, level %d of %d\n", "slider drag",
+		writes, elapsed / 1000, stats.issued, allowed, stats.coalesced, volume, last);
+	if(stats.requested != (unsigned int)writes || stats.issued > allowed || stats.issued + stats.coalesced != stats.requested
+		|| volume != last)
+		ret = -1;
+	return ret;
+}
+
+static void *__slow_write(void *data)
+{
+	/* far from the last sent level, so it is sent right away */
+	sound_manager_set_volume(SOUND_TYPE_MEDIA, __backend_volume(SOUND_TYPE_MEDIA) > 7 ? 1 : 14);
+	return NULL;
+}
+
+static int __test_unlocked_write(void)
+{
+	sound_volume_coalescing_stats_s stats;
+	pthread_t thread;
+	double waited;
+
+	bench_begin(SLOW_WRITE_US);
+	pthread_create(&thread, NULL, __slow_write, NULL);
+	usleep(SLOW_WRITE_US / 10);
+	waited = bench_now_us();
+	sound_manager_get_volume_coalescing_stats(&stats);
+	waited = bench_now_us() - waited;
+	pthread_join(thread, NULL);
+
+	printf("%-28s %.0f us while a write takes %d us\n", "stats during a write", waited, SLOW_WRITE_US);
+	return waited < SLOW_WRITE_US / 2 ? 0 : -1;
+}
+
+int main(int argc, char *argv[])
+{
+	int writes = DEFAULT_WRITES;
+	int round_trip_us = DEFAULT_ROUND_TRIP_US;
+	int ret = 0;
+
+	if(bench_parse_args(argc, argv, "[writes] [round_trip_us]", &writes, 1, &round_trip_us, 0, NULL) != 0)
+		return 1;
+
+	/* every level of the drag is within the tolerance */
+	if(sound_manager_set_volume(SOUND_TYPE_MEDIA, 1) != SOUND_MANAGER_ERROR_NONE
+		|| sound_manager_set_volume_coalescing(MAX_RATE, 15) != SOUND_MANAGER_ERROR_NONE)
+		return 1;
+	bench_begin(round_trip_us);
+
+	if(__test_coalesced(writes) != 0)
+		ret = 1;
+	if(__test_unlocked_write() != 0)
+		ret = 1;
+
+	sound_manager_set_volume_coalescing(0, 0);
+	return bench_end(ret);
+}
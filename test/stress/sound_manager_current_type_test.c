@@ -0,0 +1,112 @@
+/*
+* Copyright (c) 2011 Samsung Electronics Co., Ltd All Rights Reserved
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+
+
+/*
+ * Current sound type test
+ *
+ * Subscribes to the current sound type and leaves the stub backend playing
+ * the same type. Once the library has slowed down, it must ask the sound
+ * server about once a second, and a change must bring the fast sampling
+ * back so the next one is seen quickly.
+ *
+ * usage : sound_manager_current_type_test
+ */
+
+#include <stdio.h>
+#include <unistd.h>
+#include <sound_manager.h>
+#include "sound_manager_stub_backend.h"
+#include "sound_manager_bench.h"
+
+#define SETTLE_US 3000000	/* longer than the backoff takes to reach its maximum */
+#define IDLE_WINDOW_US 2000000
+#define IDLE_MAX_REQUESTS 3
+#define SLOW_CHANGE_US 1500000
+#define FAST_CHANGE_US 500000
+
+static int g_changes;
+static int g_playing;
+
+static void __current_sound_type_changed_cb(sound_type_e type, bool playing, void *user_data)
+{
+	__sync_lock_test_and_set(&g_playing, playing ? 1 : 0);
+	__sync_fetch_and_add(&g_changes, 1);
+}
+
+/* waits until the callback ran more than changes times */
+static int __wait_change(int changes, double timeout_us)
+{
+	double start_us = bench_now_us();
+
+	while(__sync_fetch_and_add(&g_changes, 0) <= changes)
+	{
+		if(bench_now_us() - start_us > timeout_us)
+			return -1;
+		usleep(1000);
+	}
+	return 0;
+}
+
+static int __test_idle_backoff(void)
+{
+	unsigned long calls;
+	int changes;
+	int ret = 0;
+
+	stub_backend_set_playing_type(SOUND_TYPE_MEDIA);
+	if(sound_manager_set_current_sound_type_changed_cb(__current_sound_type_changed_cb, NULL) != SOUND_MANAGER_ERROR_NONE
+		|| __wait_change(0, SLOW_CHANGE_US) != 0)
+		return -1;
+
+	usleep(SETTLE_US);
+	calls = stub_backend_get_call_count();
+	usleep(IDLE_WINDOW_US);
+	calls = stub_backend_get_call_count() - calls;
+	if(calls > IDLE_MAX_REQUESTS)
+		ret = -1;
+
+	/* the first change after the quiet period may take up to the longest interval */
+	changes = __sync_fetch_and_add(&g_changes, 0);
+	stub_backend_set_playing_type(-1);
+	if(__wait_change(changes, SLOW_CHANGE_US) != 0 || __sync_fetch_and_add(&g_playing, 0))
+		ret = -1;
+
+	/* and the one right after it is sampled fast again */
+	changes = __sync_fetch_and_add(&g_changes, 0);
+	stub_backend_set_playing_type(SOUND_TYPE_MEDIA);
+	if(__wait_change(changes, FAST_CHANGE_US) != 0 || !__sync_fetch_and_add(&g_playing, 0))
+		ret = -1;
+
+	sound_manager_unset_current_sound_type_changed_cb();
+	printf("%-36s %lu\n", "requests while idle for 2s", calls);
+	printf("%-36s %s\n", "sampling slowed down while idle", ret ? "no" : "yes");
+	return ret;
+}
+
+int main(int argc, char *argv[])
+{
+	int ret = 0;
+
+	if(bench_parse_args(argc, argv, "", NULL) != 0)
+		return 1;
+
+	if(__test_idle_backoff() != 0)
+		ret = 1;
+
+	return bench_end(ret);
+}
@@ -0,0 +1,125 @@
+/*
+* Copyright (c) 2011 Samsung Electronics Co., Ltd All Rights Reserved
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+
+
+/*
+ * C++ wrapper overhead benchmark
+ *
+ * Runs the same calls through the C API and through sound_manager.hpp over the
+ * stub backend: a cached getter, a call session round trip and the delivery of
+ * a volume change notification to a C callback and to a wrapped lambda.
+ *
+ * usage : sound_manager_cxx_bench [iterations]
+ */
+
+#include <cstdio>
+#include <sound_manager.hpp>
+#include "sound_manager_stub_backend.h"
+#include "sound_manager_bench.h"
+
+#define DEFAULT_ITERATIONS 200000
+
+namespace sound = tizen::sound;
+
+static unsigned long g_c_events;
+static int g_errors;
+
+static void __volume_changed_cb(sound_type_e type, unsigned int volume, void *user_data)
+{
+	g_c_events++;
+}
+
+template <typename F>
+static double __measure(int iterations, F &&body)
+{
+	double start = bench_now_us();
+
+	for(int i = 0 ; i < iterations ; i++)
+		body(i);
+	return (bench_now_us() - start) * 1000 / iterations;
+}
+
+static void __report(const char *name, double c_ns, double cxx_ns)
+{
+	printf("%-24s %10.1f %10.1f %8.2f\n", name, c_ns, cxx_ns, c_ns > 0 ? cxx_ns / c_ns : 0.0);
+}
+
+int main(int argc, char *argv[])
+{
+	int iterations = DEFAULT_ITERATIONS;
+	unsigned long cxx_events = 0;
+	double c_ns;
+	double cxx_ns;
+
+	if(bench_parse_args(argc, argv, "[iterations]", &iterations, 1, NULL) != 0)
+		return 1;
+
+	printf("%-24s %10s %10s %8s\n", "", "C ns", "C++ ns", "ratio");
+
+	/* the volume change notification keeps the level cached, so only the call itself is measured */
+	if(sound_manager_set_volume_changed_cb(__volume_changed_cb, NULL) != SOUND_MANAGER_ERROR_NONE)
+		return 1;
+	c_ns = __measure(iterations, [](int) {
+		int volume;
+		if(sound_manager_get_volume(SOUND_TYPE_MEDIA, &volume) != SOUND_MANAGER_ERROR_NONE)
+			g_errors++;
+	});
+	cxx_ns = __measure(iterations, [](int) {
+		if(!sound::get_volume(SOUND_TYPE_MEDIA))
+			g_errors++;
+	});
+	__report("get_volume (cached)", c_ns, cxx_ns);
+
+	c_ns = __measure(iterations / 10, [](int i) {
+		sound_call_session_h session;
+		if(sound_manager_call_session_create(SOUND_CALL_SESSION_TYPE_CALL, &session) != SOUND_MANAGER_ERROR_NONE){
+			g_errors++;
+			return;
+		}
+		sound_manager_call_session_set_mode(session, (sound_call_session_mode_e)(i % 3));
+		sound_manager_call_session_destroy(session);
+	});
+	cxx_ns = __measure(iterations / 10, [](int i) {
+		auto session = sound::call_session::create(SOUND_CALL_SESSION_TYPE_CALL);
+		if(!session){
+			g_errors++;
+			return;
+		}
+		session->set_mode((sound_call_session_mode_e)(i % 3));
+	});
+	__report("call session", c_ns, cxx_ns);
+
+	c_ns = __measure(iterations / 10, [](int) {
+		stub_backend_emit_volume_changed(SOUND_TYPE_MEDIA);
+	});
+	sound_manager_unset_volume_changed_cb();
+	{
+		auto on_changed = [&cxx_events](sound_type_e, unsigned int) { cxx_events++; };
+		auto subscription = sound::on_volume_changed(on_changed);
+		if(!subscription)
+			return 1;
+		cxx_ns = __measure(iterations / 10, [](int) {
+			stub_backend_emit_volume_changed(SOUND_TYPE_MEDIA);
+		});
+	}
+	__report("volume changed event", c_ns, cxx_ns);
+
+	if(g_c_events != (unsigned long)(iterations / 10) || cxx_events != (unsigned long)(iterations / 10))
+		g_errors++;
+
+	return bench_end(g_errors);
+}
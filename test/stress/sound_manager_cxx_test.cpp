@@ -0,0 +1,93 @@
+/*
+* Copyright (c) 2011 Samsung Electronics Co., Ltd All Rights Reserved
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+
+
+/*
+ * C++ wrapper test
+ *
+ * Built with -std=c++17 -Wall -Werror, so it also checks that the header
+ * compiles on its own. Replaces a subscription with a newer one of the same
+ * kind and checks that resetting, moving or destroying the older one leaves
+ * the newer registration in place.
+ *
+ * usage : sound_manager_cxx_test
+ */
+
+#include <cstdio>
+#include <type_traits>
+#include <sound_manager.hpp>
+#include "sound_manager_stub_backend.h"
+#include "sound_manager_bench.h"
+
+namespace sound = tizen::sound;
+
+static_assert(!std::is_copy_constructible_v<sound::subscription>, "a subscription is move only");
+static_assert(std::is_nothrow_move_constructible_v<sound::subscription>, "a subscription moves without throwing");
+static_assert(std::is_nothrow_move_assignable_v<sound::subscription>, "a subscription moves without throwing");
+static_assert(!std::is_copy_constructible_v<sound::call_session>, "a call session is move only");
+
+static int __test_replaced_subscription()
+{
+	int first_events = 0;
+	int second_events = 0;
+	auto first = [&first_events](sound_type_e, unsigned int) { first_events++; };
+	auto second = [&second_events](sound_type_e, unsigned int) { second_events++; };
+	int ret = 0;
+
+	auto older = sound::on_volume_changed(first);
+	auto newer = sound::on_volume_changed(second);
+	if(!older || !newer)
+		return -1;
+
+	/* the older one was replaced, resetting it must not unset the newer one */
+	older->reset();
+	stub_backend_emit_volume_changed(SOUND_TYPE_MEDIA);
+	if(first_events != 0 || second_events != 1)
+		ret = -1;
+
+	{
+		/* nor destroying a moved one */
+		sound::subscription moved = std::move(*older);
+		auto replaced = sound::on_volume_changed(first);
+		sound::subscription kept = std::move(*replaced);
+		newer->reset();
+		stub_backend_emit_volume_changed(SOUND_TYPE_MEDIA);
+		if(first_events != 1 || second_events != 1 || !kept || moved)
+			ret = -1;
+	}
+
+	/* the current one leaving unsets the callback */
+	stub_backend_emit_volume_changed(SOUND_TYPE_MEDIA);
+	if(first_events != 1 || second_events != 1)
+		ret = -1;
+
+	printf("%-36s %s\n", "replaced subscription kept the newer", ret ? "no" : "yes");
+	return ret;
+}
+
+int main(int argc, char *argv[])
+{
+	int ret = 0;
+
+	if(bench_parse_args(argc, argv, "", NULL) != 0)
+		return 1;
+
+	if(__test_replaced_subscription() != 0)
+		ret = 1;
+
+	return bench_end(ret);
+}
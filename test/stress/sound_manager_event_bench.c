@@ -0,0 +1,173 @@
+/*
+* Copyright (c) 2011 Samsung Electronics Co., Ltd All Rights Reserved
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+
+
+/*
+ * Event delivery latency benchmark
+ *
+ * Several backend threads fire volume, device and route events at once. Each
+ * callback reads the timing of its event, checks that the sequence grows on
+ * every thread, that every event got its own number and that the times are
+ * ordered. The volume callback waits for the new level from the sound server,
+ * so its latency follows the round trip while the device events only pay for
+ * the library itself; the latency histogram is reported for both.
+ *
+ * usage : sound_manager_event_bench [events] [round_trip_us]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include <sound_manager.h>
+#include "sound_manager_stub_backend.h"
+#include "sound_manager_bench.h"
+
+#define DEFAULT_EVENTS 2000
+#define DEFAULT_ROUND_TRIP_US 100
+#define EMITTER_NUM 4
+
+typedef struct {
+	unsigned long events;
+	unsigned long errors;
+	unsigned int min_sequence;
+	unsigned int max_sequence;
+}_consumer_s;
+
+static _consumer_s g_consumer = {0, 0, 0xffffffff, 0};
+static pthread_mutex_t g_consumer_lock = PTHREAD_MUTEX_INITIALIZER;
+static __thread unsigned int g_last_sequence;
+static int g_events = DEFAULT_EVENTS;
+
+static void __check_event(sound_event_type_e type)
+{
+	sound_event_info_s info;
+	int error = 0;
+
+	if(sound_manager_get_event_info(&info) != SOUND_MANAGER_ERROR_NONE
+		|| info.type != type
+		|| info.sequence <= g_last_sequence
+		|| info.delivery_time_us < info.receive_time_us)
+		error = 1;
+	g_last_sequence = info.sequence;
+
+	pthread_mutex_lock(&g_consumer_lock);
+	g_consumer.events++;
+	g_consumer.errors += error;
+	if(info.sequence < g_consumer.min_sequence)
+		g_consumer.min_sequence = info.sequence;
+	if(info.sequence > g_consumer.max_sequence)
+		g_consumer.max_sequence = info.sequence;
+	pthread_mutex_unlock(&g_consumer_lock);
+}
+
+static void __volume_changed_cb(sound_type_e type, unsigned int volume, void *user_data)
+{
+	__check_event(SOUND_EVENT_VOLUME_CHANGED);
+}
+
+static void __active_device_changed_cb(sound_device_in_e in, sound_device_out_e out, void *user_data)
+{
+	__check_event(SOUND_EVENT_ACTIVE_DEVICE_CHANGED);
+}
+
+static void __available_route_changed_cb(sound_route_e route, bool available, void *user_data)
+{
+	__check_event(SOUND_EVENT_AVAILABLE_ROUTE_CHANGED);
+}
+
+static void *__emit_volume(void *data)
+{
+	int i;
+
+	for(i = 0 ; i < g_events ; i++)
+		stub_backend_emit_volume_changed(SOUND_TYPE_MEDIA);
+	return NULL;
+}
+
+static void *__emit_device(void *data)
+{
+	int i;
+
+	for(i = 0 ; i < g_events ; i++)
+	{
+		if(i & 1)
+			stub_backend_emit_active_device_changed(SOUND_DEVICE_IN_MIC, SOUND_DEVICE_OUT_SPEAKER);
+		else
+			stub_backend_emit_available_route_changed(SOUND_ROUTE_OUT_WIRED_ACCESSORY, i & 2);
+	}
+	return NULL;
+}
+
+static int __report(const char *name, void *(*emit)(void *))
+{
+	pthread_t thread[EMITTER_NUM];
+	sound_event_latency_s latency;
+	_consumer_s before = g_consumer;
+	unsigned long events;
+	int i;
+
+	sound_manager_reset_event_latency();
+	for(i = 0 ; i < EMITTER_NUM ; i++)
+		pthread_create(&thread[i], NULL, emit, NULL);
+	for(i = 0 ; i < EMITTER_NUM ; i++)
+		pthread_join(thread[i], NULL);
+
+	events = g_consumer.events - before.events;
+	if(sound_manager_get_event_latency(&latency) != SOUND_MANAGER_ERROR_NONE)
+		return -1;
+	printf("%-20s %8lu %8u %8u %8u %8u\n", name, events, latency.p50_us, latency.p99_us, latency.p999_us, latency.max_us);
+	if(events != (unsigned long)g_events * EMITTER_NUM || latency.count != events || g_consumer.errors != before.errors)
+		return -1;
+	return 0;
+}
+
+int main(int argc, char *argv[])
+{
+	sound_event_info_s info;
+	int round_trip_us = DEFAULT_ROUND_TRIP_US;
+	int ret = 0;
+
+	if(bench_parse_args(argc, argv, "[events] [round_trip_us]", &g_events, 1, &round_trip_us, 0, NULL) != 0)
+		return 1;
+
+	if(sound_manager_set_volume_changed_cb(__volume_changed_cb, NULL) != SOUND_MANAGER_ERROR_NONE
+		|| sound_manager_set_active_device_changed_cb(__active_device_changed_cb, NULL) != SOUND_MANAGER_ERROR_NONE
+		|| sound_manager_set_available_route_changed_cb(__available_route_changed_cb, NULL) != SOUND_MANAGER_ERROR_NONE)
+		return 1;
+	/* there is no event outside the callbacks */
+	if(sound_manager_get_event_info(&info) != SOUND_MANAGER_ERROR_INVALID_OPERATION)
+		ret = 1;
+	bench_begin(round_trip_us);
+
+	printf("%d threads, %d events each, %dus round trip\n", EMITTER_NUM, g_events, round_trip_us);
+	printf("%-20s %8s %8s %8s %8s %8s\n", "", "events", "p50 us", "p99 us", "p999 us", "max us");
+	if(__report("volume", __emit_volume) != 0)
+		ret = 1;
+	if(__report("device and route", __emit_device) != 0)
+		ret = 1;
+
+	/* every event got its own number */
+	if(g_consumer.max_sequence - g_consumer.min_sequence + 1 != g_consumer.events)
+		ret = 1;
+	printf("%lu events, sequence %u..%u, %lu errors\n", g_consumer.events, g_consumer.min_sequence, g_consumer.max_sequence, g_consumer.errors);
+
+	sound_manager_unset_volume_changed_cb();
+	sound_manager_unset_active_device_changed_cb();
+	sound_manager_unset_available_route_changed_cb();
+
+	return bench_end(ret);
+}
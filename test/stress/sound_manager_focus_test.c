@@ -0,0 +1,242 @@
+/*
+* Copyright (c) 2011 Samsung Electronics Co., Ltd All Rights Reserved
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+
+
+/*
+ * Sound focus test
+ *
+ * Runs the focus policy over the stub backend: a lower class ducked under a
+ * transient focus can not turn it into a permanent one, a permanent request
+ * takes the focus from every holder of the stack, and an exclusive holder
+ * gives the application its own session type back once it is gone. A holder
+ * told it lost the focus may ask for it again from the callback.
+ *
+ * usage : sound_manager_focus_test
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <sound_manager.h>
+#include "sound_manager_stub_backend.h"
+#include "sound_manager_bench.h"
+
+#define HOLDER_NUM 4
+
+typedef struct {
+	sound_focus_h focus;
+	int changes;
+	sound_focus_state_e last;
+	sound_focus_request_e on_lost;	/* requested again from the callback when set */
+}_holder_s;
+
+static _holder_s g_holder[HOLDER_NUM];
+
+static void __focus_state_changed_cb(sound_focus_h focus, sound_focus_state_e state, void *user_data)
+{
+	_holder_s *holder = user_data;
+
+	holder->changes++;
+	holder->last = state;
+	if(state == SOUND_FOCUS_STATE_LOST && holder->on_lost)
+		sound_manager_focus_request(focus, holder->on_lost);
+}
+
+static int __create(void)
+{
+	int i;
+
+	memset(g_holder, 0, sizeof(g_holder));
+	for(i = 0 ; i < HOLDER_NUM ; i++)
+	{
+		if(sound_manager_focus_create(SOUND_FOCUS_PRIORITY_NOTIFICATION + i, __focus_state_changed_cb, &g_holder[i], &g_holder[i].focus) != SOUND_MANAGER_ERROR_NONE)
+			return -1;
+	}
+	return 0;
+}
+
+static void __destroy(void)
+{
+	int i;
+
+	for(i = 0 ; i < HOLDER_NUM ; i++)
+		sound_manager_focus_destroy(g_holder[i].focus);
+}
+
+static sound_focus_state_e __state(sound_focus_priority_e priority)
+{
+	sound_focus_state_e state = SOUND_FOCUS_STATE_NONE;
+
+	sound_manager_focus_get_state(g_holder[priority].focus, &state);
+	return state;
+}
+
+static int __request(sound_focus_priority_e priority, sound_focus_request_e request)
+{
+	return sound_manager_focus_request(g_holder[priority].focus, request);
+}
+
+static int __test_transient_upgrade(void)
+{
+	int ret = 0;
+
+	if(__create() != 0)
+		return -1;
+
+	if(__request(SOUND_FOCUS_PRIORITY_MEDIA, SOUND_FOCUS_REQUEST_GAIN) != SOUND_MANAGER_ERROR_NONE
+		|| __request(SOUND_FOCUS_PRIORITY_NOTIFICATION, SOUND_FOCUS_REQUEST_GAIN_TRANSIENT_MAY_DUCK) != SOUND_MANAGER_ERROR_NONE
+		|| __state(SOUND_FOCUS_PRIORITY_MEDIA) != SOUND_FOCUS_STATE_DUCKED)
+		ret = -1;
+
+	/* holding the transient focus does not let a lower class keep it */
+	if(__request(SOUND_FOCUS_PRIORITY_NOTIFICATION, SOUND_FOCUS_REQUEST_GAIN) != SOUND_MANAGER_ERROR_POLICY
+		|| __request(SOUND_FOCUS_PRIORITY_NOTIFICATION, SOUND_FOCUS_REQUEST_GAIN_EXCLUSIVE) != SOUND_MANAGER_ERROR_POLICY
+		|| __state(SOUND_FOCUS_PRIORITY_MEDIA) != SOUND_FOCUS_STATE_DUCKED
+		|| __state(SOUND_FOCUS_PRIORITY_NOTIFICATION) != SOUND_FOCUS_STATE_GAINED)
+		ret = -1;
+
+	/* switching to a pausing focus pauses the ducked holder */
+	if(__request(SOUND_FOCUS_PRIORITY_NOTIFICATION, SOUND_FOCUS_REQUEST_GAIN_TRANSIENT) != SOUND_MANAGER_ERROR_NONE
+		|| __state(SOUND_FOCUS_PRIORITY_MEDIA) != SOUND_FOCUS_STATE_LOST_TRANSIENT)
+		ret = -1;
+
+	if(sound_manager_focus_abandon(g_holder[SOUND_FOCUS_PRIORITY_NOTIFICATION].focus) != SOUND_MANAGER_ERROR_NONE
+		|| __state(SOUND_FOCUS_PRIORITY_MEDIA) != SOUND_FOCUS_STATE_GAINED
+		|| g_holder[SOUND_FOCUS_PRIORITY_MEDIA].changes != 3)
+		ret = -1;
+
+	__destroy();
+	printf("%-36s %s\n", "transient holder kept its class", ret ? "no" : "yes");
+	return ret;
+}
+
+static int __test_permanent_takes_all(void)
+{
+	int ret = 0;
+	int i;
+
+	if(__create() != 0)
+		return -1;
+
+	/* a stack of three, each interrupting the one below */
+	if(__request(SOUND_FOCUS_PRIORITY_NOTIFICATION, SOUND_FOCUS_REQUEST_GAIN) != SOUND_MANAGER_ERROR_NONE
+		|| __request(SOUND_FOCUS_PRIORITY_MEDIA, SOUND_FOCUS_REQUEST_GAIN_TRANSIENT) != SOUND_MANAGER_ERROR_NONE
+		|| __request(SOUND_FOCUS_PRIORITY_VOICE, SOUND_FOCUS_REQUEST_GAIN_TRANSIENT_MAY_DUCK) != SOUND_MANAGER_ERROR_NONE
+		|| __state(SOUND_FOCUS_PRIORITY_NOTIFICATION) != SOUND_FOCUS_STATE_LOST_TRANSIENT
+		|| __state(SOUND_FOCUS_PRIORITY_MEDIA) != SOUND_FOCUS_STATE_DUCKED)
+		ret = -1;
+
+	/* a lower class than one of the holders can not take them all */
+	if(__request(SOUND_FOCUS_PRIORITY_MEDIA, SOUND_FOCUS_REQUEST_GAIN) != SOUND_MANAGER_ERROR_POLICY)
+		ret = -1;
+
+	for(i = 0 ; i < HOLDER_NUM ; i++)
+		g_holder[i].changes = 0;
+	if(__request(SOUND_FOCUS_PRIORITY_CALL, SOUND_FOCUS_REQUEST_GAIN) != SOUND_MANAGER_ERROR_NONE)
+		ret = -1;
+	for(i = SOUND_FOCUS_PRIORITY_NOTIFICATION ; i < SOUND_FOCUS_PRIORITY_CALL ; i++)
+	{
+		if(__state(i) != SOUND_FOCUS_STATE_LOST || g_holder[i].changes != 1 || g_holder[i].last != SOUND_FOCUS_STATE_LOST)
+			ret = -1;
+	}
+
+	/* nobody is left to get the focus back */
+	if(sound_manager_focus_abandon(g_holder[SOUND_FOCUS_PRIORITY_CALL].focus) != SOUND_MANAGER_ERROR_NONE)
+		ret = -1;
+	for(i = SOUND_FOCUS_PRIORITY_NOTIFICATION ; i < SOUND_FOCUS_PRIORITY_CALL ; i++)
+	{
+		if(__state(i) != SOUND_FOCUS_STATE_LOST || g_holder[i].changes != 1)
+			ret = -1;
+	}
+
+	__destroy();
+	printf("%-36s %s\n", "permanent focus took every holder", ret ? "no" : "yes");
+	return ret;
+}
+
+static int __test_exclusive_session(void)
+{
+	int ret = 0;
+
+	if(__create() != 0)
+		return -1;
+	if(sound_manager_set_session_type(SOUND_SESSION_TYPE_EXCLUSIVE) != SOUND_MANAGER_ERROR_NONE
+		|| sound_manager_set_session_type(SOUND_SESSION_TYPE_SHARE) != SOUND_MANAGER_ERROR_NONE)
+		ret = -1;
+
+	if(__request(SOUND_FOCUS_PRIORITY_VOICE, SOUND_FOCUS_REQUEST_GAIN_EXCLUSIVE) != SOUND_MANAGER_ERROR_NONE
+		|| stub_backend_get_session_type() != MM_SESSION_TYPE_EXCLUSIVE)
+		ret = -1;
+	/* not even briefly under an exclusive holder */
+	if(__request(SOUND_FOCUS_PRIORITY_MEDIA, SOUND_FOCUS_REQUEST_GAIN_TRANSIENT) != SOUND_MANAGER_ERROR_POLICY)
+		ret = -1;
+	if(sound_manager_focus_abandon(g_holder[SOUND_FOCUS_PRIORITY_VOICE].focus) != SOUND_MANAGER_ERROR_NONE
+		|| stub_backend_get_session_type() != MM_SESSION_TYPE_SHARE)
+		ret = -1;
+
+	/* the application's own exclusive session outlives the focus */
+	if(sound_manager_set_session_type(SOUND_SESSION_TYPE_EXCLUSIVE) != SOUND_MANAGER_ERROR_NONE
+		|| __request(SOUND_FOCUS_PRIORITY_VOICE, SOUND_FOCUS_REQUEST_GAIN_EXCLUSIVE) != SOUND_MANAGER_ERROR_NONE
+		|| sound_manager_focus_abandon(g_holder[SOUND_FOCUS_PRIORITY_VOICE].focus) != SOUND_MANAGER_ERROR_NONE
+		|| stub_backend_get_session_type() != MM_SESSION_TYPE_EXCLUSIVE)
+		ret = -1;
+	sound_manager_set_session_type(SOUND_SESSION_TYPE_SHARE);
+
+	__destroy();
+	printf("%-36s %s\n", "session type restored", ret ? "no" : "yes");
+	return ret;
+}
+
+static int __test_request_from_callback(void)
+{
+	int ret = 0;
+
+	if(__create() != 0)
+		return -1;
+
+	/* the media player ducks the call it lost to instead of stopping */
+	g_holder[SOUND_FOCUS_PRIORITY_MEDIA].on_lost = SOUND_FOCUS_REQUEST_GAIN_TRANSIENT_MAY_DUCK;
+	if(__request(SOUND_FOCUS_PRIORITY_MEDIA, SOUND_FOCUS_REQUEST_GAIN) != SOUND_MANAGER_ERROR_NONE
+		|| __request(SOUND_FOCUS_PRIORITY_CALL, SOUND_FOCUS_REQUEST_GAIN) != SOUND_MANAGER_ERROR_NONE)
+		ret = -1;
+	if(__state(SOUND_FOCUS_PRIORITY_MEDIA) != SOUND_FOCUS_STATE_GAINED || g_holder[SOUND_FOCUS_PRIORITY_MEDIA].changes != 1
+		|| __state(SOUND_FOCUS_PRIORITY_CALL) != SOUND_FOCUS_STATE_DUCKED || g_holder[SOUND_FOCUS_PRIORITY_CALL].changes != 1
+		|| g_holder[SOUND_FOCUS_PRIORITY_CALL].last != SOUND_FOCUS_STATE_DUCKED)
+		ret = -1;
+
+	__destroy();
+	printf("%-36s %s\n", "focus requested from the callback", ret ? "no" : "yes");
+	return ret;
+}
+
+int main(int argc, char *argv[])
+{
+	int ret = 0;
+
+	if(bench_parse_args(argc, argv, "", NULL) != 0)
+		return 1;
+
+	if(__test_transient_upgrade() != 0)
+		ret = 1;
+	if(__test_permanent_takes_all() != 0)
+		ret = 1;
+	if(__test_exclusive_session() != 0)
+		ret = 1;
+	if(__test_request_from_callback() != 0)
+		ret = 1;
+
+	return bench_end(ret);
+}
@@ -0,0 +1,133 @@
+/*
+* Copyright (c) 2011 Samsung Electronics Co., Ltd All Rights Reserved
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+
+
+/*
+ * Volume key type test
+ *
+ * Threads change the volume key type at the same time. Checks that the
+ * change callback never runs twice at once, that the last type it sees is
+ * the one the library ends up with, and that restoring a snapshot brings
+ * the type back without invoking it.
+ *
+ * usage : sound_manager_key_type_test [threads] [changes]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include <sound_manager.h>
+#include "sound_manager_stub_backend.h"
+#include "sound_manager_bench.h"
+
+#define DEFAULT_THREADS 4
+#define DEFAULT_CHANGES 2000
+#define MAX_THREADS 64
+
+static int g_changes;
+static int g_inside;
+static int g_overlaps;
+static int g_calls;
+static volume_key_type_e g_last = VOLUME_KEY_TYPE_NONE;
+
+static void __volume_key_type_changed_cb(volume_key_type_e type, void *user_data)
+{
+	if(__sync_add_and_fetch(&g_inside, 1) != 1)
+		__sync_fetch_and_add(&g_overlaps, 1);
+	g_last = type;
+	g_calls++;
+	__sync_fetch_and_sub(&g_inside, 1);
+}
+
+static void *__setter(void *data)
+{
+	unsigned int seed = (unsigned int)(unsigned long)data;
+	int i;
+
+	for(i = 0 ; i < g_changes ; i++)
+		sound_manager_set_volume_key_type((volume_key_type_e)(rand_r(&seed) % (VOLUME_KEY_TYPE_CALL + 1)));
+	return NULL;
+}
+
+static int __test_concurrent_setters(int threads)
+{
+	pthread_t thread[MAX_THREADS];
+	volume_key_type_e type = VOLUME_KEY_TYPE_NONE;
+	int ret = 0;
+	int i;
+
+	if(sound_manager_set_volume_key_type_changed_cb(__volume_key_type_changed_cb, NULL) != SOUND_MANAGER_ERROR_NONE)
+		return -1;
+	for(i = 0 ; i < threads ; i++)
+		pthread_create(&thread[i], NULL, __setter, (void *)(unsigned long)(i + 1));
+	for(i = 0 ; i < threads ; i++)
+		pthread_join(thread[i], NULL);
+
+	if(sound_manager_get_volume_key_type(&type) != SOUND_MANAGER_ERROR_NONE
+		|| g_overlaps != 0 || g_calls == 0 || g_last != type)
+		ret = -1;
+
+	printf("%-36s %s\n", "callbacks ordered, last type seen", ret ? "no" : "yes");
+	return ret;
+}
+
+static int __test_restore_silent(void)
+{
+	sound_manager_snapshot_h snapshot = NULL;
+	volume_key_type_e type = VOLUME_KEY_TYPE_NONE;
+	int calls;
+	int ret = 0;
+
+	if(sound_manager_set_volume_key_type(VOLUME_KEY_TYPE_MEDIA) != SOUND_MANAGER_ERROR_NONE
+		|| sound_manager_snapshot_create(&snapshot) != SOUND_MANAGER_ERROR_NONE)
+		return -1;
+
+	calls = g_calls;
+	if(sound_manager_set_volume_key_type(VOLUME_KEY_TYPE_RINGTONE) != SOUND_MANAGER_ERROR_NONE
+		|| g_calls != calls + 1 || g_last != VOLUME_KEY_TYPE_RINGTONE)
+		ret = -1;
+	if(sound_manager_snapshot_restore(snapshot) != SOUND_MANAGER_ERROR_NONE
+		|| sound_manager_get_volume_key_type(&type) != SOUND_MANAGER_ERROR_NONE
+		|| type != VOLUME_KEY_TYPE_MEDIA || g_calls != calls + 1)
+		ret = -1;
+
+	sound_manager_snapshot_destroy(snapshot);
+	sound_manager_unset_volume_key_type_changed_cb();
+	printf("%-36s %s\n", "restore did not notify", ret ? "no" : "yes");
+	return ret;
+}
+
+int main(int argc, char *argv[])
+{
+	int threads = DEFAULT_THREADS;
+	int ret = 0;
+
+	g_changes = DEFAULT_CHANGES;
+	if(bench_parse_args(argc, argv, "[threads] [changes]", &threads, 1, &g_changes, 1, NULL) != 0)
+		return 1;
+	if(threads > MAX_THREADS){
+		fprintf(stderr, "usage : %s [threads] [changes], at most %d threads\n", argv[0], MAX_THREADS);
+		return 1;
+	}
+
+	if(__test_concurrent_setters(threads) != 0)
+		ret = 1;
+	if(__test_restore_silent() != 0)
+		ret = 1;
+
+	return bench_end(ret);
+}
@@ -0,0 +1,195 @@
+/*
+* Copyright (c) 2011 Samsung Electronics Co., Ltd All Rights Reserved
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+
+
+/*
+ * Mute benchmark
+ *
+ * A media player mutes and unmutes its sound type, either by saving the level,
+ * writing 0 and writing the level back, or with the library mute. The stub
+ * backend charges a fixed round trip per request and reports every level
+ * write as a change notification. The cost of a mute/unmute pair, the sound
+ * server requests and the events the application sees are reported, and the
+ * stream gain and the level must come back to where they were. Muting many
+ * streams must tell each of them once.
+ *
+ * usage : sound_manager_mute_bench [iterations] [round_trip_us]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <sound_manager.h>
+#include "sound_manager_stub_backend.h"
+#include "sound_manager_bench.h"
+
+#define DEFAULT_ITERATIONS 100
+#define DEFAULT_ROUND_TRIP_US 200
+#define LEVEL 9
+#define MANY_STREAMS 40
+
+static unsigned long g_volume_events;
+static unsigned long g_mute_events;
+static sound_stream_volume_h g_stream;
+
+static void __volume_changed_cb(sound_type_e type, unsigned int volume, void *user_data)
+{
+	__sync_fetch_and_add(&g_volume_events, 1);
+}
+
+static void __mute_changed_cb(sound_type_e type, bool muted, void *user_data)
+{
+	__sync_fetch_and_add(&g_mute_events, 1);
+}
+
+static void __stream_volume_changed_cb(sound_stream_volume_h stream, double gain, void *user_data)
+{
+	(*(int *)user_data)++;
+}
+
+/* more streams than a refresh collects at once, each told exactly once */
+static int __mute_many_streams(void)
+{
+	sound_stream_volume_h stream[MANY_STREAMS];
+	int changes[MANY_STREAMS] = {0, };
+	int created;
+	int ret = 0;
+	int i;
+
+	for(created = 0 ; created < MANY_STREAMS ; created++){
+		if(sound_manager_stream_volume_create(SOUND_TYPE_MEDIA, &stream[created]) != SOUND_MANAGER_ERROR_NONE
+			|| sound_manager_stream_volume_set_changed_cb(stream[created], __stream_volume_changed_cb, &changes[created]) != SOUND_MANAGER_ERROR_NONE){
+			ret = -1;
+			break;
+		}
+	}
+	if(ret == 0){
+		sound_manager_set_mute(SOUND_TYPE_MEDIA, true);
+		sound_manager_set_mute(SOUND_TYPE_MEDIA, false);
+		for(i = 0 ; i < MANY_STREAMS ; i++)
+			if(changes[i] != 2)
+				ret = -1;
+	}
+	for(i = 0 ; i < created ; i++)
+		sound_manager_stream_volume_destroy(stream[i]);
+	return ret;
+}
+
+/* the stub backend does not notify by itself, a real sound server would */
+static int __set_volume(int volume)
+{
+	int ret = sound_manager_set_volume(SOUND_TYPE_MEDIA, volume);
+
+	stub_backend_emit_volume_changed(SOUND_TYPE_MEDIA);
+	return ret;
+}
+
+static int __mute_by_level(void)
+{
+	double gain;
+	int saved;
+
+	if(sound_manager_get_volume(SOUND_TYPE_MEDIA, &saved) != SOUND_MANAGER_ERROR_NONE
+		|| __set_volume(0) != SOUND_MANAGER_ERROR_NONE)
+		return -1;
+	if(sound_manager_stream_volume_get_effective_gain(g_stream, &gain) != SOUND_MANAGER_ERROR_NONE || gain != 0.0)
+		return -1;
+	return __set_volume(saved);
+}
+
+static int __mute_local(void)
+{
+	double gain;
+
+	if(sound_manager_set_mute(SOUND_TYPE_MEDIA, true) != SOUND_MANAGER_ERROR_NONE)
+		return -1;
+	if(sound_manager_stream_volume_get_effective_gain(g_stream, &gain) != SOUND_MANAGER_ERROR_NONE || gain != 0.0)
+		return -1;
+	return sound_manager_set_mute(SOUND_TYPE_MEDIA, false);
+}
+
+static int __report(const char *name, int (*mute)(void), int iterations)
+{
+	unsigned long volume_events = g_volume_events;
+	unsigned long mute_events = g_mute_events;
+	unsigned long calls;
+	bench_span_s span;
+	double elapsed;
+	double gain;
+	int volume;
+	int i;
+
+	bench_span_begin(&span);
+	for(i = 0 ; i < iterations ; i++)
+	{
+		if(mute() != SOUND_MANAGER_ERROR_NONE){
+			printf("%-20s FAIL\n", name);
+			return -1;
+		}
+	}
+	elapsed = bench_span_end(&span, &calls);
+
+	printf("%-20s %12.1f %12.1f %12.1f %12.1f\n", name, elapsed / iterations, (double)calls / iterations,
+		(double)(g_volume_events - volume_events) / iterations, (double)(g_mute_events - mute_events) / iterations);
+
+	/* back to the level and gain from before */
+	if(sound_manager_get_volume(SOUND_TYPE_MEDIA, &volume) != SOUND_MANAGER_ERROR_NONE || volume != LEVEL
+		|| sound_manager_stream_volume_get_effective_gain(g_stream, &gain) != SOUND_MANAGER_ERROR_NONE || gain == 0.0)
+		return -1;
+	return 0;
+}
+
+int main(int argc, char *argv[])
+{
+	int iterations = DEFAULT_ITERATIONS;
+	int round_trip_us = DEFAULT_ROUND_TRIP_US;
+	bool muted = true;
+	int ret = 0;
+
+	if(bench_parse_args(argc, argv, "[iterations] [round_trip_us]", &iterations, 1, &round_trip_us, 0, NULL) != 0)
+		return 1;
+
+	if(sound_manager_set_volume(SOUND_TYPE_MEDIA, LEVEL) != SOUND_MANAGER_ERROR_NONE
+		|| sound_manager_stream_volume_create(SOUND_TYPE_MEDIA, &g_stream) != SOUND_MANAGER_ERROR_NONE
+		|| sound_manager_set_volume_changed_cb(__volume_changed_cb, NULL) != SOUND_MANAGER_ERROR_NONE
+		|| sound_manager_set_mute_changed_cb(__mute_changed_cb, NULL) != SOUND_MANAGER_ERROR_NONE)
+		return 1;
+	bench_begin(round_trip_us);
+
+	printf("%d mute/unmute pairs, %dus round trip\n", iterations, round_trip_us);
+	printf("%-20s %12s %12s %12s %12s\n", "", "us/pair", "requests", "vol events", "mute events");
+	if(__report("save and restore", __mute_by_level, iterations) != 0)
+		ret = 1;
+	if(__report("mute", __mute_local, iterations) != 0)
+		ret = 1;
+
+	/* muting twice is a single change */
+	g_mute_events = 0;
+	if(sound_manager_set_mute(SOUND_TYPE_MEDIA, true) != SOUND_MANAGER_ERROR_NONE
+		|| sound_manager_set_mute(SOUND_TYPE_MEDIA, true) != SOUND_MANAGER_ERROR_NONE
+		|| sound_manager_get_mute(SOUND_TYPE_MEDIA, &muted) != SOUND_MANAGER_ERROR_NONE
+		|| !muted || g_mute_events != 1)
+		ret = 1;
+	sound_manager_set_mute(SOUND_TYPE_MEDIA, false);
+	if(__mute_many_streams() != 0)
+		ret = 1;
+
+	sound_manager_unset_mute_changed_cb();
+	sound_manager_unset_volume_changed_cb();
+	sound_manager_stream_volume_destroy(g_stream);
+
+	return bench_end(ret);
+}
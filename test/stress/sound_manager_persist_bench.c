@@ -0,0 +1,124 @@
+/*
+* Copyright (c) 2011 Samsung Electronics Co., Ltd All Rights Reserved
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+
+
+/*
+ * Volume persistence benchmark
+ *
+ * A held volume key repeats, and the application remembers the level either
+ * by writing and syncing its own file from the volume changed callback or
+ * with the library persistence. The cost per key event and the number of
+ * file writes are reported. Reading the file back is covered by
+ * sound_manager_persist_test.
+ *
+ * usage : sound_manager_persist_bench [key_events] [min_interval_ms]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sound_manager.h>
+#include "sound_manager_stub_backend.h"
+#include "sound_manager_bench.h"
+
+#define DEFAULT_KEY_EVENTS 200
+#define DEFAULT_MIN_INTERVAL_MS 20
+#define KEY_REPEAT_US 2000
+#define MAX_LEVEL 15
+
+static char g_path[256];
+static char g_app_path[sizeof(g_path) + 4];
+static unsigned long g_app_writes;
+
+/* what an application does without the library persistence */
+static void __app_volume_changed_cb(sound_type_e type, unsigned int volume, void *user_data)
+{
+	int fd = open(g_app_path, O_WRONLY | O_CREAT | O_TRUNC, 0600);
+
+	if(fd < 0)
+		return;
+	if(write(fd, &volume, sizeof(volume)) == sizeof(volume) && fsync(fd) == 0)
+		g_app_writes++;
+	close(fd);
+}
+
+static int __level(int i)
+{
+	/* up to the top and back down, like a key held in both directions */
+	i %= 2 * MAX_LEVEL;
+	return i < MAX_LEVEL ? i + 1 : 2 * MAX_LEVEL - i - 1;
+}
+
+static int __press_keys(int key_events, double *event_us)
+{
+	double elapsed = 0;
+	double start;
+	int i;
+
+	for(i = 0 ; i < key_events ; i++)
+	{
+		start = bench_now_us();
+		if(sound_manager_set_volume(SOUND_TYPE_MEDIA, __level(i)) != SOUND_MANAGER_ERROR_NONE)
+			return -1;
+		/* the stub backend notifies from the caller thread */
+		stub_backend_emit_volume_changed(SOUND_TYPE_MEDIA);
+		elapsed += bench_now_us() - start;
+		usleep(KEY_REPEAT_US);
+	}
+	*event_us = elapsed / key_events;
+	return 0;
+}
+
+int main(int argc, char *argv[])
+{
+	sound_persistence_stats_s stats;
+	int key_events = DEFAULT_KEY_EVENTS;
+	int min_interval_ms = DEFAULT_MIN_INTERVAL_MS;
+	double event_us;
+	int ret = 0;
+
+	if(bench_parse_args(argc, argv, "[key_events] [min_interval_ms]", &key_events, 1, &min_interval_ms, 0, NULL) != 0)
+		return 1;
+
+	snprintf(g_path, sizeof(g_path), "%s/sound_manager_persist_bench.%d", getenv("TMPDIR") ? getenv("TMPDIR") : "/tmp", getpid());
+	snprintf(g_app_path, sizeof(g_app_path), "%s.app", g_path);
+	unlink(g_path);
+
+	printf("%d key events every %dus, %dms between writes\n", key_events, KEY_REPEAT_US, min_interval_ms);
+	printf("%-28s %12s %12s\n", "", "us/event", "writes");
+
+	if(sound_manager_set_volume_changed_cb(__app_volume_changed_cb, NULL) != SOUND_MANAGER_ERROR_NONE
+		|| __press_keys(key_events, &event_us) != 0)
+		return 1;
+	sound_manager_unset_volume_changed_cb();
+	printf("%-28s %12.1f %12lu\n", "write from the callback", event_us, g_app_writes);
+
+	if(sound_manager_set_persistence(g_path, min_interval_ms) != SOUND_MANAGER_ERROR_NONE
+		|| __press_keys(key_events, &event_us) != 0)
+		return 1;
+	sound_manager_unset_persistence();
+	sound_manager_get_persistence_stats(&stats);
+	printf("%-28s %12.1f %12u\n", "library persistence", event_us, stats.written);
+	if(stats.failed || stats.written == 0 || stats.written >= stats.recorded)
+		ret = 1;
+
+	unlink(g_path);
+	unlink(g_app_path);
+
+	return bench_end(ret);
+}
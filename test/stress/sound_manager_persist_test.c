@@ -0,0 +1,189 @@
+/*
+* Copyright (c) 2011 Samsung Electronics Co., Ltd All Rights Reserved
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+
+
+/*
+ * Persistence test
+ *
+ * Records a volume, the volume key type and a route, then reads the file
+ * back the way the next run of the application would, without a request to
+ * the sound server. A damaged file must start empty, writes which fail are
+ * counted as failed only, and a failed write is tried again until the
+ * preference reaches the file.
+ *
+ * usage : sound_manager_persist_test
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sound_manager.h>
+#include "sound_manager_stub_backend.h"
+#include "sound_manager_bench.h"
+
+#define RECORDED_LEVEL 9
+#define WAIT_FAILED_US 1000000
+
+static char g_path[256];
+
+static int __test_reload(void)
+{
+	sound_persistence_stats_s stats;
+	sound_persisted_state_s state;
+	unsigned long calls;
+	int ret = 0;
+
+	if(sound_manager_set_persistence(g_path, 0) != SOUND_MANAGER_ERROR_NONE
+		|| sound_manager_set_volume(SOUND_TYPE_MEDIA, RECORDED_LEVEL) != SOUND_MANAGER_ERROR_NONE
+		|| sound_manager_set_volume_key_type(VOLUME_KEY_TYPE_MEDIA) != SOUND_MANAGER_ERROR_NONE
+		|| sound_manager_set_active_route(SOUND_ROUTE_OUT_WIRED_ACCESSORY) != SOUND_MANAGER_ERROR_NONE)
+		return -1;
+	sound_manager_unset_persistence();
+	if(sound_manager_get_persistence_stats(&stats) != SOUND_MANAGER_ERROR_NONE
+		|| stats.written == 0 || stats.failed != 0)
+		ret = -1;
+
+	calls = stub_backend_get_call_count();
+	if(sound_manager_set_persistence(g_path, 0) != SOUND_MANAGER_ERROR_NONE
+		|| sound_manager_get_persisted_state(&state) != SOUND_MANAGER_ERROR_NONE)
+		return -1;
+	calls = stub_backend_get_call_count() - calls;
+	sound_manager_unset_persistence();
+
+	if(!(state.volume_mask & (1 << SOUND_TYPE_MEDIA)) || state.volume[SOUND_TYPE_MEDIA] != RECORDED_LEVEL
+		|| !state.key_type_known || state.key_type != VOLUME_KEY_TYPE_MEDIA
+		|| !state.route_known || state.route != SOUND_ROUTE_OUT_WIRED_ACCESSORY || calls != 0)
+		ret = -1;
+
+	printf("%-36s %s\n", "reloaded without the sound server", ret ? "no" : "yes");
+	return ret;
+}
+
+static int __test_damaged(void)
+{
+	sound_persisted_state_s state;
+	int ret = 0;
+	int fd;
+
+	fd = open(g_path, O_WRONLY);
+	if(fd < 0)
+		return -1;
+	lseek(fd, 12, SEEK_SET);
+	if(write(fd, "\xff\xff", 2) != 2){
+		close(fd);
+		return -1;
+	}
+	close(fd);
+
+	if(sound_manager_set_persistence(g_path, 0) != SOUND_MANAGER_ERROR_NONE
+		|| sound_manager_get_persisted_state(&state) != SOUND_MANAGER_ERROR_NONE)
+		return -1;
+	sound_manager_unset_persistence();
+
+	if(state.volume_mask || state.key_type_known || state.route_known)
+		ret = -1;
+
+	printf("%-36s %s\n", "damaged file starts empty", ret ? "no" : "yes");
+	return ret;
+}
+
+static int __test_failed_write(void)
+{
+	char path[sizeof(g_path) + 16];
+	sound_persistence_stats_s stats;
+	int ret = 0;
+
+	/* the directory does not exist, so no write can succeed */
+	snprintf(path, sizeof(path), "%s.missing/file", g_path);
+	if(sound_manager_set_persistence(path, 0) != SOUND_MANAGER_ERROR_NONE
+		|| sound_manager_set_volume(SOUND_TYPE_MEDIA, RECORDED_LEVEL - 1) != SOUND_MANAGER_ERROR_NONE)
+		return -1;
+	sound_manager_unset_persistence();
+
+	if(sound_manager_get_persistence_stats(&stats) != SOUND_MANAGER_ERROR_NONE
+		|| stats.written != 0 || stats.failed == 0)
+		ret = -1;
+
+	printf("%-36s %s\n", "failed writes not counted as written", ret ? "no" : "yes");
+	return ret;
+}
+
+static int __test_retried_write(void)
+{
+	char dir[sizeof(g_path) + 16];
+	char path[sizeof(dir) + 8];
+	sound_persistence_stats_s stats;
+	sound_persisted_state_s state;
+	double start_us = bench_now_us();
+	int ret = 0;
+
+	snprintf(dir, sizeof(dir), "%s.retry", g_path);
+	snprintf(path, sizeof(path), "%s/file", dir);
+	if(sound_manager_set_persistence(path, 0) != SOUND_MANAGER_ERROR_NONE
+		|| sound_manager_set_volume(SOUND_TYPE_MEDIA, RECORDED_LEVEL - 2) != SOUND_MANAGER_ERROR_NONE)
+		return -1;
+	do{
+		usleep(1000);
+		sound_manager_get_persistence_stats(&stats);
+	}while(stats.failed == 0 && bench_now_us() - start_us < WAIT_FAILED_US);
+
+	/* the directory shows up, the level nobody changed since must still be written */
+	mkdir(dir, 0700);
+	sound_manager_unset_persistence();
+	if(sound_manager_get_persistence_stats(&stats) != SOUND_MANAGER_ERROR_NONE
+		|| stats.failed == 0 || stats.written != 1)
+		ret = -1;
+
+	if(sound_manager_set_persistence(path, 0) != SOUND_MANAGER_ERROR_NONE
+		|| sound_manager_get_persisted_state(&state) != SOUND_MANAGER_ERROR_NONE)
+		ret = -1;
+	else if(state.volume[SOUND_TYPE_MEDIA] != RECORDED_LEVEL - 2)
+		ret = -1;
+	sound_manager_unset_persistence();
+
+	unlink(path);
+	rmdir(dir);
+	printf("%-36s %s\n", "failed write retried", ret ? "no" : "yes");
+	return ret;
+}
+
+int main(int argc, char *argv[])
+{
+	int ret = 0;
+
+	if(bench_parse_args(argc, argv, "", NULL) != 0)
+		return 1;
+
+	snprintf(g_path, sizeof(g_path), "%s/sound_manager_persist_test.%d", getenv("TMPDIR") ? getenv("TMPDIR") : "/tmp", getpid());
+	unlink(g_path);
+
+	if(__test_reload() != 0)
+		ret = 1;
+	if(__test_damaged() != 0)
+		ret = 1;
+	if(__test_failed_write() != 0)
+		ret = 1;
+	if(__test_retried_write() != 0)
+		ret = 1;
+
+	sound_manager_set_volume_key_type(VOLUME_KEY_TYPE_NONE);
+	unlink(g_path);
+
+	return bench_end(ret);
+}
@@ -0,0 +1,143 @@
+/*
+* Copyright (c) 2011 Samsung Electronics Co., Ltd All Rights Reserved
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+
+
+/*
+ * Resume latency benchmark
+ *
+ * An application releases its callbacks and volume key type when suspended.
+ * On resume it either rebuilds its audio state call by call, reading the
+ * volumes and the active device back, or restores a snapshot taken before
+ * suspending. The stub backend charges a fixed round trip per request.
+ *
+ * usage : sound_manager_resume_bench [iterations] [round_trip_us]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <sound_manager.h>
+#include "sound_manager_stub_backend.h"
+#include "sound_manager_bench.h"
+
+#define DEFAULT_ITERATIONS 200
+#define DEFAULT_ROUND_TRIP_US 200
+
+static sound_manager_snapshot_h g_snapshot;
+
+static void __interrupted_cb(sound_interrupted_code_e code, void *user_data)
+{
+}
+
+static void __volume_changed_cb(sound_type_e type, unsigned int volume, void *user_data)
+{
+}
+
+static void __active_device_changed_cb(sound_device_in_e in, sound_device_out_e out, void *user_data)
+{
+}
+
+static void __suspend(void)
+{
+	sound_manager_unset_interrupted_cb();
+	sound_manager_unset_volume_changed_cb();
+	sound_manager_unset_active_device_changed_cb();
+	sound_manager_set_volume_key_type(VOLUME_KEY_TYPE_NONE);
+}
+
+static int __resume_rebuild(void)
+{
+	sound_device_in_e in;
+	sound_device_out_e out;
+	int volume;
+	int type;
+
+	if(sound_manager_set_session_type(SOUND_SESSION_TYPE_SHARE) != SOUND_MANAGER_ERROR_NONE
+		|| sound_manager_set_interrupted_cb(__interrupted_cb, NULL) != SOUND_MANAGER_ERROR_NONE
+		|| sound_manager_set_volume_changed_cb(__volume_changed_cb, NULL) != SOUND_MANAGER_ERROR_NONE
+		|| sound_manager_set_active_device_changed_cb(__active_device_changed_cb, NULL) != SOUND_MANAGER_ERROR_NONE
+		|| sound_manager_set_volume_key_type(VOLUME_KEY_TYPE_MEDIA) != SOUND_MANAGER_ERROR_NONE)
+		return -1;
+	for(type = SOUND_TYPE_SYSTEM ; type <= SOUND_TYPE_CALL ; type++)
+	{
+		if(sound_manager_get_volume(type, &volume) != SOUND_MANAGER_ERROR_NONE)
+			return -1;
+	}
+	return sound_manager_get_active_device(&in, &out);
+}
+
+static int __resume_restore(void)
+{
+	return sound_manager_snapshot_restore(g_snapshot);
+}
+
+static int __report(const char *name, int (*resume)(void), int suspend, int iterations)
+{
+	bench_span_s span;
+	unsigned long calls = 0;
+	unsigned long requests;
+	double elapsed = 0;
+	double best = 0;
+	double start;
+	int i;
+
+	for(i = 0 ; i < iterations ; i++)
+	{
+		if(suspend)
+			__suspend();
+		bench_span_begin(&span);
+		if(resume() != SOUND_MANAGER_ERROR_NONE){
+			printf("%-28s FAIL\n", name);
+			return -1;
+		}
+		start = bench_span_end(&span, &requests);
+		calls += requests;
+		elapsed += start;
+		if(i == 0 || start < best)
+			best = start;
+	}
+	printf("%-28s %10.1f %10.1f %14.1f\n", name, elapsed / iterations, best, (double)calls / iterations);
+	return 0;
+}
+
+int main(int argc, char *argv[])
+{
+	int iterations = DEFAULT_ITERATIONS;
+	int round_trip_us = DEFAULT_ROUND_TRIP_US;
+	int ret = 0;
+
+	if(bench_parse_args(argc, argv, "[iterations] [round_trip_us]", &iterations, 1, &round_trip_us, 0, NULL) != 0)
+		return 1;
+
+	if(__resume_rebuild() != SOUND_MANAGER_ERROR_NONE
+		|| sound_manager_snapshot_create(&g_snapshot) != SOUND_MANAGER_ERROR_NONE)
+		return 1;
+	bench_begin(round_trip_us);
+
+	printf("%d iterations, %dus round trip\n", iterations, round_trip_us);
+	printf("%-28s %10s %10s %14s\n", "", "us/resume", "best us", "requests");
+	if(__report("rebuild", __resume_rebuild, 1, iterations) != 0)
+		ret = 1;
+	if(__report("snapshot restore", __resume_restore, 1, iterations) != 0)
+		ret = 1;
+	if(__report("snapshot restore, no change", __resume_restore, 0, iterations) != 0)
+		ret = 1;
+
+	sound_manager_snapshot_destroy(g_snapshot);
+	__suspend();
+
+	return bench_end(ret);
+}
@@ -0,0 +1,140 @@
+/*
+* Copyright (c) 2011 Samsung Electronics Co., Ltd All Rights Reserved
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+
+
+/*
+ * Sound server outage benchmark
+ *
+ * Client threads read and write the media volume in a tight loop, retrying
+ * whatever fails, while the stub sound server goes down for a while and comes
+ * back. Counts the requests reaching the sound server during the outage and
+ * the time until a write succeeds again, without and with a retry policy.
+ *
+ * usage : sound_manager_retry_bench [outage_ms] [threads]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sound_manager.h>
+#include "sound_manager_stub_backend.h"
+#include "sound_manager_bench.h"
+
+#define DEFAULT_OUTAGE_MS 300
+#define DEFAULT_THREADS 8
+#define ROUND_TRIP_US 200
+
+typedef struct {
+	pthread_t thread;
+	int stop;
+	unsigned long calls;
+	unsigned long stale;
+}_client_s;
+
+static void *__client(void *data)
+{
+	_client_s *client = data;
+	int volume;
+
+	while(!__sync_fetch_and_add(&client->stop, 0))
+	{
+		if(sound_manager_get_volume(SOUND_TYPE_MEDIA, &volume) == SOUND_MANAGER_ERROR_STALE_VALUE)
+			client->stale++;
+		sound_manager_set_volume(SOUND_TYPE_MEDIA, client->calls % 8);
+		client->calls++;
+	}
+	return NULL;
+}
+
+static int __outage(const char *name, const sound_backend_retry_policy_s *policy, int outage_ms, int threads)
+{
+	sound_backend_retry_stats_s stats;
+	_client_s *client = calloc(threads, sizeof(_client_s));
+	unsigned long stale = 0;
+	unsigned long before;
+	unsigned long during;
+	double start;
+	int volume;
+	int i;
+
+	if(client == NULL)
+		return -1;
+
+	sound_manager_set_backend_retry_policy(policy);
+	sound_manager_reset_backend_retry_stats();
+	/* the getters have a last known value before the outage */
+	sound_manager_get_volume(SOUND_TYPE_MEDIA, &volume);
+
+	for(i = 0 ; i < threads ; i++)
+		pthread_create(&client[i].thread, NULL, __client, &client[i]);
+	usleep(20000);
+
+	stub_backend_set_down(true);
+	before = stub_backend_get_call_count();
+	usleep(outage_ms * 1000);
+	during = stub_backend_get_call_count() - before;
+	stub_backend_set_down(false);
+
+	start = bench_now_us();
+	while(sound_manager_set_volume(SOUND_TYPE_MEDIA, 1) != SOUND_MANAGER_ERROR_NONE)
+		usleep(1000);
+	start = bench_now_us() - start;
+
+	for(i = 0 ; i < threads ; i++)
+	{
+		__sync_lock_test_and_set(&client[i].stop, 1);
+		pthread_join(client[i].thread, NULL);
+		stale += client[i].stale;
+	}
+	free(client);
+
+	sound_manager_get_backend_retry_stats(&stats);
+	printf("%-20s %12lu %12.1f %10lu %12.1f %8u\n", name, during, (double)during / outage_ms, stale, start / 1000, stats.opened);
+
+	if(policy == NULL)
+		return during;
+	/* the breaker has to open, answer the getters and close once the server is back */
+	if(stats.opened == 0 || stats.cached == 0 || stale == 0 || stats.state != SOUND_BACKEND_CIRCUIT_CLOSED)
+		return -1;
+	return during;
+}
+
+int main(int argc, char *argv[])
+{
+	sound_backend_retry_policy_s policy = {3, 5, 40, 5, 100};
+	int outage_ms = DEFAULT_OUTAGE_MS;
+	int threads = DEFAULT_THREADS;
+	int without;
+	int with;
+	int ret;
+
+	if(bench_parse_args(argc, argv, "[outage_ms] [threads]", &outage_ms, 1, &threads, 1, NULL) != 0)
+		return 1;
+
+	bench_begin(ROUND_TRIP_US);
+
+	printf("%dms outage, %d threads, %dus round trip\n", outage_ms, threads, ROUND_TRIP_US);
+	printf("%-20s %12s %12s %10s %12s %8s\n", "", "requests", "requests/ms", "stale", "recovery ms", "opened");
+	without = __outage("no policy", NULL, outage_ms, threads);
+	with = __outage("retry + breaker", &policy, outage_ms, threads);
+	ret = (without < 0 || with < 0 || with >= without);
+
+	sound_manager_set_backend_retry_policy(NULL);
+
+	return bench_end(ret);
+}
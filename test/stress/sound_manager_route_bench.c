@@ -0,0 +1,133 @@
+/*
+* Copyright (c) 2011 Samsung Electronics Co., Ltd All Rights Reserved
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+
+
+/*
+ * Route enumeration benchmark
+ *
+ * Compares collecting the available routes with the callback walk against
+ * sound_manager_get_available_routes(), with and without the route cache,
+ * over a stub backend which charges a fixed round trip per request.
+ *
+ * usage : sound_manager_route_bench [iterations] [round_trip_us]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <sound_manager.h>
+#include "sound_manager_stub_backend.h"
+#include "sound_manager_bench.h"
+
+#define DEFAULT_ITERATIONS 2000
+#define DEFAULT_ROUND_TRIP_US 50
+#define MAX_ROUTES 16
+
+typedef struct {
+	sound_route_e route[MAX_ROUTES];
+	int count;
+}_route_list_s;
+
+static bool __collect_route_cb(sound_route_e route, void *user_data)
+{
+	_route_list_s *list = (_route_list_s *)user_data;
+
+	if(list->count < MAX_ROUTES)
+		list->route[list->count++] = route;
+	return true;
+}
+
+static void __route_changed_cb(sound_route_e route, bool available, void *user_data)
+{
+}
+
+static int __bench_foreach(int iterations, int *count)
+{
+	_route_list_s list;
+	int i;
+
+	for(i = 0 ; i < iterations ; i++)
+	{
+		list.count = 0;
+		if(sound_manager_foreach_available_route(__collect_route_cb, &list) != SOUND_MANAGER_ERROR_NONE)
+			return -1;
+	}
+	*count = list.count;
+	return 0;
+}
+
+static int __bench_get(int iterations, int *count)
+{
+	sound_route_e route[MAX_ROUTES];
+	int i;
+
+	for(i = 0 ; i < iterations ; i++)
+	{
+		if(sound_manager_get_available_routes(route, MAX_ROUTES, count) != SOUND_MANAGER_ERROR_NONE)
+			return -1;
+	}
+	return 0;
+}
+
+static int __report(const char *name, int (*bench)(int, int *), int iterations, int expected)
+{
+	bench_span_s span;
+	unsigned long calls;
+	double elapsed;
+	int count = -1;
+
+	bench_span_begin(&span);
+	if(bench(iterations, &count) != 0 || count != expected){
+		printf("%-28s FAIL (%d routes)\n", name, count);
+		return -1;
+	}
+	elapsed = bench_span_end(&span, &calls);
+	printf("%-28s %10.2f %14.3f\n", name, elapsed / iterations, (double)calls / iterations);
+	return 0;
+}
+
+int main(int argc, char *argv[])
+{
+	int iterations = DEFAULT_ITERATIONS;
+	int round_trip_us = DEFAULT_ROUND_TRIP_US;
+	int expected = 0;
+	int ret = 0;
+
+	if(bench_parse_args(argc, argv, "[iterations] [round_trip_us]", &iterations, 1, &round_trip_us, 0, NULL) != 0)
+		return 1;
+
+	if(sound_manager_get_available_routes(NULL, 0, &expected) != SOUND_MANAGER_ERROR_NONE)
+		return 1;
+	bench_begin(round_trip_us);
+
+	printf("%d routes, %d iterations, %dus round trip\n", expected, iterations, round_trip_us);
+	printf("%-28s %10s %14s\n", "", "us/call", "requests/call");
+	if(__report("foreach callback", __bench_foreach, iterations, expected) != 0)
+		ret = 1;
+	if(__report("get_available_routes", __bench_get, iterations, expected) != 0)
+		ret = 1;
+
+	/* the route change notification keeps the set current in the library */
+	if(sound_manager_set_available_route_changed_cb(__route_changed_cb, NULL) != SOUND_MANAGER_ERROR_NONE)
+		return 1;
+	if(__report("foreach callback, cached", __bench_foreach, iterations, expected) != 0)
+		ret = 1;
+	if(__report("get_available_routes, cached", __bench_get, iterations, expected) != 0)
+		ret = 1;
+	sound_manager_unset_available_route_changed_cb();
+
+	return bench_end(ret);
+}
@@ -0,0 +1,194 @@
+/*
+* Copyright (c) 2011 Samsung Electronics Co., Ltd All Rights Reserved
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+
+
+/*
+ * Route change test
+ *
+ * Emits device and route notifications from the stub backend and checks
+ * that the diff callbacks drop the repeated ones while the plain callbacks
+ * see them all, and that delivered changes carry the previous state and a
+ * sequence number growing by one. Resolves a plugged in headset with the
+ * route policy table.
+ *
+ * usage : sound_manager_route_test
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <sound_manager.h>
+#include "sound_manager_stub_backend.h"
+#include "sound_manager_bench.h"
+
+#define MAX_ROUTES 10
+#define HEADSET_DEVICES (SOUND_DEVICE_IN_MIC | SOUND_DEVICE_IN_WIRED_ACCESSORY \
+	| SOUND_DEVICE_OUT_SPEAKER | SOUND_DEVICE_OUT_RECEIVER | SOUND_DEVICE_OUT_WIRED_ACCESSORY)
+
+static int g_device_changed;
+static int g_device_diffs;
+static sound_active_device_change_s g_device_change;
+static int g_route_changed;
+static int g_route_diffs;
+static sound_available_route_change_s g_route_change;
+
+static void __active_device_changed_cb(sound_device_in_e in, sound_device_out_e out, void *user_data)
+{
+	g_device_changed++;
+}
+
+static void __active_device_diff_cb(const sound_active_device_change_s *change, void *user_data)
+{
+	g_device_diffs++;
+	g_device_change = *change;
+}
+
+static void __available_route_changed_cb(sound_route_e route, bool available, void *user_data)
+{
+	g_route_changed++;
+}
+
+static void __available_route_diff_cb(const sound_available_route_change_s *change, void *user_data)
+{
+	g_route_diffs++;
+	g_route_change = *change;
+}
+
+static int __test_device_diff(void)
+{
+	int ret = 0;
+
+	if(sound_manager_set_active_device_changed_cb(__active_device_changed_cb, NULL) != SOUND_MANAGER_ERROR_NONE
+		|| sound_manager_set_active_device_diff_cb(__active_device_diff_cb, NULL) != SOUND_MANAGER_ERROR_NONE)
+		return -1;
+
+	/* the stub starts on mic and speaker, which the diff callback already knows */
+	stub_backend_emit_active_device_changed(SOUND_DEVICE_IN_MIC, SOUND_DEVICE_OUT_SPEAKER);
+	if(g_device_changed != 1 || g_device_diffs != 0)
+		ret = -1;
+
+	/* a Bluetooth reconnect repeats the same pair */
+	stub_backend_emit_active_device_changed(SOUND_DEVICE_IN_BT_SCO, SOUND_DEVICE_OUT_BT_SCO);
+	stub_backend_emit_active_device_changed(SOUND_DEVICE_IN_BT_SCO, SOUND_DEVICE_OUT_BT_SCO);
+	stub_backend_emit_active_device_changed(SOUND_DEVICE_IN_BT_SCO, SOUND_DEVICE_OUT_BT_SCO);
+	if(g_device_changed != 4 || g_device_diffs != 1 || g_device_change.sequence != 1
+		|| g_device_change.previous_in != SOUND_DEVICE_IN_MIC || g_device_change.previous_out != SOUND_DEVICE_OUT_SPEAKER
+		|| g_device_change.in != SOUND_DEVICE_IN_BT_SCO || g_device_change.out != SOUND_DEVICE_OUT_BT_SCO)
+		ret = -1;
+
+	stub_backend_emit_active_device_changed(SOUND_DEVICE_IN_MIC, SOUND_DEVICE_OUT_RECEIVER);
+	if(g_device_changed != 5 || g_device_diffs != 2 || g_device_change.sequence != 2
+		|| g_device_change.previous_in != SOUND_DEVICE_IN_BT_SCO || g_device_change.previous_out != SOUND_DEVICE_OUT_BT_SCO)
+		ret = -1;
+
+	sound_manager_unset_active_device_diff_cb();
+	sound_manager_unset_active_device_changed_cb();
+	printf("%-36s %s\n", "repeated devices dropped", ret ? "no" : "yes");
+	return ret;
+}
+
+static int __test_route_diff(void)
+{
+	int ret = 0;
+
+	if(sound_manager_set_available_route_changed_cb(__available_route_changed_cb, NULL) != SOUND_MANAGER_ERROR_NONE
+		|| sound_manager_set_available_route_diff_cb(__available_route_diff_cb, NULL) != SOUND_MANAGER_ERROR_NONE)
+		return -1;
+
+	/* the speaker is one of the routes the stub reports */
+	stub_backend_emit_available_route_changed(SOUND_ROUTE_OUT_SPEAKER, true);
+	if(g_route_changed != 1 || g_route_diffs != 0)
+		ret = -1;
+
+	stub_backend_emit_available_route_changed(SOUND_ROUTE_OUT_BLUETOOTH, true);
+	stub_backend_emit_available_route_changed(SOUND_ROUTE_OUT_BLUETOOTH, true);
+	if(g_route_changed != 3 || g_route_diffs != 1 || g_route_change.sequence != 1
+		|| g_route_change.route != SOUND_ROUTE_OUT_BLUETOOTH
+		|| g_route_change.previous_available || !g_route_change.available)
+		ret = -1;
+
+	stub_backend_emit_available_route_changed(SOUND_ROUTE_OUT_BLUETOOTH, false);
+	stub_backend_emit_available_route_changed(SOUND_ROUTE_OUT_BLUETOOTH, false);
+	if(g_route_changed != 5 || g_route_diffs != 2 || g_route_change.sequence != 2
+		|| !g_route_change.previous_available || g_route_change.available)
+		ret = -1;
+
+	sound_manager_unset_available_route_diff_cb();
+	sound_manager_unset_available_route_changed_cb();
+	printf("%-36s %s\n", "repeated routes dropped", ret ? "no" : "yes");
+	return ret;
+}
+
+static int __test_route_policy(void)
+{
+	sound_route_e routes[MAX_ROUTES];
+	sound_route_e route = SOUND_ROUTE_OUT_SPEAKER;
+	bool available = false;
+	unsigned long calls;
+	int count = 0;
+	int ret = 0;
+
+	/* the headset alone, then along with the builtin devices */
+	if(sound_manager_route_policy_get_default_route(SOUND_DEVICE_IN_WIRED_ACCESSORY | SOUND_DEVICE_OUT_WIRED_ACCESSORY, &route) != SOUND_MANAGER_ERROR_NONE
+		|| route != SOUND_ROUTE_INOUT_HEADSET)
+		ret = -1;
+	if(sound_manager_route_policy_get_default_route(HEADSET_DEVICES, &route) != SOUND_MANAGER_ERROR_NONE
+		|| route != SOUND_ROUTE_INOUT_HEADSET)
+		ret = -1;
+	if(sound_manager_route_policy_get_available_routes(HEADSET_DEVICES, routes, MAX_ROUTES, &count) != SOUND_MANAGER_ERROR_NONE
+		|| count != 8 || routes[0] != SOUND_ROUTE_INOUT_HEADSET || routes[count - 1] != SOUND_ROUTE_IN_MIC)
+		ret = -1;
+
+	if(sound_manager_route_policy_is_route_available(HEADSET_DEVICES, SOUND_ROUTE_OUT_BLUETOOTH, &available) != SOUND_MANAGER_ERROR_NONE
+		|| available
+		|| sound_manager_route_policy_is_route_available(HEADSET_DEVICES, SOUND_ROUTE_IN_MIC_OUT_HEADPHONE, &available) != SOUND_MANAGER_ERROR_NONE
+		|| !available)
+		ret = -1;
+
+	/* Bluetooth goes before the headset */
+	if(sound_manager_route_policy_get_default_route(HEADSET_DEVICES | SOUND_DEVICE_OUT_BT_A2DP, &route) != SOUND_MANAGER_ERROR_NONE
+		|| route != SOUND_ROUTE_OUT_BLUETOOTH)
+		ret = -1;
+	if(sound_manager_route_policy_get_default_route(0, &route) != SOUND_MANAGER_ERROR_INVALID_OPERATION
+		|| sound_manager_route_policy_get_default_route(0x80000000, &route) != SOUND_MANAGER_ERROR_INVALID_PARAMETER
+		|| sound_manager_route_policy_is_route_available(HEADSET_DEVICES, (sound_route_e)0x7f, &available) != SOUND_MANAGER_ERROR_INVALID_PARAMETER)
+		ret = -1;
+
+	/* not a route at all, so the sound server is not asked */
+	calls = stub_backend_get_call_count();
+	if(sound_manager_is_route_available((sound_route_e)0x7f) || stub_backend_get_call_count() != calls)
+		ret = -1;
+
+	printf("%-36s %s\n", "headset resolved by the policy", ret ? "no" : "yes");
+	return ret;
+}
+
+int main(int argc, char *argv[])
+{
+	int ret = 0;
+
+	if(bench_parse_args(argc, argv, "", NULL) != 0)
+		return 1;
+
+	if(__test_device_diff() != 0)
+		ret = 1;
+	if(__test_route_diff() != 0)
+		ret = 1;
+	if(__test_route_policy() != 0)
+		ret = 1;
+
+	return bench_end(ret);
+}
@@ -0,0 +1,593 @@
+/*
+* Copyright (c) 2011 Samsung Electronics Co., Ltd All Rights Reserved
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+
+
+/*
+ * Multi-threaded stress test
+ *
+ * Worker threads call every setter, getter and callback registration in random
+ * order while an injector thread fires backend notifications, which is the
+ * access pattern the real notification threads produce. Build it with
+ * -DSANITIZER=thread or -DSANITIZER=address to catch races and memory errors.
+ *
+ * usage : sound_manager_stress_test [duration_ms] [max_threads]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sound_manager.h>
+#include "sound_manager_stub_backend.h"
+#include "sound_manager_bench.h"
+
+#define DEFAULT_DURATION_MS 1000
+#define DEFAULT_MAX_THREADS 8
+#define MAX_THREADS 64
+
+typedef struct {
+	pthread_t thread;
+	unsigned int seed;
+	unsigned long ops;
+	unsigned long errors;
+	sound_focus_h focus;
+}_stress_thread_s;
+
+typedef void (*_stress_op_fn)(_stress_thread_s *t);
+
+static int g_running;
+static unsigned long g_events;
+static char g_persist_path[256];
+
+static void __volume_changed_cb(sound_type_e type, unsigned int volume, void *user_data)
+{
+	__sync_fetch_and_add(&g_events, 1);
+}
+
+static void __session_notify_cb(sound_session_notify_e notify, void *user_data)
+{
+	__sync_fetch_and_add(&g_events, 1);
+}
+
+static void __interrupted_cb(sound_interrupted_code_e code, void *user_data)
+{
+	__sync_fetch_and_add(&g_events, 1);
+}
+
+static void __available_route_changed_cb(sound_route_e route, bool available, void *user_data)
+{
+	__sync_fetch_and_add(&g_events, 1);
+}
+
+static void __active_device_changed_cb(sound_device_in_e in, sound_device_out_e out, void *user_data)
+{
+	__sync_fetch_and_add(&g_events, 1);
+}
+
+static void __available_route_diff_cb(const sound_available_route_change_s *change, void *user_data)
+{
+	__sync_fetch_and_add(&g_events, 1);
+}
+
+static void __active_device_diff_cb(const sound_active_device_change_s *change, void *user_data)
+{
+	__sync_fetch_and_add(&g_events, 1);
+}
+
+static void __event_batch_cb(const sound_event_s *events, unsigned int count, void *user_data)
+{
+	__sync_fetch_and_add(&g_events, count);
+}
+
+static void __focus_state_changed_cb(sound_focus_h focus, sound_focus_state_e state, void *user_data)
+{
+	__sync_fetch_and_add(&g_events, 1);
+}
+
+static void __stream_volume_changed_cb(sound_stream_volume_h stream, double gain, void *user_data)
+{
+	__sync_fetch_and_add(&g_events, 1);
+}
+
+static bool __available_route_cb(sound_route_e route, void *user_data)
+{
+	return true;
+}
+
+static void __check(_stress_thread_s *t, int ret)
+{
+	/* the stub never fails valid requests, policy denials and missed deadlines are expected */
+	if(ret != SOUND_MANAGER_ERROR_NONE && ret != SOUND_MANAGER_ERROR_POLICY
+		&& ret != SOUND_MANAGER_ERROR_STALE_VALUE && ret != SOUND_MANAGER_ERROR_TIMED_OUT)
+		t->errors++;
+}
+
+static void __op_volume(_stress_thread_s *t)
+{
+	int type = rand_r(&t->seed) % (SOUND_TYPE_CALL + 1);
+	int volume;
+	int max;
+
+	__check(t, sound_manager_get_max_volume(type, &max));
+	__check(t, sound_manager_set_volume(type, rand_r(&t->seed) % (max + 1)));
+	__check(t, sound_manager_get_volume(type, &volume));
+}
+
+static void __op_current_sound_type(_stress_thread_s *t)
+{
+	sound_type_e type;
+	int ret;
+
+	ret = sound_manager_get_current_sound_type(&type);
+	if(ret != SOUND_MANAGER_ERROR_NO_PLAYING_SOUND)
+		__check(t, ret);
+}
+
+static void __current_sound_type_changed_cb(sound_type_e type, bool playing, void *user_data)
+{
+	__sync_fetch_and_add(&g_events, 1);
+}
+
+static void __op_current_sound_type_monitor(_stress_thread_s *t)
+{
+	sound_type_e type;
+	int fd;
+	int ret;
+
+	if(rand_r(&t->seed) & 1){
+		__check(t, sound_manager_set_current_sound_type_changed_cb(__current_sound_type_changed_cb, t));
+		if(rand_r(&t->seed) & 1)
+			sound_manager_unset_current_sound_type_changed_cb();
+	}else{
+		__check(t, sound_manager_get_current_sound_type_event_fd(&fd));
+		if(rand_r(&t->seed) & 1)
+			sound_manager_release_current_sound_type_event_fd();
+	}
+	ret = sound_manager_get_current_sound_type(&type);
+	if(ret != SOUND_MANAGER_ERROR_NO_PLAYING_SOUND)
+		__check(t, ret);
+}
+
+static void __op_backend_deadline(_stress_thread_s *t)
+{
+	static const sound_backend_retry_policy_s policy = {2, 1, 4, 3, 10};
+	sound_backend_retry_stats_s stats;
+	sound_backend_latency_s latency;
+	sound_device_in_e in;
+	sound_device_out_e out;
+
+	if((rand_r(&t->seed) & 7) == 0)
+		__check(t, sound_manager_set_backend_deadline(rand_r(&t->seed) & 1));
+	if((rand_r(&t->seed) & 7) == 0)
+		__check(t, sound_manager_set_backend_retry_policy(rand_r(&t->seed) & 1 ? &policy : NULL));
+	__check(t, sound_manager_get_active_device(&in, &out));
+	__check(t, sound_manager_get_backend_latency(&latency));
+	__check(t, sound_manager_get_backend_retry_stats(&stats));
+}
+
+static void __op_volume_coalescing(_stress_thread_s *t)
+{
+	sound_volume_coalescing_stats_s stats;
+	int type = rand_r(&t->seed) % (SOUND_TYPE_CALL + 1);
+	int volume;
+	int i;
+
+	if((rand_r(&t->seed) & 7) == 0)
+		__check(t, sound_manager_set_volume_coalescing(rand_r(&t->seed) & 1 ? 50 : 0, rand_r(&t->seed) % 3));
+	/* a slider drag */
+	for(i = 0 ; i < 4 ; i++)
+		__check(t, sound_manager_set_volume(type, rand_r(&t->seed) % 3));
+	__check(t, sound_manager_get_volume(type, &volume));
+	__check(t, sound_manager_get_volume_coalescing_stats(&stats));
+}
+
+static void __op_volume_changed_cb(_stress_thread_s *t)
+{
+	if(rand_r(&t->seed) & 1)
+		__check(t, sound_manager_set_volume_changed_cb(__volume_changed_cb, t));
+	else
+		sound_manager_unset_volume_changed_cb();
+}
+
+static void __op_event_batch(_stress_thread_s *t)
+{
+	if(rand_r(&t->seed) & 1)
+		__check(t, sound_manager_set_event_batch_cb(rand_r(&t->seed) % 3, 1 + rand_r(&t->seed) % 8, __event_batch_cb, t));
+	else
+		sound_manager_unset_event_batch_cb();
+}
+
+static void __mute_changed_cb(sound_type_e type, bool muted, void *user_data)
+{
+	__sync_fetch_and_add(&g_events, 1);
+}
+
+static void __op_mute(_stress_thread_s *t)
+{
+	sound_type_e type = rand_r(&t->seed) % (SOUND_TYPE_CALL + 1);
+	bool muted;
+
+	switch(rand_r(&t->seed) % 4) {
+	case 0:
+		__check(t, sound_manager_set_mute_changed_cb(__mute_changed_cb, t));
+		break;
+	case 1:
+		sound_manager_unset_mute_changed_cb();
+		break;
+	default:
+		__check(t, sound_manager_set_mute(type, rand_r(&t->seed) & 1));
+		__check(t, sound_manager_get_mute(type, &muted));
+		break;
+	}
+}
+
+static void __op_persistence(_stress_thread_s *t)
+{
+	sound_persisted_state_s state;
+
+	switch(rand_r(&t->seed) % 3) {
+	case 0:
+		__check(t, sound_manager_set_persistence(g_persist_path, rand_r(&t->seed) % 3));
+		break;
+	case 1:
+		sound_manager_unset_persistence();
+		break;
+	default:
+		/* not set is a valid answer here */
+		sound_manager_get_persisted_state(&state);
+		break;
+	}
+}
+
+static void __op_session(_stress_thread_s *t)
+{
+	switch(rand_r(&t->seed) % 5) {
+	case 0:
+		__check(t, sound_manager_set_session_type(rand_r(&t->seed) % (SOUND_SESSION_TYPE_EXCLUSIVE + 1)));
+		break;
+	case 1:
+		__check(t, sound_manager_set_session_notify_cb(__session_notify_cb, t));
+		break;
+	case 2:
+		sound_manager_unset_session_notify_cb();
+		break;
+	case 3:
+		__check(t, sound_manager_set_interrupted_cb(__interrupted_cb, t));
+		break;
+	default:
+		sound_manager_unset_interrupted_cb();
+		break;
+	}
+}
+
+static void __volume_key_type_changed_cb(volume_key_type_e type, void *user_data)
+{
+	__sync_fetch_and_add(&g_events, 1);
+}
+
+static void __op_volume_key_type(_stress_thread_s *t)
+{
+	volume_key_type_e type;
+
+	switch(rand_r(&t->seed) % 4) {
+	case 0:
+		__check(t, sound_manager_set_volume_key_type_changed_cb(__volume_key_type_changed_cb, t));
+		break;
+	case 1:
+		sound_manager_unset_volume_key_type_changed_cb();
+		break;
+	default:
+		__check(t, sound_manager_set_volume_key_type(VOLUME_KEY_TYPE_NONE + rand_r(&t->seed) % (VOLUME_KEY_TYPE_CALL + 2)));
+		break;
+	}
+	__check(t, sound_manager_get_volume_key_type(&type));
+}
+
+static void __op_route(_stress_thread_s *t)
+{
+	sound_device_in_e in;
+	sound_device_out_e out;
+	sound_route_e routes[4];
+	int count;
+
+	unsigned int devices = (rand_r(&t->seed) & 0x07) | ((rand_r(&t->seed) & 0x1f) << 8);
+	sound_route_e route;
+	bool available;
+
+	switch(rand_r(&t->seed) % 6) {
+	case 0:
+		__check(t, sound_manager_foreach_available_route(__available_route_cb, t));
+		break;
+	case 4:
+		__check(t, sound_manager_route_policy_get_available_routes(devices, routes, rand_r(&t->seed) % 5, &count));
+		if(sound_manager_route_policy_get_default_route(devices, &route) == SOUND_MANAGER_ERROR_NONE)
+			__check(t, sound_manager_route_policy_is_route_available(devices, route, &available));
+		break;
+	case 1:
+		__check(t, sound_manager_set_active_route(SOUND_ROUTE_OUT_SPEAKER));
+		break;
+	case 2:
+		__check(t, sound_manager_get_active_device(&in, &out));
+		break;
+	case 3:
+		__check(t, sound_manager_get_available_routes(routes, rand_r(&t->seed) % 5, &count));
+		break;
+	default:
+		sound_manager_is_route_available(SOUND_ROUTE_IN_MIC_OUT_RECEIVER);
+		break;
+	}
+}
+
+static void __op_route_cb(_stress_thread_s *t)
+{
+	switch(rand_r(&t->seed) % 8) {
+	case 0:
+		__check(t, sound_manager_set_available_route_changed_cb(__available_route_changed_cb, t));
+		break;
+	case 1:
+		sound_manager_unset_available_route_changed_cb();
+		break;
+	case 2:
+		__check(t, sound_manager_set_active_device_changed_cb(__active_device_changed_cb, t));
+		break;
+	case 3:
+		sound_manager_unset_active_device_changed_cb();
+		break;
+	case 4:
+		__check(t, sound_manager_set_available_route_diff_cb(__available_route_diff_cb, t));
+		break;
+	case 5:
+		sound_manager_unset_available_route_diff_cb();
+		break;
+	case 6:
+		__check(t, sound_manager_set_active_device_diff_cb(__active_device_diff_cb, t));
+		break;
+	default:
+		sound_manager_unset_active_device_diff_cb();
+		break;
+	}
+}
+
+static void __op_focus(_stress_thread_s *t)
+{
+	sound_focus_state_e state;
+
+	if(rand_r(&t->seed) % 3)
+		__check(t, sound_manager_focus_request(t->focus, rand_r(&t->seed) % (SOUND_FOCUS_REQUEST_GAIN_EXCLUSIVE + 1)));
+	else
+		__check(t, sound_manager_focus_abandon(t->focus));
+	__check(t, sound_manager_focus_get_state(t->focus, &state));
+}
+
+static void __op_call_session(_stress_thread_s *t)
+{
+	sound_call_session_h session;
+	sound_call_session_mode_e mode;
+	int prepared = rand_r(&t->seed) & 1;
+	int ret;
+
+	if(prepared)
+		ret = sound_manager_call_session_prepare(rand_r(&t->seed) & 1, &session);
+	else
+		ret = sound_manager_call_session_create(rand_r(&t->seed) & 1, &session);
+	if(ret != SOUND_MANAGER_ERROR_NONE) {
+		t->errors++;
+		return;
+	}
+	__check(t, sound_manager_call_session_set_mode(session, rand_r(&t->seed) % (SOUND_CALL_SESSION_MODE_MEDIA + 1)));
+	/* a prepared call may be rejected before it is answered */
+	if(prepared && rand_r(&t->seed) % 4)
+		__check(t, sound_manager_call_session_activate(session));
+	__check(t, sound_manager_call_session_get_mode(session, &mode));
+	__check(t, sound_manager_call_session_destroy(session));
+}
+
+static void __op_stream_volume(_stress_thread_s *t)
+{
+	sound_stream_volume_h stream;
+	double gain;
+
+	if(sound_manager_stream_volume_create(rand_r(&t->seed) % (SOUND_TYPE_CALL + 1), &stream) != SOUND_MANAGER_ERROR_NONE) {
+		t->errors++;
+		return;
+	}
+	__check(t, sound_manager_stream_volume_set_changed_cb(stream, __stream_volume_changed_cb, t));
+	__check(t, sound_manager_stream_volume_set_gain(stream, (rand_r(&t->seed) % 11) / 10.0));
+	__check(t, sound_manager_stream_volume_get_effective_gain(stream, &gain));
+	__check(t, sound_manager_stream_volume_destroy(stream));
+}
+
+static void __op_ducking(_stress_thread_s *t)
+{
+	double gain;
+
+	if(rand_r(&t->seed) & 1)
+		__check(t, sound_manager_enable_auto_ducking(0.3, rand_r(&t->seed) % 20, rand_r(&t->seed) % 20));
+	else
+		__check(t, sound_manager_disable_auto_ducking());
+	__check(t, sound_manager_get_auto_ducking_gain(&gain));
+}
+
+static void __op_transaction(_stress_thread_s *t)
+{
+	sound_transaction_h transaction;
+
+	if(sound_manager_transaction_create(&transaction) != SOUND_MANAGER_ERROR_NONE) {
+		t->errors++;
+		return;
+	}
+	__check(t, sound_manager_transaction_set_active_route(transaction, SOUND_ROUTE_OUT_SPEAKER));
+	__check(t, sound_manager_transaction_set_volume(transaction, SOUND_TYPE_MEDIA, rand_r(&t->seed) % 8));
+	__check(t, sound_manager_transaction_commit(transaction, NULL));
+	__check(t, sound_manager_transaction_destroy(transaction));
+}
+
+static const _stress_op_fn g_ops[] = {
+	__op_volume,
+	__op_current_sound_type,
+	__op_volume_changed_cb,
+	__op_session,
+	__op_volume_key_type,
+	__op_route,
+	__op_route_cb,
+	__op_focus,
+	__op_call_session,
+	__op_transaction,
+	__op_stream_volume,
+	__op_ducking,
+	__op_current_sound_type_monitor,
+	__op_backend_deadline,
+	__op_volume_coalescing,
+	__op_event_batch,
+	__op_persistence,
+	__op_mute,
+};
+
+static void *__worker(void *data)
+{
+	_stress_thread_s *t = data;
+	int num_ops = sizeof(g_ops) / sizeof(g_ops[0]);
+
+	while(__sync_fetch_and_add(&g_running, 0)) {
+		g_ops[rand_r(&t->seed) % num_ops](t);
+		t->ops++;
+	}
+
+	return NULL;
+}
+
+static void *__injector(void *data)
+{
+	unsigned int seed = 1;
+
+	while(__sync_fetch_and_add(&g_running, 0)) {
+		switch(rand_r(&seed) % 6) {
+		case 0:
+			stub_backend_emit_volume_changed(rand_r(&seed) % (SOUND_TYPE_CALL + 1));
+			break;
+		case 1:
+			stub_backend_emit_session(rand_r(&seed) & 1 ? MM_SESSION_MSG_STOP : MM_SESSION_MSG_RESUME, rand_r(&seed) & 1 ? MM_SESSION_EVENT_OTHER_APP : MM_SESSION_EVENT_CALL);
+			break;
+		case 2:
+			/* mostly repeats, as during a Bluetooth reconnect */
+			stub_backend_emit_active_device_changed(SOUND_DEVICE_IN_MIC, rand_r(&seed) % 4 ? SOUND_DEVICE_OUT_SPEAKER : SOUND_DEVICE_OUT_BT_A2DP);
+			break;
+		case 3:
+			stub_backend_set_playing_type(rand_r(&seed) & 1 ? SOUND_TYPE_MEDIA : -1);
+			break;
+		case 4:
+			/* occasional slow sound server, so the deadline path is taken */
+			stub_backend_set_latency(rand_r(&seed) % 4 ? 0 : 2000);
+			break;
+		default:
+			stub_backend_emit_available_route_changed(SOUND_ROUTE_OUT_WIRED_ACCESSORY, rand_r(&seed) & 1);
+			break;
+		}
+	}
+
+	return NULL;
+}
+
+static int __run(int num_threads, int duration_ms)
+{
+	_stress_thread_s threads[MAX_THREADS];
+	pthread_t injector;
+	unsigned long ops = 0;
+	unsigned long errors = 0;
+	double start, elapsed;
+	int i;
+
+	memset(threads, 0, sizeof(threads));
+	for(i = 0 ; i < num_threads ; i++) {
+		threads[i].seed = i + 1;
+		if(sound_manager_focus_create(i % (SOUND_FOCUS_PRIORITY_CALL + 1), __focus_state_changed_cb, &threads[i], &threads[i].focus) != SOUND_MANAGER_ERROR_NONE)
+			return -1;
+	}
+
+	__sync_lock_test_and_set(&g_running, 1);
+	start = bench_now_us();
+	pthread_create(&injector, NULL, __injector, NULL);
+	for(i = 0 ; i < num_threads ; i++)
+		pthread_create(&threads[i].thread, NULL, __worker, &threads[i]);
+
+	usleep(duration_ms * 1000);
+	__sync_lock_test_and_set(&g_running, 0);
+
+	for(i = 0 ; i < num_threads ; i++) {
+		pthread_join(threads[i].thread, NULL);
+		ops += threads[i].ops;
+		errors += threads[i].errors;
+		sound_manager_focus_destroy(threads[i].focus);
+	}
+	pthread_join(injector, NULL);
+	elapsed = (bench_now_us() - start) / 1000000;
+
+	printf("%7d %14.0f %14.0f %10lu %8lu\n", num_threads, ops / elapsed, ops / elapsed / num_threads,
+		__sync_fetch_and_add(&g_events, 0), errors);
+	__sync_lock_test_and_set(&g_events, 0);
+
+	return errors ? -1 : 0;
+}
+
+int main(int argc, char *argv[])
+{
+	int duration_ms = DEFAULT_DURATION_MS;
+	sound_backend_latency_s latency;
+	int max_threads = DEFAULT_MAX_THREADS;
+	int num_threads;
+	int ret = 0;
+
+	if(bench_parse_args(argc, argv, "[duration_ms] [max_threads]", &duration_ms, 1, &max_threads, 1, NULL) != 0)
+		return 1;
+	if(max_threads > MAX_THREADS) {
+		fprintf(stderr, "usage : %s [duration_ms] [max_threads(1~%d)]\n", argv[0], MAX_THREADS);
+		return 1;
+	}
+
+	snprintf(g_persist_path, sizeof(g_persist_path), "%s/sound_manager_stress_test.%d", getenv("TMPDIR") ? getenv("TMPDIR") : "/tmp", getpid());
+
+	printf("%7s %14s %14s %10s %8s\n", "threads", "ops/sec", "ops/sec/thread", "events", "errors");
+	for(num_threads = 1 ; num_threads <= max_threads ; num_threads *= 2) {
+		if(__run(num_threads, duration_ms) != 0)
+			ret = 1;
+	}
+
+	sound_manager_unset_volume_changed_cb();
+	sound_manager_unset_session_notify_cb();
+	sound_manager_unset_interrupted_cb();
+	sound_manager_unset_available_route_changed_cb();
+	sound_manager_unset_active_device_changed_cb();
+	sound_manager_unset_available_route_diff_cb();
+	sound_manager_unset_active_device_diff_cb();
+	sound_manager_unset_current_sound_type_changed_cb();
+	sound_manager_release_current_sound_type_event_fd();
+	sound_manager_unset_volume_key_type_changed_cb();
+	sound_manager_unset_event_batch_cb();
+	sound_manager_set_backend_deadline(0);
+	sound_manager_set_backend_retry_policy(NULL);
+	sound_manager_set_volume_coalescing(0, 0);
+	sound_manager_unset_persistence();
+	unlink(g_persist_path);
+	sound_manager_unset_mute_changed_cb();
+
+	if(sound_manager_get_backend_latency(&latency) == SOUND_MANAGER_ERROR_NONE)
+		printf("backend calls %u, p50 %uus, p99 %uus, p99.9 %uus, max %uus, deadline missed %u\n",
+			latency.count, latency.p50_us, latency.p99_us, latency.p999_us, latency.max_us, latency.deadline_missed);
+
+	return bench_end(ret);
+}
@@ -0,0 +1,496 @@
+/*
+* Copyright (c) 2011 Samsung Electronics Co., Ltd All Rights Reserved
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <mm_sound.h>
+#include <mm_sound_private.h>
+#include <mm_session.h>
+#include <mm_session_private.h>
+#include "sound_manager_stub_backend.h"
+
+#define STUB_VOLUME_TYPE_NUM 6
+#define STUB_VOLUME_STEP 16
+
+typedef struct {
+	pthread_mutex_t lock;
+	unsigned int latency;
+	unsigned long calls;
+	int down;	/* requests fail as while the sound server restarts */
+	unsigned int failing_mask;	/* stub_request_e bits */
+	unsigned long request_seq[STUB_REQUEST_NUM];
+
+	unsigned int volume[STUB_VOLUME_TYPE_NUM];
+	volume_callback_fn volume_cb[STUB_VOLUME_TYPE_NUM];
+	void *volume_cb_data[STUB_VOLUME_TYPE_NUM];
+	int primary_type;
+	int playing_type;	/* -1 when nothing is playing */
+
+	int session_type;
+	session_callback_fn session_cb;
+	void *session_cb_data;
+	mm_subsession_t subsession;
+
+	mm_sound_route route;
+	mm_sound_device_in device_in;
+	mm_sound_device_out device_out;
+	mm_sound_active_device_changed_cb device_cb;
+	void *device_cb_data;
+	mm_sound_available_route_changed_cb route_cb;
+	void *route_cb_data;
+}_stub_backend_s;
+
+static _stub_backend_s g_stub = {
+	.lock = PTHREAD_MUTEX_INITIALIZER,
+	.primary_type = -1,
+	.playing_type = 1,	/* media */
+	.session_type = -1,
+	.route = 0x01 << 8,
+	.device_in = 0x01,
+	.device_out = 0x01 << 8,
+};
+
+static const mm_sound_route g_stub_routes[] = {
+	0x01 << 8,		/* speaker */
+	0x04 << 8,		/* wired accessory */
+	0x01 | (0x02 << 8),	/* mic + receiver */
+	0x01 | (0x01 << 8),	/* mic + speaker */
+};
+
+/* every client call pays the configured round trip, requests fail while the server is down */
+static int __stub_enter(void)
+{
+	unsigned int latency;
+	int down;
+
+	pthread_mutex_lock(&g_stub.lock);
+	g_stub.calls++;
+	latency = g_stub.latency;
+	down = g_stub.down;
+	pthread_mutex_unlock(&g_stub.lock);
+
+	if(latency)
+		usleep(latency);
+	return down ? MM_ERROR_SOUND_INTERNAL : MM_ERROR_NONE;
+}
+
+/* records the order of the request, returns non-zero while the test makes it fail */
+static int __stub_request(stub_request_e request)
+{
+	int failing;
+
+	pthread_mutex_lock(&g_stub.lock);
+	g_stub.request_seq[request] = g_stub.calls;
+	failing = g_stub.failing_mask & (1 << request);
+	pthread_mutex_unlock(&g_stub.lock);
+
+	return failing;
+}
+
+static int __stub_enter_request(stub_request_e request)
+{
+	int ret = __stub_enter();
+
+	if(__stub_request(request) && ret == MM_ERROR_NONE)
+		ret = MM_ERROR_INVALID_ARGUMENT;
+	return ret;
+}
+
+void stub_backend_set_latency(unsigned int usec)
+{
+	pthread_mutex_lock(&g_stub.lock);
+	g_stub.latency = usec;
+	pthread_mutex_unlock(&g_stub.lock);
+}
+
+void stub_backend_set_down(bool down)
+{
+	pthread_mutex_lock(&g_stub.lock);
+	g_stub.down = down;
+	pthread_mutex_unlock(&g_stub.lock);
+}
+
+void stub_backend_set_failing(stub_request_e request, bool failing)
+{
+	pthread_mutex_lock(&g_stub.lock);
+	if(failing)
+		g_stub.failing_mask |= (1 << request);
+	else
+		g_stub.failing_mask &= ~(1 << request);
+	pthread_mutex_unlock(&g_stub.lock);
+}
+
+unsigned long stub_backend_get_request_seq(stub_request_e request)
+{
+	unsigned long seq;
+
+	pthread_mutex_lock(&g_stub.lock);
+	seq = g_stub.request_seq[request];
+	pthread_mutex_unlock(&g_stub.lock);
+
+	return seq;
+}
+
+int stub_backend_get_session_type(void)
+{
+	int session_type;
+
+	pthread_mutex_lock(&g_stub.lock);
+	session_type = g_stub.session_type;
+	pthread_mutex_unlock(&g_stub.lock);
+	return session_type;
+}
+
+unsigned long stub_backend_get_call_count(void)
+{
+	unsigned long calls;
+
+	pthread_mutex_lock(&g_stub.lock);
+	calls = g_stub.calls;
+	pthread_mutex_unlock(&g_stub.lock);
+
+	return calls;
+}
+
+void stub_backend_set_playing_type(int type)
+{
+	pthread_mutex_lock(&g_stub.lock);
+	g_stub.playing_type = type;
+	pthread_mutex_unlock(&g_stub.lock);
+}
+
+void stub_backend_emit_volume_changed(int type)
+{
+	volume_callback_fn cb;
+	void *data;
+
+	if(type < 0 || type >= STUB_VOLUME_TYPE_NUM)
+		return;
+
+	pthread_mutex_lock(&g_stub.lock);
+	cb = g_stub.volume_cb[type];
+	data = g_stub.volume_cb_data[type];
+	pthread_mutex_unlock(&g_stub.lock);
+
+	if(cb)
+		cb(data);
+}
+
+void stub_backend_emit_session(session_msg_t msg, session_event_t event)
+{
+	session_callback_fn cb;
+	void *data;
+
+	pthread_mutex_lock(&g_stub.lock);
+	cb = g_stub.session_cb;
+	data = g_stub.session_cb_data;
+	pthread_mutex_unlock(&g_stub.lock);
+
+	if(cb)
+		cb(msg, event, data);
+}
+
+void stub_backend_emit_active_device_changed(int in, int out)
+{
+	mm_sound_active_device_changed_cb cb;
+	void *data;
+
+	pthread_mutex_lock(&g_stub.lock);
+	g_stub.device_in = in;
+	g_stub.device_out = out;
+	cb = g_stub.device_cb;
+	data = g_stub.device_cb_data;
+	pthread_mutex_unlock(&g_stub.lock);
+
+	if(cb)
+		cb(in, out, data);
+}
+
+void stub_backend_emit_available_route_changed(int route, bool available)
+{
+	mm_sound_available_route_changed_cb cb;
+	void *data;
+
+	pthread_mutex_lock(&g_stub.lock);
+	cb = g_stub.route_cb;
+	data = g_stub.route_cb_data;
+	pthread_mutex_unlock(&g_stub.lock);
+
+	if(cb)
+		cb(route, available, data);
+}
+
+int mm_sound_volume_get_step(volume_type_t type, int *step)
+{
+	if(__stub_enter() != MM_ERROR_NONE)
+		return MM_ERROR_SOUND_INTERNAL;
+	if(type < 0 || type >= STUB_VOLUME_TYPE_NUM || step == NULL)
+		return MM_ERROR_INVALID_ARGUMENT;
+	*step = STUB_VOLUME_STEP;
+	return MM_ERROR_NONE;
+}
+
+int mm_sound_volume_set_value(volume_type_t type, const unsigned int value)
+{
+	int ret = __stub_enter_request(STUB_REQUEST_VOLUME_SET);
+
+	if(ret != MM_ERROR_NONE)
+		return ret;
+	if(type < 0 || type >= STUB_VOLUME_TYPE_NUM || value >= STUB_VOLUME_STEP)
+		return MM_ERROR_INVALID_ARGUMENT;
+	pthread_mutex_lock(&g_stub.lock);
+	g_stub.volume[type] = value;
+	pthread_mutex_unlock(&g_stub.lock);
+	return MM_ERROR_NONE;
+}
+
+int mm_sound_volume_get_value(volume_type_t type, unsigned int *value)
+{
+	if(__stub_enter() != MM_ERROR_NONE)
+		return MM_ERROR_SOUND_INTERNAL;
+	if(type < 0 || type >= STUB_VOLUME_TYPE_NUM || value == NULL)
+		return MM_ERROR_INVALID_ARGUMENT;
+	pthread_mutex_lock(&g_stub.lock);
+	*value = g_stub.volume[type];
+	pthread_mutex_unlock(&g_stub.lock);
+	return MM_ERROR_NONE;
+}
+
+int mm_sound_volume_get_current_playing_type(volume_type_t *type)
+{
+	int playing;
+
+	if(__stub_enter() != MM_ERROR_NONE)
+		return MM_ERROR_SOUND_INTERNAL;
+	if(type == NULL)
+		return MM_ERROR_INVALID_ARGUMENT;
+	pthread_mutex_lock(&g_stub.lock);
+	playing = g_stub.playing_type;
+	pthread_mutex_unlock(&g_stub.lock);
+	if(playing < 0)
+		return MM_ERROR_SOUND_VOLUME_NO_INSTANCE;
+	*type = playing;
+	return MM_ERROR_NONE;
+}
+
+int mm_sound_volume_add_callback(volume_type_t type, volume_callback_fn func, void *user_data)
+{
+	__stub_enter();
+	if(type < 0 || type >= STUB_VOLUME_TYPE_NUM)
+		return MM_ERROR_INVALID_ARGUMENT;
+	pthread_mutex_lock(&g_stub.lock);
+	g_stub.volume_cb[type] = func;
+	g_stub.volume_cb_data[type] = user_data;
+	pthread_mutex_unlock(&g_stub.lock);
+	return MM_ERROR_NONE;
+}
+
+int mm_sound_volume_remove_callback(volume_type_t type)
+{
+	__stub_enter();
+	if(type < 0 || type >= STUB_VOLUME_TYPE_NUM)
+		return MM_ERROR_INVALID_ARGUMENT;
+	pthread_mutex_lock(&g_stub.lock);
+	g_stub.volume_cb[type] = NULL;
+	g_stub.volume_cb_data[type] = NULL;
+	pthread_mutex_unlock(&g_stub.lock);
+	return MM_ERROR_NONE;
+}
+
+int mm_sound_volume_primary_type_set(volume_type_t type)
+{
+	if(__stub_enter() != MM_ERROR_NONE)
+		return MM_ERROR_SOUND_INTERNAL;
+	pthread_mutex_lock(&g_stub.lock);
+	g_stub.primary_type = type;
+	pthread_mutex_unlock(&g_stub.lock);
+	return MM_ERROR_NONE;
+}
+
+int mm_sound_volume_primary_type_clear(void)
+{
+	if(__stub_enter() != MM_ERROR_NONE)
+		return MM_ERROR_SOUND_INTERNAL;
+	pthread_mutex_lock(&g_stub.lock);
+	g_stub.primary_type = -1;
+	pthread_mutex_unlock(&g_stub.lock);
+	return MM_ERROR_NONE;
+}
+
+int mm_sound_route_get_a2dp_status(int *connected, char **bt_name)
+{
+	__stub_enter();
+	if(connected == NULL || bt_name == NULL)
+		return MM_ERROR_INVALID_ARGUMENT;
+	*connected = 0;
+	*bt_name = NULL;
+	return MM_ERROR_NONE;
+}
+
+int mm_sound_foreach_available_route_cb(mm_sound_available_route_cb func, void *user_data)
+{
+	unsigned int i;
+
+	__stub_enter();
+	if(func == NULL)
+		return MM_ERROR_INVALID_ARGUMENT;
+	for(i = 0 ; i < sizeof(g_stub_routes) / sizeof(g_stub_routes[0]) ; i++)
+	{
+		if(!func(g_stub_routes[i], user_data))
+			break;
+	}
+	return MM_ERROR_NONE;
+}
+
+int mm_sound_set_active_route(mm_sound_route route)
+{
+	int ret = __stub_enter_request(STUB_REQUEST_ROUTE_SET);
+
+	if(ret != MM_ERROR_NONE)
+		return ret;
+	pthread_mutex_lock(&g_stub.lock);
+	g_stub.route = route;
+	g_stub.device_in = route & 0xff;
+	g_stub.device_out = route & 0xff00;
+	pthread_mutex_unlock(&g_stub.lock);
+	return MM_ERROR_NONE;
+}
+
+int mm_sound_get_active_device(mm_sound_device_in *device_in, mm_sound_device_out *device_out)
+{
+	if(__stub_enter() != MM_ERROR_NONE)
+		return MM_ERROR_SOUND_INTERNAL;
+	if(device_in == NULL || device_out == NULL)
+		return MM_ERROR_INVALID_ARGUMENT;
+	pthread_mutex_lock(&g_stub.lock);
+	*device_in = g_stub.device_in;
+	*device_out = g_stub.device_out;
+	pthread_mutex_unlock(&g_stub.lock);
+	return MM_ERROR_NONE;
+}
+
+int mm_sound_is_route_available(mm_sound_route route, bool *is_available)
+{
+	unsigned int i;
+
+	__stub_enter();
+	if(is_available == NULL)
+		return MM_ERROR_INVALID_ARGUMENT;
+	*is_available = false;
+	for(i = 0 ; i < sizeof(g_stub_routes) / sizeof(g_stub_routes[0]) ; i++)
+	{
+		if(g_stub_routes[i] == route)
+			*is_available = true;
+	}
+	return MM_ERROR_NONE;
+}
+
+int mm_sound_add_active_device_changed_callback(mm_sound_active_device_changed_cb func, void *user_data)
+{
+	__stub_enter();
+	pthread_mutex_lock(&g_stub.lock);
+	g_stub.device_cb = func;
+	g_stub.device_cb_data = user_data;
+	pthread_mutex_unlock(&g_stub.lock);
+	return MM_ERROR_NONE;
+}
+
+int mm_sound_remove_active_device_changed_callback(void)
+{
+	__stub_enter();
+	pthread_mutex_lock(&g_stub.lock);
+	g_stub.device_cb = NULL;
+	g_stub.device_cb_data = NULL;
+	pthread_mutex_unlock(&g_stub.lock);
+	return MM_ERROR_NONE;
+}
+
+int mm_sound_add_available_route_changed_callback(mm_sound_available_route_changed_cb func, void *user_data)
+{
+	__stub_enter();
+	pthread_mutex_lock(&g_stub.lock);
+	g_stub.route_cb = func;
+	g_stub.route_cb_data = user_data;
+	pthread_mutex_unlock(&g_stub.lock);
+	return MM_ERROR_NONE;
+}
+
+int mm_sound_remove_available_route_changed_callback(void)
+{
+	__stub_enter();
+	pthread_mutex_lock(&g_stub.lock);
+	g_stub.route_cb = NULL;
+	g_stub.route_cb_data = NULL;
+	pthread_mutex_unlock(&g_stub.lock);
+	return MM_ERROR_NONE;
+}
+
+int mm_session_init(int sessiontype)
+{
+	return mm_session_init_ex(sessiontype, NULL, NULL);
+}
+
+int mm_session_init_ex(int sessiontype, session_callback_fn callback, void *user_param)
+{
+	__stub_enter();
+	if(__stub_request(STUB_REQUEST_SESSION_INIT))
+		return MM_ERROR_INVALID_ARGUMENT;
+	pthread_mutex_lock(&g_stub.lock);
+	g_stub.session_type = sessiontype;
+	g_stub.session_cb = callback;
+	g_stub.session_cb_data = user_param;
+	g_stub.subsession = MM_SUBSESSION_TYPE_VOICE;
+	pthread_mutex_unlock(&g_stub.lock);
+	return MM_ERROR_NONE;
+}
+
+int mm_session_finish(void)
+{
+	__stub_enter();
+	pthread_mutex_lock(&g_stub.lock);
+	g_stub.session_type = -1;
+	g_stub.session_cb = NULL;
+	g_stub.session_cb_data = NULL;
+	pthread_mutex_unlock(&g_stub.lock);
+	return MM_ERROR_NONE;
+}
+
+int mm_session_set_subsession(mm_subsession_t subsession)
+{
+	__stub_enter();
+	if(__stub_request(STUB_REQUEST_SUBSESSION_SET))
+		return MM_ERROR_INVALID_ARGUMENT;
+	pthread_mutex_lock(&g_stub.lock);
+	g_stub.subsession = subsession;
+	pthread_mutex_unlock(&g_stub.lock);
+	return MM_ERROR_NONE;
+}
+
+int mm_session_get_subsession(mm_subsession_t *subsession)
+{
+	__stub_enter();
+	if(subsession == NULL)
+		return MM_ERROR_INVALID_ARGUMENT;
+	pthread_mutex_lock(&g_stub.lock);
+	*subsession = g_stub.subsession;
+	pthread_mutex_unlock(&g_stub.lock);
+	return MM_ERROR_NONE;
+}
@@ -0,0 +1,70 @@
+/*
+* Copyright (c) 2011 Samsung Electronics Co., Ltd All Rights Reserved
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+
+
+
+#ifndef __TIZEN_MEDIA_SOUND_MANAGER_STUB_BACKEND_H__
+#define __TIZEN_MEDIA_SOUND_MANAGER_STUB_BACKEND_H__
+
+#include <stdbool.h>
+#include <mm_session.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/*
+ * In-process replacement of the mm-sound and mm-session client calls used by
+ * the library. The emit functions play the role of the backend notification
+ * thread and invoke whatever the library registered.
+ */
+
+/* requests whose order and failure a test can control */
+typedef enum {
+	STUB_REQUEST_VOLUME_SET,
+	STUB_REQUEST_ROUTE_SET,
+	STUB_REQUEST_SESSION_INIT,
+	STUB_REQUEST_SUBSESSION_SET,
+	STUB_REQUEST_NUM
+}stub_request_e;
+
+void stub_backend_set_latency(unsigned int usec);
+unsigned long stub_backend_get_call_count(void);
+/* while down the volume and route requests fail with MM_ERROR_SOUND_INTERNAL */
+void stub_backend_set_down(bool down);
+/* while failing the request is rejected with MM_ERROR_INVALID_ARGUMENT, which is not retried */
+void stub_backend_set_failing(stub_request_e request, bool failing);
+/* the call count at the last request of that kind, 0 if there was none */
+unsigned long stub_backend_get_request_seq(stub_request_e request);
+
+/* the type of the registered mm-session, -1 when there is none */
+int stub_backend_get_session_type(void);
+
+/* -1 makes the playing type query report that nothing is playing */
+void stub_backend_set_playing_type(int type);
+
+void stub_backend_emit_volume_changed(int type);
+void stub_backend_emit_session(session_msg_t msg, session_event_t event);
+void stub_backend_emit_active_device_changed(int in, int out);
+void stub_backend_emit_available_route_changed(int route, bool available);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __TIZEN_MEDIA_SOUND_MANAGER_STUB_BACKEND_H__ */
@@ -0,0 +1,166 @@
+/*
+* Copyright (c) 2011 Samsung Electronics Co., Ltd All Rights Reserved
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+
+
+/*
+ * Audio transaction test
+ *
+ * Commits transactions over the stub backend: the levels reach the sound
+ * server before the call session, the route and the call mode even while
+ * the coalescer holds an older level back, a commit without a call session
+ * clears the session handle, and a failed step tears down the call session
+ * created by the commit.
+ *
+ * usage : sound_manager_transaction_test
+ */
+
+#include <stdio.h>
+#include <unistd.h>
+#include <mm_sound.h>
+#include <sound_manager.h>
+#include "sound_manager_stub_backend.h"
+#include "sound_manager_bench.h"
+
+#define COALESCE_RATE 4
+#define COALESCE_INTERVAL_US (1000000 / COALESCE_RATE)
+#define COALESCE_TOLERANCE 15
+
+static int __backend_volume(sound_type_e type)
+{
+	unsigned int volume = 0;
+
+	mm_sound_volume_get_value(type, &volume);
+	return volume;
+}
+
+static int __test_commit_order(void)
+{
+	sound_transaction_h transaction = NULL;
+	sound_call_session_h session = NULL;
+	unsigned long volume_seq;
+	unsigned long init_seq;
+	unsigned long route_seq;
+	unsigned long mode_seq;
+	int ret = 0;
+
+	/* the second level waits in the coalescer */
+	sound_manager_set_volume_coalescing(COALESCE_RATE, COALESCE_TOLERANCE);
+	if(sound_manager_set_volume(SOUND_TYPE_MEDIA, 3) != SOUND_MANAGER_ERROR_NONE
+		|| sound_manager_set_volume(SOUND_TYPE_MEDIA, 4) != SOUND_MANAGER_ERROR_NONE
+		|| __backend_volume(SOUND_TYPE_MEDIA) != 3)
+		ret = -1;
+
+	if(sound_manager_transaction_create(&transaction) != SOUND_MANAGER_ERROR_NONE)
+		return -1;
+	if(sound_manager_transaction_set_volume(transaction, SOUND_TYPE_MEDIA, 7) != SOUND_MANAGER_ERROR_NONE
+		|| sound_manager_transaction_set_active_route(transaction, SOUND_ROUTE_IN_MIC_OUT_SPEAKER) != SOUND_MANAGER_ERROR_NONE
+		|| sound_manager_transaction_set_call_session(transaction, SOUND_SESSION_TYPE_CALL, SOUND_CALL_SESSION_MODE_RINGTONE) != SOUND_MANAGER_ERROR_NONE
+		|| sound_manager_transaction_commit(transaction, &session) != SOUND_MANAGER_ERROR_NONE
+		|| session == NULL)
+		ret = -1;
+
+	volume_seq = stub_backend_get_request_seq(STUB_REQUEST_VOLUME_SET);
+	init_seq = stub_backend_get_request_seq(STUB_REQUEST_SESSION_INIT);
+	route_seq = stub_backend_get_request_seq(STUB_REQUEST_ROUTE_SET);
+	mode_seq = stub_backend_get_request_seq(STUB_REQUEST_SUBSESSION_SET);
+	if(__backend_volume(SOUND_TYPE_MEDIA) != 7 || !(volume_seq < init_seq && init_seq < route_seq && route_seq < mode_seq))
+		ret = -1;
+
+	/* the level held back is older and must not come after the committed one */
+	usleep(2 * COALESCE_INTERVAL_US);
+	if(__backend_volume(SOUND_TYPE_MEDIA) != 7)
+		ret = -1;
+	sound_manager_set_volume_coalescing(0, 0);
+
+	if(session)
+		sound_manager_call_session_destroy(session);
+	sound_manager_transaction_destroy(transaction);
+	printf("%-36s %s\n", "levels, route, then call mode", ret ? "no" : "yes");
+	return ret;
+}
+
+static int __test_without_session(void)
+{
+	sound_transaction_h transaction = NULL;
+	sound_call_session_h session = (sound_call_session_h)1;
+	int ret = 0;
+
+	if(sound_manager_transaction_create(&transaction) != SOUND_MANAGER_ERROR_NONE)
+		return -1;
+	if(sound_manager_transaction_set_active_route(transaction, (sound_route_e)0x7f) != SOUND_MANAGER_ERROR_INVALID_PARAMETER)
+		ret = -1;
+	if(sound_manager_transaction_set_volume(transaction, SOUND_TYPE_MEDIA, 5) != SOUND_MANAGER_ERROR_NONE
+		|| sound_manager_transaction_commit(transaction, &session) != SOUND_MANAGER_ERROR_NONE
+		|| session != NULL
+		|| __backend_volume(SOUND_TYPE_MEDIA) != 5)
+		ret = -1;
+
+	sound_manager_transaction_destroy(transaction);
+	printf("%-36s %s\n", "commit without a call session", ret ? "no" : "yes");
+	return ret;
+}
+
+static int __test_rollback(void)
+{
+	sound_transaction_h transaction = NULL;
+	sound_call_session_h session = (sound_call_session_h)1;
+	unsigned long mode_seq = stub_backend_get_request_seq(STUB_REQUEST_SUBSESSION_SET);
+	int ret = 0;
+
+	if(sound_manager_transaction_create(&transaction) != SOUND_MANAGER_ERROR_NONE)
+		return -1;
+
+	stub_backend_set_failing(STUB_REQUEST_ROUTE_SET, true);
+	if(sound_manager_transaction_set_active_route(transaction, SOUND_ROUTE_OUT_SPEAKER) != SOUND_MANAGER_ERROR_NONE
+		|| sound_manager_transaction_set_call_session(transaction, SOUND_SESSION_TYPE_VOIP, SOUND_CALL_SESSION_MODE_MEDIA) != SOUND_MANAGER_ERROR_NONE
+		|| sound_manager_transaction_commit(transaction, &session) == SOUND_MANAGER_ERROR_NONE)
+		ret = -1;
+	stub_backend_set_failing(STUB_REQUEST_ROUTE_SET, false);
+
+	/* the call session is gone and its mode was never applied */
+	if(session != NULL || stub_backend_get_session_type() != -1
+		|| stub_backend_get_request_seq(STUB_REQUEST_SUBSESSION_SET) != mode_seq)
+		ret = -1;
+	if(sound_manager_transaction_commit(transaction, &session) != SOUND_MANAGER_ERROR_INVALID_OPERATION)
+		ret = -1;
+
+	/* the slot of the call session is free again */
+	if(sound_manager_call_session_create(SOUND_SESSION_TYPE_CALL, &session) != SOUND_MANAGER_ERROR_NONE
+		|| sound_manager_call_session_destroy(session) != SOUND_MANAGER_ERROR_NONE)
+		ret = -1;
+
+	sound_manager_transaction_destroy(transaction);
+	printf("%-36s %s\n", "failed commit rolled back", ret ? "no" : "yes");
+	return ret;
+}
+
+int main(int argc, char *argv[])
+{
+	int ret = 0;
+
+	if(bench_parse_args(argc, argv, "", NULL) != 0)
+		return 1;
+
+	if(__test_commit_order() != 0)
+		ret = 1;
+	if(__test_without_session() != 0)
+		ret = 1;
+	if(__test_rollback() != 0)
+		ret = 1;
+
+	return bench_end(ret);
+}